@@ -2,14 +2,18 @@
 #include <PiDxe.h>
 
 #include <Guid/AppleHob.h>
+#include <Guid/AppleSmcVariable.h>
 
 #include <Protocol/AppleSmcIo.h>
+#include <Protocol/AppleSmcIoEx.h>
 
+#include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/HobLib.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
 
 #include "SmcIoInternal.h"
 
@@ -46,6 +50,191 @@ STATIC CONST EFI_GUID gApplePhysicalSmcHobGuid =
   { 0xD1B58E22, 0x779B, 0x46AC,
     { 0x86, 0x7B, 0xF1, 0x59, 0x8D, 0x5E, 0xA0, 0x5A } };
 
+// InternalFindKeyPresence
+/** Binary searches the key presence map of SmcDev for Key.  The map is only
+    accessed while holding the lock of SmcDev, as adding an entry may move
+    it.
+
+  @param[in]  SmcDev  The SMC device to search the map of.
+  @param[in]  Key     The key to search for.
+  @param[out] Index   The index of the entry for Key, or the index to insert
+                      it at if it is not mapped.
+
+  @returns  The entry for Key or NULL if it is not mapped.
+**/
+STATIC
+SMC_KEY_PRESENCE_MAP *
+InternalFindKeyPresence (
+  IN  SMC_DEV  *SmcDev,
+  IN  SMC_KEY  Key,
+  OUT UINTN    *Index
+  )
+{
+  SMC_KEY_PRESENCE_MAP *Entry;
+
+  UINTN                Low;
+  UINTN                High;
+  UINTN                Middle;
+
+  Low  = 0;
+  High = SmcDev->KeyPresenceMapLength;
+
+  while (Low < High) {
+    Middle = (Low + ((High - Low) / 2));
+    Entry  = &SmcDev->KeyPresenceMap[Middle];
+
+    if (Entry->Key == Key) {
+      *Index = Middle;
+
+      return Entry;
+    }
+
+    if (Entry->Key < Key) {
+      Low = (Middle + 1);
+    } else {
+      High = Middle;
+    }
+  }
+
+  *Index = Low;
+
+  return NULL;
+}
+
+// InternalGrowKeyPresenceMap
+STATIC
+EFI_STATUS
+InternalGrowKeyPresenceMap (
+  IN SMC_DEV  *SmcDev,
+  IN UINTN    MinimumLength
+  )
+{
+  SMC_KEY_PRESENCE_MAP *Buffer;
+  UINTN                Length;
+
+  if (MinimumLength <= SmcDev->MaxKeyPresenceMapLength) {
+    return EFI_SUCCESS;
+  }
+
+  Length = ALIGN_VALUE (MinimumLength, KEY_PRESENT_MAP_UNITS);
+  Buffer = ReallocatePool (
+             (SmcDev->MaxKeyPresenceMapLength * sizeof (*Buffer)),
+             (Length * sizeof (*Buffer)),
+             (VOID *)SmcDev->KeyPresenceMap
+             );
+
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  SmcDev->KeyPresenceMap          = Buffer;
+  SmcDev->MaxKeyPresenceMapLength = (UINT32)Length;
+
+  return EFI_SUCCESS;
+}
+
+// InternalAddKeyPresence
+/** Inserts Key into the key presence map of SmcDev at Index.  The caller
+    must hold the lock of SmcDev.
+**/
+STATIC
+SMC_KEY_PRESENCE_MAP *
+InternalAddKeyPresence (
+  IN SMC_DEV  *SmcDev,
+  IN UINTN    Index,
+  IN SMC_KEY  Key,
+  IN BOOLEAN  Present
+  )
+{
+  SMC_KEY_PRESENCE_MAP *Entry;
+
+  EFI_STATUS           Status;
+
+  Status = InternalGrowKeyPresenceMap (
+             SmcDev,
+             (SmcDev->KeyPresenceMapLength + 1)
+             );
+
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  Entry = &SmcDev->KeyPresenceMap[Index];
+
+  CopyMem (
+    (VOID *)(Entry + 1),
+    (VOID *)Entry,
+    ((SmcDev->KeyPresenceMapLength - Index) * sizeof (*Entry))
+    );
+
+  ++SmcDev->KeyPresenceMapLength;
+
+  Entry->Key       = Key;
+  Entry->Present   = Present;
+  Entry->InfoValid = FALSE;
+
+  return Entry;
+}
+
+// InternalCacheKeyInfo
+/** Records the information of the present Key.  The caller must hold the lock
+    of SmcDev.
+**/
+STATIC
+VOID
+InternalCacheKeyInfo (
+  IN SMC_DEV             *SmcDev,
+  IN SMC_KEY             Key,
+  IN SMC_DATA_SIZE       Size,
+  IN SMC_KEY_TYPE        Type,
+  IN SMC_KEY_ATTRIBUTES  Attributes
+  )
+{
+  SMC_KEY_PRESENCE_MAP *Entry;
+  UINTN                Index;
+
+  Entry = InternalFindKeyPresence (SmcDev, Key, &Index);
+
+  if (Entry == NULL) {
+    Entry = InternalAddKeyPresence (SmcDev, Index, Key, TRUE);
+  }
+
+  if (Entry != NULL) {
+    Entry->Present    = TRUE;
+    Entry->InfoValid  = TRUE;
+    Entry->Size       = Size;
+    Entry->Type       = Type;
+    Entry->Attributes = Attributes;
+  }
+}
+
+// InternalMapKeyPresence
+/** Records the presence of Key unless it is mapped already.  The caller must
+    not hold the lock of SmcDev.
+**/
+STATIC
+VOID
+InternalMapKeyPresence (
+  IN SMC_DEV  *SmcDev,
+  IN SMC_KEY  Key,
+  IN BOOLEAN  Present
+  )
+{
+  EFI_STATUS Status;
+
+  UINTN      Index;
+
+  Status = EfiAcquireLockOrFail (&SmcDev->Lock);
+
+  if (!EFI_ERROR (Status)) {
+    if (InternalFindKeyPresence (SmcDev, Key, &Index) == NULL) {
+      InternalAddKeyPresence (SmcDev, Index, Key, Present);
+    }
+
+    EfiReleaseLock (&SmcDev->Lock);
+  }
+}
+
 // InternalIsKeyPresent
 STATIC
 BOOLEAN
@@ -57,57 +246,147 @@ InternalIsKeyPresent (
   BOOLEAN              KeyExists;
 
   SMC_DEV              *SmcDev;
+  BOOLEAN              KeyKnown;
   UINTN                Index;
   SMC_KEY_PRESENCE_MAP *Entry;
   EFI_STATUS           Status;
   SMC_DATA_SIZE        Size;
   SMC_KEY_TYPE         Type;
   SMC_KEY_ATTRIBUTES   Attributes;
-  SMC_KEY_PRESENCE_MAP *Buffer;
 
   SmcDev = SMC_DEV_FROM_THIS (This);
 
-  Entry = &SmcDev->KeyPresenceMap[0];
+  Status = EfiAcquireLockOrFail (&SmcDev->Lock);
 
-  for (Index = 0; Index < SmcDev->KeyPresenceMapLength; ++Index) {
-    if (Entry->Key == Key) {
-      KeyExists = Entry->Present;
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
 
-      goto Done;
-    }
+  KeyKnown  = TRUE;
+  KeyExists = FALSE;
+  Entry     = InternalFindKeyPresence (SmcDev, Key, &Index);
+
+  if (Entry != NULL) {
+    KeyExists = Entry->Present;
+  } else if (!SmcDev->KeyPresenceComplete) {
+    //
+    // Unless the whole key directory has been mapped, keys not found must be
+    // queried.
+    //
+    KeyKnown = FALSE;
+  }
 
-    ++Entry;
+  EfiReleaseLock (&SmcDev->Lock);
+
+  if (!KeyKnown) {
+    //
+    // The information of present keys is cached by the query.
+    //
+    Status    = InternalSmcGetKeyInfo (This, Key, &Size, &Type, &Attributes);
+    KeyExists = (BOOLEAN)!EFI_ERROR (Status);
+
+    //
+    // A busy lock does not tell whether the key exists.
+    //
+    if (!KeyExists && (Status != EFI_ACCESS_DENIED)) {
+      InternalMapKeyPresence (SmcDev, Key, FALSE);
+    }
   }
 
-  Status    = InternalSmcGetKeyInfo (This, Key, &Size, &Type, &Attributes);
-  KeyExists = (BOOLEAN)!EFI_ERROR (Status);
+  return KeyExists;
+}
+
+// InternalSmcReadValueLocked
+/** Reads the value of a present key from the hardware SMC.  The caller must
+    hold the lock of SmcDev.
+**/
+STATIC
+EFI_STATUS
+InternalSmcReadValueLocked (
+  IN  SMC_DEV        *SmcDev,
+  IN  SMC_KEY        Key,
+  IN  SMC_DATA_SIZE  Size,
+  OUT SMC_DATA       *Value
+  )
+{
+  EFI_STATUS Status;
+
+  SMC_RESULT Result;
+  SMC_DATA   *ValueWalker;
+
+  if (SmcDev->SmcIo.Mmio) {
+    Status = SmcReadValueMmio (mSmcMmioAddress, Key, &Size, Value);
+  } else {
+    Status = SmcIoSmcSmcInABadState (SmcDev);
 
-  if (SmcDev->KeyPresenceMapLength >= SmcDev->MaxKeyPresenceMapLength) {
-    Buffer = AllocateCopyPool (
-               (SmcDev->MaxKeyPresenceMapLength + KEY_PRESENT_MAP_UNITS)
-                  * sizeof (SmcDev->KeyPresenceMap),
-               (CONST VOID *)SmcDev->KeyPresenceMap
-               );
+    if (!EFI_ERROR (Status)) {
+      Status = SmcIoSmcWriteCommand (SmcDev, SmcCmdReadValue);
 
-    if (Buffer == NULL) {
-      goto Done;
+      if (!EFI_ERROR (Status)) {
+        Status = SmcIoSmcWriteData32 (SmcDev, (UINT32)Key);
+
+        if (!EFI_ERROR (Status)) {
+          Status = SmcIoSmcWriteData8 (SmcDev, (SMC_DATA)Size);
+
+          if (!EFI_ERROR (Status)) {
+            ValueWalker = Value;
+
+            do {
+              Status = SmcIoSmcReadData8 (SmcDev, ValueWalker);
+              ++ValueWalker;
+
+              if (EFI_ERROR (Status)) {
+                break;
+              }
+
+              --Size;
+            } while (Size > 0);
+
+            if (Size == 0) {
+              Status = SmcIoSmcTimeoutWaitingForBusyClear (SmcDev);
+            }
+          }
+        }
+      }
     }
 
-    FreePool ((VOID *)SmcDev->KeyPresenceMap);
+    Result = SmcIoSmcReadResult (SmcDev);
 
-    SmcDev->KeyPresenceMap           = Buffer;
-    SmcDev->MaxKeyPresenceMapLength += KEY_PRESENT_MAP_UNITS;
+    if (Status == EFI_TIMEOUT) {
+      Status = EFI_SMC_TIMEOUT_ERROR;
+    } else if (Result == SmcSuccess) {
+      Status = EFI_SUCCESS;
 
-    Entry = &SmcDev->KeyPresenceMap[SmcDev->KeyPresenceMapLength];
+      if ((Key == SMC_MAKE_KEY ('R', 'P', 'l', 't'))
+       && (*(UINT64 *)Value == SMC_MAKE_KEY ('5', '0', '5', 'j'))) {
+        ((CHAR8 *)Value)[2] = '\0';
+      }
+    } else {
+      Status = EFIERR (Result);
+    }
   }
 
-  ++SmcDev->KeyPresenceMapLength;
+  return Status;
+}
 
-  Entry->Key     = Key;
-  Entry->Present = KeyExists;
+// InternalCacheValue
+STATIC
+VOID
+InternalCacheValue (
+  IN SMC_DEV         *SmcDev,
+  IN SMC_KEY         Key,
+  IN SMC_DATA_SIZE   Size,
+  IN CONST SMC_DATA  *Value
+  )
+{
+  SMC_KEY_PRESENCE_MAP *Entry;
+  UINTN                Index;
 
-Done:
-  return KeyExists;
+  Entry = InternalFindKeyPresence (SmcDev, Key, &Index);
+
+  if ((Entry != NULL) && Entry->InfoValid) {
+    SmcIoStoreValue (SmcDev, Key, Entry->Attributes, Size, Value);
+  }
 }
 
 // InternalSmcReadValue
@@ -125,8 +404,6 @@ InternalSmcReadValue (
 
   BOOLEAN    KeyPresent;
   SMC_DEV    *SmcDev;
-  SMC_RESULT Result;
-  SMC_DATA   *ValueWalker;
 
   Status = EFI_INVALID_PARAMETER;
 
@@ -142,58 +419,15 @@ InternalSmcReadValue (
 
       if (KeyPresent) {
         SmcDev = SMC_DEV_FROM_THIS (This);
+
         Status = EfiAcquireLockOrFail (&SmcDev->Lock);
 
         if (!EFI_ERROR (Status)) {
-          if (This->Mmio) {
-            Status = SmcReadValueMmio (mSmcMmioAddress, Key, &Size, Value);
-          } else {
-            Status = SmcIoSmcSmcInABadState (SmcDev);
+          if (!SmcIoLookupValue (SmcDev, Key, Size, Value)) {
+            Status = InternalSmcReadValueLocked (SmcDev, Key, Size, Value);
 
             if (!EFI_ERROR (Status)) {
-              Status = SmcIoSmcWriteCommand (SmcDev, SmcCmdReadValue);
-
-              if (!EFI_ERROR (Status)) {
-                Status = SmcIoSmcWriteData32 (SmcDev, (UINT32)Key);
-
-                if (!EFI_ERROR (Status)) {
-                  Status = SmcIoSmcWriteData8 (SmcDev, (SMC_DATA)Size);
-
-                  if (!EFI_ERROR (Status)) {
-                    ValueWalker = Value;
-
-                    do {
-                      Status = SmcIoSmcReadData8 (SmcDev, ValueWalker);
-                      ++ValueWalker;
-
-                      if (EFI_ERROR (Status)) {
-                        break;
-                      }
-
-                      --Size;
-                    } while (Size > 0);
-
-                    if (Size == 0) {
-                      Status = SmcIoSmcTimeoutWaitingForBusyClear (SmcDev);
-                    }
-                  }
-                }
-              }
-            }
-
-            Result = SmcIoSmcReadResult (SmcDev);
-
-            if (Status == EFI_TIMEOUT) {
-              Status = EFI_SMC_TIMEOUT_ERROR;
-            } else if (Result == SmcSuccess) {
-              Status = EFI_SUCCESS;
-
-              if ((Key == SMC_MAKE_KEY ('R', 'P', 'l', 't'))
-               && (*(UINT64 *)Value == SMC_MAKE_KEY ('5', '0', '5', 'j'))) {
-                ((CHAR8 *)Value)[2] = '\0';
-              }
-            } else {
-              Status = EFIERR (Result);
+              InternalCacheValue (SmcDev, Key, Size, Value);
             }
           }
 
@@ -240,6 +474,8 @@ InternalSmcWriteValue (
         Status = EfiAcquireLockOrFail (&SmcDev->Lock);
 
         if (!EFI_ERROR (Status)) {
+          SmcIoFlushValueCache (SmcDev);
+
           if (This->Mmio) {
             Status = SmcWriteValueMmio (
                        mSmcMmioAddress,
@@ -355,12 +591,19 @@ InternalSmcGetKeyCount (
     Status = InternalSmcMakeKey (NUMBER_OF_KEYS_KEY, &Key);
 
     if (!EFI_ERROR (Status)) {
-      Status = SmcIoVirtualSmcReadValue (
+      Status = InternalSmcReadValue (
                  This,
                  Key,
                  sizeof (*Count),
                  (VOID *)Count
                  );
+
+      if (!EFI_ERROR (Status)) {
+        //
+        // The SMC returns the key count big-endian.
+        //
+        *Count = SwapBytes32 (*Count);
+      }
     }
   }
 
@@ -442,10 +685,12 @@ InternalSmcGetKeyInfo (
   OUT SMC_KEY_ATTRIBUTES     *Attributes
   )
 {
-  EFI_STATUS Status;
+  EFI_STATUS           Status;
 
-  SMC_DEV    *SmcDev;
-  SMC_RESULT Result;
+  SMC_DEV              *SmcDev;
+  SMC_RESULT           Result;
+  SMC_KEY_PRESENCE_MAP *Entry;
+  UINTN                Index;
 
   if (mSoftwareSmc) {
     Status = SmcIoVirtualSmcGetKeyInfo (This, Key, Size, Type, Attributes);
@@ -460,7 +705,13 @@ InternalSmcGetKeyInfo (
       Status = EfiAcquireLockOrFail (&SmcDev->Lock);
 
       if (!EFI_ERROR (Status)) {
-        if (This->Mmio) {
+        Entry = InternalFindKeyPresence (SmcDev, Key, &Index);
+
+        if ((Entry != NULL) && Entry->InfoValid) {
+          *Size       = Entry->Size;
+          *Type       = Entry->Type;
+          *Attributes = Entry->Attributes;
+        } else if (This->Mmio) {
           Status = SmcGetKeyInfoMmio (
                      mSmcMmioAddress,
                      Key,
@@ -501,6 +752,10 @@ InternalSmcGetKeyInfo (
                      : EFI_STATUS_FROM_SMC_RESULT (Result));
         }
 
+        if (!EFI_ERROR (Status)) {
+          InternalCacheKeyInfo (SmcDev, Key, *Size, *Type, *Attributes);
+        }
+
         EfiReleaseLock (&SmcDev->Lock);
       }
     }
@@ -509,6 +764,246 @@ InternalSmcGetKeyInfo (
   return Status;
 }
 
+// InternalSmcPreloadKeys
+/** Maps the presence and information of all keys in the key directory of
+    the SMC, so that key lookups do not need to query the SMC anymore.  Keys
+    which could not be enumerated are queried on demand as before.
+
+  The directory is indexed from 0.  SmcGetKeyFromIndexMmio() rejects index
+  0, hence on MMIO the first key cannot be enumerated and the map is never
+  considered complete.
+
+  @param[in] SmcDev  The SMC device to enumerate the keys of.
+**/
+STATIC
+VOID
+InternalSmcPreloadKeys (
+  IN SMC_DEV  *SmcDev
+  )
+{
+  EFI_STATUS         Status;
+
+  UINT32             NumberOfKeys;
+  UINT32             NumberOfFailures;
+  UINT32             FirstKeyIndex;
+  UINT32             KeyIndex;
+  SMC_KEY            Key;
+  SMC_DATA_SIZE      Size;
+  SMC_KEY_TYPE       Type;
+  SMC_KEY_ATTRIBUTES Attributes;
+
+  Status = InternalSmcGetKeyCount (&SmcDev->SmcIo, &NumberOfKeys);
+
+  if (!EFI_ERROR (Status) && (NumberOfKeys > 0)) {
+    Status = EfiAcquireLockOrFail (&SmcDev->Lock);
+
+    if (!EFI_ERROR (Status)) {
+      Status = InternalGrowKeyPresenceMap (
+                 SmcDev,
+                 (SmcDev->KeyPresenceMapLength + NumberOfKeys)
+                 );
+
+      EfiReleaseLock (&SmcDev->Lock);
+    }
+
+    if (!EFI_ERROR (Status)) {
+      FirstKeyIndex    = (SmcDev->SmcIo.Mmio ? 1 : 0);
+      NumberOfFailures = FirstKeyIndex;
+
+      for (KeyIndex = FirstKeyIndex; KeyIndex < NumberOfKeys; ++KeyIndex) {
+        Status = InternalSmcGetKeyFromIndex (&SmcDev->SmcIo, KeyIndex, &Key);
+
+        if (EFI_ERROR (Status)) {
+          ++NumberOfFailures;
+          continue;
+        }
+
+        //
+        // The directory is sorted, hence the key is usually appended.  The
+        // query caches the key information along with the presence.
+        //
+        Status = InternalSmcGetKeyInfo (
+                   &SmcDev->SmcIo,
+                   Key,
+                   &Size,
+                   &Type,
+                   &Attributes
+                   );
+
+        if (EFI_ERROR (Status)) {
+          InternalMapKeyPresence (SmcDev, Key, TRUE);
+        }
+      }
+
+      SmcDev->KeyPresenceComplete = (BOOLEAN)(NumberOfFailures == 0);
+
+      DEBUG ((
+        EFI_D_INFO,
+        "AppleSmc: Preloaded %d of %d keys\n",
+        (NumberOfKeys - NumberOfFailures),
+        NumberOfKeys
+        ));
+    }
+  }
+}
+
+// InternalSmcReadValues
+STATIC
+EFI_STATUS
+EFIAPI
+InternalSmcReadValues (
+  IN     APPLE_SMC_IO_EX_PROTOCOL  *This,
+  IN     UINTN                     NumberOfRequests,
+  IN OUT APPLE_SMC_READ_REQUEST    *Requests
+  )
+{
+  EFI_STATUS             Status;
+
+  SMC_DEV                *SmcDev;
+  APPLE_SMC_READ_REQUEST *Request;
+  UINTN                  Index;
+  UINTN                  NumberOfPending;
+  BOOLEAN                KeyPresent;
+  SMC_DATA_SIZE          KeySize;
+  SMC_KEY_TYPE           Type;
+  SMC_KEY_ATTRIBUTES     Attributes;
+
+  if ((Requests == NULL) || (NumberOfRequests == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  SmcDev          = SMC_DEV_FROM_SMC_IO_EX (This);
+  NumberOfPending = 0;
+
+  //
+  // Resolve the keys before locking the SMC, as this may query it.
+  //
+  for (Index = 0; Index < NumberOfRequests; ++Index) {
+    Request = &Requests[Index];
+
+    if (Request->Value == NULL) {
+      Request->Status = EFI_INVALID_PARAMETER;
+      continue;
+    }
+
+    if (mSoftwareSmc) {
+      if (Request->Size == 0) {
+        Request->Size = SMC_MAX_DATA_SIZE;
+      }
+
+      Request->Status = SmcIoVirtualSmcReadValue (
+                          &SmcDev->SmcIo,
+                          Request->Key,
+                          Request->Size,
+                          Request->Value
+                          );
+      continue;
+    }
+
+    Request->Status = EFI_INVALID_PARAMETER;
+
+    if (Request->Size > SMC_MAX_DATA_SIZE) {
+      continue;
+    }
+
+    KeyPresent = InternalIsKeyPresent (&SmcDev->SmcIo, Request->Key);
+
+    Request->Status = EFI_NOT_FOUND;
+
+    if (!KeyPresent) {
+      continue;
+    }
+
+    //
+    // The information of present keys is usually cached.  MMIO reads always
+    // return the whole value, hence smaller buffers are rejected.
+    //
+    Request->Status = InternalSmcGetKeyInfo (
+                        &SmcDev->SmcIo,
+                        Request->Key,
+                        &KeySize,
+                        &Type,
+                        &Attributes
+                        );
+
+    if (EFI_ERROR (Request->Status)) {
+      continue;
+    }
+
+    if (Request->Size == 0) {
+      Request->Size = KeySize;
+    } else if (Request->Size < KeySize) {
+      Request->Status = EFI_BUFFER_TOO_SMALL;
+      continue;
+    }
+
+    Request->Status = EFI_NOT_READY;
+
+    ++NumberOfPending;
+  }
+
+  Status = EFI_SUCCESS;
+
+  if (NumberOfPending > 0) {
+    Status = EfiAcquireLockOrFail (&SmcDev->Lock);
+
+    for (Index = 0; Index < NumberOfRequests; ++Index) {
+      Request = &Requests[Index];
+
+      if (Request->Status != EFI_NOT_READY) {
+        continue;
+      }
+
+      if (EFI_ERROR (Status)) {
+        Request->Status = Status;
+        continue;
+      }
+
+      //
+      // The cache is only accessed with the SMC locked, see SmcIoInternal.h.
+      //
+      Request->Status = EFI_SUCCESS;
+
+      if (!SmcIoLookupValue (
+             SmcDev,
+             Request->Key,
+             Request->Size,
+             Request->Value
+             )) {
+        Request->Status = InternalSmcReadValueLocked (
+                            SmcDev,
+                            Request->Key,
+                            Request->Size,
+                            Request->Value
+                            );
+
+        if (!EFI_ERROR (Request->Status)) {
+          InternalCacheValue (
+            SmcDev,
+            Request->Key,
+            Request->Size,
+            Request->Value
+            );
+        }
+      }
+    }
+
+    if (!EFI_ERROR (Status)) {
+      EfiReleaseLock (&SmcDev->Lock);
+    }
+  }
+
+  if (!EFI_ERROR (Status)) {
+    for (Index = 0; Index < NumberOfRequests; ++Index) {
+      if (EFI_ERROR (Requests[Index].Status)) {
+        Status = EFI_NOT_READY;
+      }
+    }
+  }
+
+  return Status;
+}
+
 // InternalSmcReset
 STATIC
 EFI_STATUS
@@ -534,6 +1029,8 @@ InternalSmcReset (
     Status = EfiAcquireLockOrFail (&SmcDev->Lock);
 
     if (!EFI_ERROR (Status)) {
+      SmcIoFlushValueCache (SmcDev);
+
       if (This->Mmio) {
         Status = SmcResetMmio (mSmcMmioAddress, Mode);
 
@@ -594,6 +1091,8 @@ InternalSmcFlashType (
     Status = EfiAcquireLockOrFail (&SmcDev->Lock);
 
     if (!EFI_ERROR (Status)) {
+      SmcIoFlushValueCache (SmcDev);
+
       if (This->Mmio) {
         Status = SmcFlashTypeMmio (mSmcMmioAddress, Type);
       } else {
@@ -654,6 +1153,8 @@ InternalSmcFlashWrite (
       Status = EfiAcquireLockOrFail (&SmcDev->Lock);
 
       if (!EFI_ERROR (Status)) {
+        SmcIoFlushValueCache (SmcDev);
+
         if (This->Mmio) {
           Status = SmcFlashWriteMmio (
                      mSmcMmioAddress,
@@ -736,6 +1237,8 @@ InternalSmcFlashAuth (
       Status = EfiAcquireLockOrFail (&SmcDev->Lock);
 
       if (!EFI_ERROR (Status)) {
+        SmcIoFlushValueCache (SmcDev);
+
         if (This->Mmio) {
           Status = SmcFlashAuthMmio (mSmcMmioAddress, Size, Data);
         } else {
@@ -936,6 +1439,11 @@ AppleSmcMain (
     InternalSmcUnknown5
   };
 
+  STATIC APPLE_SMC_IO_EX_PROTOCOL AppleSmcIoExProtocolTemplate = {
+    APPLE_SMC_IO_EX_PROTOCOL_REVISION,
+    InternalSmcReadValues
+  };
+
   EFI_STATUS       Status;
 
   SMC_DEV          *SmcDev;
@@ -946,6 +1454,8 @@ AppleSmcMain (
   VOID             *SmcHob;
   UINT16           Value;
   SMC_DEV          *SmcDevChild;
+  UINT8            KeyPreload;
+  UINTN            DataSize;
 
   SmcDev = AllocateZeroPool (sizeof (*SmcDev));
 
@@ -969,14 +1479,25 @@ AppleSmcMain (
         sizeof (AppleSmcIoProtocolTemplate)
         );
 
-      Status = gBS->InstallProtocolInterface (
+      CopyMem (
+        (VOID *)&SmcDev->SmcIoEx,
+        (VOID *)&AppleSmcIoExProtocolTemplate,
+        sizeof (AppleSmcIoExProtocolTemplate)
+        );
+
+      Status = gBS->InstallMultipleProtocolInterfaces (
                       &SmcDev->Handle,
                       &gAppleSmcIoProtocolGuid,
-                      EFI_NATIVE_INTERFACE,
-                      (VOID *)&SmcDev->SmcIo
+                      (VOID *)&SmcDev->SmcIo,
+                      &gAppleSmcIoExProtocolGuid,
+                      (VOID *)&SmcDev->SmcIoEx,
+                      NULL
                       );
 
       if (!EFI_ERROR (Status)) {
+        SmcIoCreateStatistics ();
+        SmcIoLoadValueCacheTtls ();
+
         SmcAddress = SMC_MMIO_BASE_ADDRESS;
 
         SmcHob = GetFirstGuidHob (&gAppleSmcMmioAddressHobGuid);
@@ -1007,6 +1528,21 @@ AppleSmcMain (
           }
         }
 
+        KeyPreload = 0;
+        DataSize   = sizeof (KeyPreload);
+
+        Status = gRT->GetVariable (
+                        APPLE_SMC_KEY_PRELOAD_VARIABLE_NAME,
+                        &gAppleSmcVariableGuid,
+                        NULL,
+                        &DataSize,
+                        (VOID *)&KeyPreload
+                        );
+
+        if (!EFI_ERROR (Status) && (KeyPreload != 0)) {
+          InternalSmcPreloadKeys (SmcDev);
+        }
+
         NumberOfSmcDevices = 1;
 
         InternalSmcReadValue (
@@ -1066,11 +1602,19 @@ AppleSmcMain (
                   SmcDevChild->SmcIo.Index   = Index;
                   SmcDevChild->SmcIo.Address = NEXT_SMC_ADDRESS (SmcAddress);
 
-                  Status = gBS->InstallProtocolInterface (
+                  CopyMem (
+                    (VOID *)&SmcDevChild->SmcIoEx,
+                    (VOID *)&AppleSmcIoExProtocolTemplate,
+                    sizeof (AppleSmcIoExProtocolTemplate)
+                    );
+
+                  Status = gBS->InstallMultipleProtocolInterfaces (
                                   &SmcDevChild->Handle,
                                   &gAppleSmcIoProtocolGuid,
-                                  EFI_NATIVE_INTERFACE,
-                                  (VOID *)&SmcDevChild->SmcIo
+                                  (VOID *)&SmcDevChild->SmcIo,
+                                  &gAppleSmcIoExProtocolGuid,
+                                  (VOID *)&SmcDevChild->SmcIoEx,
+                                  NULL
                                   );
 
                   if (!EFI_ERROR (Status)) {
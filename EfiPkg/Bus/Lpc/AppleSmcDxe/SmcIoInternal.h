@@ -1,6 +1,10 @@
 #ifndef SMC_IO_INTERNAL_H_
 #define SMC_IO_INTERNAL_H_
 
+#include <Guid/AppleSmcStatistics.h>
+
+#include <Protocol/AppleSmcIoEx.h>
+
 #include <Library/UefiLib.h>
 
 // SMC_DEV_SIGNATURE
@@ -10,21 +14,59 @@
 // SMC_DEV_FROM_THIS
 #define SMC_DEV_FROM_THIS(x) CR ((x), SMC_DEV, SmcIo, SMC_DEV_SIGNATURE)
 
+// SMC_DEV_FROM_SMC_IO_EX
+#define SMC_DEV_FROM_SMC_IO_EX(x)  \
+  CR ((x), SMC_DEV, SmcIoEx, SMC_DEV_SIGNATURE)
+
 // SMC_KEY_PRESENCE_MAP
+/// The key presence map is kept sorted by key for binary search.  The key
+/// information is cached for present keys once it has been queried, as it
+/// does not change while the firmware is running.
 typedef struct {
-  SMC_KEY Key;
-  BOOLEAN Present;
+  SMC_KEY            Key;
+  BOOLEAN            Present;
+  BOOLEAN            InfoValid;
+  SMC_DATA_SIZE      Size;
+  SMC_KEY_ATTRIBUTES Attributes;
+  SMC_KEY_TYPE       Type;
 } SMC_KEY_PRESENCE_MAP;
 
+// SMC_VALUE_CACHE_SIZE
+#define SMC_VALUE_CACHE_SIZE  32
+
+// SMC_VALUE_CACHE_ENTRY
+/// A value read from a read-only key.  Unused entries have a Size of 0.
+typedef struct {
+  SMC_KEY       Key;
+  SMC_DATA_SIZE Size;
+  UINT64        Expiry;                    ///< In nanoseconds.
+  SMC_DATA      Value[SMC_MAX_DATA_SIZE];
+} SMC_VALUE_CACHE_ENTRY;
+
+// SMC_PMIO_TRANSACTION
+/// The port I/O transaction in progress, accounted once its result is read.
+typedef struct {
+  APPLE_SMC_WAIT Wait;        ///< The command issued, if any yet.
+  UINTN          Bytes;       ///< The data bytes moved.
+  UINTN          Iterations;  ///< The status reads issued.
+  UINT64         WaitTime;    ///< The time spent waiting in nanoseconds.
+} SMC_PMIO_TRANSACTION;
+
 // SMC_DEV
 typedef struct SMC_DEV {
-  UINT64                Signature;                ///<
-  EFI_HANDLE            Handle;                   ///<
-  EFI_LOCK              Lock;                     ///<
-  APPLE_SMC_IO_PROTOCOL SmcIo;                    ///<
-  UINT32                KeyPresenceMapLength;     ///<
-  UINT32                MaxKeyPresenceMapLength;  ///<
-  SMC_KEY_PRESENCE_MAP  *KeyPresenceMap;          ///<
+  UINT64                   Signature;                         ///<
+  EFI_HANDLE               Handle;                            ///<
+  EFI_LOCK                 Lock;                              ///<
+  APPLE_SMC_IO_PROTOCOL    SmcIo;                             ///<
+  APPLE_SMC_IO_EX_PROTOCOL SmcIoEx;                           ///<
+  UINT32                   KeyPresenceMapLength;              ///<
+  UINT32                   MaxKeyPresenceMapLength;           ///<
+  SMC_KEY_PRESENCE_MAP     *KeyPresenceMap;                   ///<
+  BOOLEAN                  KeyPresenceComplete;               ///< All keys are mapped.
+  UINTN                    PmioStall;                         ///< The first stall in us.
+  SMC_PMIO_TRANSACTION     PmioTransaction;                   ///<
+  UINTN                    NextValueCacheEntry;               ///<
+  SMC_VALUE_CACHE_ENTRY    ValueCache[SMC_VALUE_CACHE_SIZE];  ///<
 } SMC_DEV;
 
 // SmcIoSmcReadStatus
@@ -106,6 +148,129 @@ SmcIoSmcSmcInABadState (
   IN SMC_DEV  *SmcDev
   );
 
+// Statistics
+
+// SmcIoCreateStatistics
+/** Publishes the SMC statistics as a configuration table.  Until this has
+    succeeded, nothing is recorded.
+**/
+EFI_STATUS
+SmcIoCreateStatistics (
+  VOID
+  );
+
+// SmcIoStatisticsRecordWait
+/** Accounts a status wait to the command it has been issued for.
+
+  @param[in] Wait      The command the wait is accounted to.
+  @param[in] Time      The time spent waiting in nanoseconds.
+  @param[in] Polls     The number of status reads issued.
+  @param[in] Delays    The time slept in between the reads in microseconds.
+  @param[in] TimedOut  Whether the wait has timed out.
+**/
+VOID
+SmcIoStatisticsRecordWait (
+  IN APPLE_SMC_WAIT  Wait,
+  IN UINT64          Time,
+  IN UINTN           Polls,
+  IN UINTN           Delays,
+  IN BOOLEAN         TimedOut
+  );
+
+// SmcIoStatisticsRecordTransaction
+/** Accounts a completed port I/O transaction to its command.
+
+  @param[in] Transaction  The transaction to account.
+**/
+VOID
+SmcIoStatisticsRecordTransaction (
+  IN CONST SMC_PMIO_TRANSACTION  *Transaction
+  );
+
+// SmcIoStatisticsCountValueCache
+VOID
+SmcIoStatisticsCountValueCache (
+  IN BOOLEAN  Hit
+  );
+
+// SmcIoStatisticsCountValueCacheFlush
+VOID
+SmcIoStatisticsCountValueCacheFlush (
+  VOID
+  );
+
+// SmcIoWaitFromCommand
+/** Returns the statistics slot a command is accounted to.
+
+  @param[in] Command  The SMC command written.
+**/
+APPLE_SMC_WAIT
+SmcIoWaitFromCommand (
+  IN UINT32  Command
+  );
+
+// Value Cache
+//
+// The value cache of a device may only be accessed while holding its lock,
+// so that a write, reset or flash operation cannot flush it between the read
+// of a value and its store, or while a lookup copies an entry.
+
+// SmcIoLoadValueCacheTtls
+/** Loads the time values are cached for from the
+    APPLE_SMC_VALUE_CACHE_TTL_VARIABLE_NAME variable, if present.
+**/
+VOID
+SmcIoLoadValueCacheTtls (
+  VOID
+  );
+
+// SmcIoLookupValue
+/** Returns a value read before if it has not expired yet.
+
+  @param[in]  SmcDev  The SMC device the value has been read from.
+  @param[in]  Key     The key to look up.
+  @param[in]  Size    The size of the value requested.
+  @param[out] Value   On output, the cached value.
+
+  @retval TRUE   Value has been returned from the cache.
+  @retval FALSE  The SMC needs to be read.
+**/
+BOOLEAN
+SmcIoLookupValue (
+  IN  SMC_DEV        *SmcDev,
+  IN  SMC_KEY        Key,
+  IN  SMC_DATA_SIZE  Size,
+  OUT SMC_DATA       *Value
+  );
+
+// SmcIoStoreValue
+/** Caches a value read if its key is read-only.  The time the value is
+    kept depends on the key, see InternalGetValueTtl().
+
+  @param[in] SmcDev      The SMC device the value has been read from.
+  @param[in] Key         The key read.
+  @param[in] Attributes  The attributes of Key.
+  @param[in] Size        The size of Value.
+  @param[in] Value       The value read.
+**/
+VOID
+SmcIoStoreValue (
+  IN SMC_DEV             *SmcDev,
+  IN SMC_KEY             Key,
+  IN SMC_KEY_ATTRIBUTES  Attributes,
+  IN SMC_DATA_SIZE       Size,
+  IN CONST SMC_DATA      *Value
+  );
+
+// SmcIoFlushValueCache
+/** Drops all cached values.  Writes may change the value of any key, for
+    example selecting another SMC through "NUM " changes "ADR ".
+**/
+VOID
+SmcIoFlushValueCache (
+  IN SMC_DEV  *SmcDev
+  );
+
 // SMC MMIO
 
 // SmcReadValueMmio
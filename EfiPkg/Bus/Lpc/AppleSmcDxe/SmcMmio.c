@@ -2,10 +2,34 @@
 
 #include <IndustryStandard/AppleSmc.h>
 
+#include <Protocol/AppleSmcIo.h>
+
 #include <Library/BaseLib.h>
 #include <Library/IoLib.h>
 #include <Library/TimerLib.h>
 
+#include "SmcIoInternal.h"
+
+// SMC_MMIO_POLL_INTERVAL
+/// The interval in microseconds the iteration limits of the status waits
+/// have originally been polled in.  The limits are converted to the time
+/// budget of a wait with it.
+#define SMC_MMIO_POLL_INTERVAL  100
+
+// SMC_MMIO_POLL_SPINS
+/// The number of status reads issued back-to-back before delaying.  Most
+/// commands complete within these few microseconds.
+#define SMC_MMIO_POLL_SPINS  16
+
+// SMC_MMIO_POLL_CEILING
+/// The longest delay in microseconds between two status reads once the
+/// delay has been backed off.
+#define SMC_MMIO_POLL_CEILING  SMC_MMIO_POLL_INTERVAL
+
+// mSmcMmioCommand
+/// The command last written, which the key done waits are accounted to.
+STATIC UINT32 mSmcMmioCommand = 0;
+
 // SmcReadKeyStatusMmio 
 SMC_STATUS
 SmcReadKeyStatusMmio (
@@ -31,6 +55,8 @@ SmcWriteCommandMmio (
   IN UINT32  Command
   )
 {
+  mSmcMmioCommand = Command;
+
   return MmioWrite8 ((BaseAddress + SMC_MMIO_WRITE_COMMAND), (UINT8)Command);
 }
 
@@ -97,25 +123,10 @@ SmcWriteData32Mmio (
   IN UINT32       Data
   )
 {
-  SmcWriteData8Mmio (
-    (UINTN)(Address + SMC_MMIO_DATA_FIXED),
-    (SMC_DATA)(Data >> 24)
-    );
-
-  SmcWriteData8Mmio (
-    (UINTN)(Address + SMC_MMIO_DATA_FIXED + (1 * sizeof (SMC_DATA))),
-    (SMC_DATA)(Data >> 16)
-    );
-
-  SmcWriteData8Mmio (
-    (UINTN)(Address + SMC_MMIO_DATA_FIXED + (2 * sizeof (SMC_DATA))),
-    (SMC_DATA)(Data >> 8)
-    );
-
-  SmcWriteData8Mmio (
-    (UINTN)(Address + SMC_MMIO_DATA_FIXED + (3 * sizeof (SMC_DATA))),
-    (SMC_DATA)Data
-    );
+  //
+  // The SMC expects the most significant byte first.
+  //
+  MmioWrite32 ((UINTN)(Address + SMC_MMIO_DATA_FIXED), SwapBytes32 (Data));
 
   return EFI_SUCCESS;
 }
@@ -126,97 +137,190 @@ SmcReadData32Mmio (
   IN UINTN  Address
   )
 {
-  UINT32 Data;
+  return SwapBytes32 (MmioRead32 (Address + SMC_MMIO_DATA_VARIABLE));
+}
 
-  Data  = (MmioRead8 (Address + SMC_MMIO_DATA_VARIABLE) << 24);
+// InternalSmcReadDataMmio
+/** Reads the variable data of a command in 32-bit accesses, and the bytes
+    not filling one in 8-bit accesses.  The data is a byte stream, hence the
+    32-bit values are stored in their little-endian memory order.
+**/
+STATIC
+VOID
+InternalSmcReadDataMmio (
+  IN  SMC_ADDRESS  BaseAddress,
+  IN  UINTN        Size,
+  OUT SMC_DATA     *Data
+  )
+{
+  UINTN Address;
+  UINTN Index;
 
-  Data |= (MmioRead8 (
-             Address + SMC_MMIO_DATA_VARIABLE + (1 * sizeof (UINT8))
-             ) << 16);
+  Address = (UINTN)(BaseAddress + SMC_MMIO_DATA_VARIABLE);
+  Index   = 0;
 
-  Data |= (MmioRead8 (
-             Address + SMC_MMIO_DATA_VARIABLE + (2 * sizeof (UINT8))
-             ) << 8);
+  while ((Index + sizeof (UINT32)) <= Size) {
+    WriteUnaligned32 (
+      (UINT32 *)(VOID *)&Data[Index],
+      MmioRead32 (Address + Index)
+      );
+
+    Index += sizeof (UINT32);
+  }
 
-  Data |= (MmioRead8 (
-             Address + SMC_MMIO_DATA_VARIABLE + (3 * sizeof (UINT8))
-             ));
+  while (Index < Size) {
+    Data[Index] = SmcReadData8Mmio (Address + Index);
 
-  return Data;
+    ++Index;
+  }
 }
 
-// TimeoutWaitingForStatusFlagClearMmio
-EFI_STATUS
-TimeoutWaitingForStatusFlagClearMmio (
-  IN SMC_ADDRESS  BaseAddress,
-  IN UINT32       Flag,
-  IN UINTN        Iterations
+// InternalSmcWriteDataMmio
+/** Writes the variable data of a command, see InternalSmcReadDataMmio().
+**/
+STATIC
+VOID
+InternalSmcWriteDataMmio (
+  IN SMC_ADDRESS     BaseAddress,
+  IN UINTN           Size,
+  IN CONST SMC_DATA  *Data
   )
 {
-  EFI_STATUS Status;
-
-  SMC_STATUS SmcStatus;
-
-  SmcStatus = SmcReadKeyStatusMmio ((UINTN)BaseAddress);
+  UINTN Address;
+  UINTN Index;
 
-  while (TRUE) {
-    Status = EFI_SUCCESS;
-
-    if ((Flag & SmcStatus) == 0) {
-      break;
-    }
+  Address = (UINTN)(BaseAddress + SMC_MMIO_DATA_VARIABLE);
+  Index   = 0;
 
-    Status = EFI_TIMEOUT;
-    --Iterations;
+  while ((Index + sizeof (UINT32)) <= Size) {
+    MmioWrite32 (
+      (Address + Index),
+      ReadUnaligned32 ((CONST UINT32 *)(CONST VOID *)&Data[Index])
+      );
 
-    if (Iterations <= 0) {
-      break;
-    }
+    Index += sizeof (UINT32);
+  }
 
-    MicroSecondDelay (100);
+  while (Index < Size) {
+    SmcWriteData8Mmio ((Address + Index), Data[Index]);
 
-    SmcStatus = SmcReadKeyStatusMmio ((UINTN)BaseAddress);
+    ++Index;
   }
-
-  return Status;
 }
 
-// TimeoutWaitingForStatusFlagSetMmio
+// InternalWaitForStatusMmio
+/** Polls the key status until Flag is set or cleared.
+
+  The status is read back-to-back SMC_MMIO_POLL_SPINS times first.  Then the
+  delay in between the reads starts at 1 us and is doubled on every read up
+  to SMC_MMIO_POLL_CEILING, so that fast commands are not penalized by the
+  ceiling and slow commands do not flood the bus.  The wait times out once
+  the delays add up to Iterations polling intervals.
+
+  @param[in] BaseAddress  The MMIO base address of the SMC.
+  @param[in] Flag         The status flags to wait for.
+  @param[in] Set          Whether to wait for any flag to be set or for all
+                          flags to be cleared.
+  @param[in] Iterations   The time budget in SMC_MMIO_POLL_INTERVAL units.
+  @param[in] Wait         The command the wait is accounted to.
+
+  @retval EFI_SUCCESS  The status has reached the requested state.
+  @retval EFI_TIMEOUT  The time budget has been exceeded.
+**/
+STATIC
 EFI_STATUS
-TimeoutWaitingForStatusFlagSetMmio (
-  IN SMC_ADDRESS  BaseAddress,
-  IN UINT32       Flag,
-  IN UINTN        Iterations
+InternalWaitForStatusMmio (
+  IN SMC_ADDRESS     BaseAddress,
+  IN UINT32          Flag,
+  IN BOOLEAN         Set,
+  IN UINTN           Iterations,
+  IN APPLE_SMC_WAIT  Wait
   )
 {
   EFI_STATUS Status;
 
   SMC_STATUS SmcStatus;
-
-  SmcStatus = SmcReadKeyStatusMmio ((UINTN)BaseAddress);
+  UINT64     StartTime;
+  UINTN      Budget;
+  UINTN      Polls;
+  UINTN      Delays;
+  UINTN      Delay;
+
+  StartTime = GetPerformanceCounter ();
+  Budget    = (Iterations * SMC_MMIO_POLL_INTERVAL);
+  Polls     = 0;
+  Delays    = 0;
+  Delay     = 1;
 
   while (TRUE) {
+    SmcStatus = SmcReadKeyStatusMmio ((UINTN)BaseAddress);
+    ++Polls;
+
     Status = EFI_SUCCESS;
 
-    if ((SmcStatus & Flag) != 0) {
+    if (((SmcStatus & Flag) != 0) == Set) {
       break;
     }
 
     Status = EFI_TIMEOUT;
-    --Iterations;
 
-    if (Iterations <= 0) {
+    if (Delays >= Budget) {
       break;
     }
 
-    MicroSecondDelay (100);
+    if (Polls > SMC_MMIO_POLL_SPINS) {
+      MicroSecondDelay (Delay);
 
-    SmcStatus = SmcReadKeyStatusMmio ((UINTN)BaseAddress);
+      Delays += Delay;
+      Delay   = MIN ((Delay * 2), SMC_MMIO_POLL_CEILING);
+    }
   }
 
+  SmcIoStatisticsRecordWait (
+    Wait,
+    GetTimeInNanoSecond (GetPerformanceCounter () - StartTime),
+    Polls,
+    Delays,
+    (BOOLEAN)(Status == EFI_TIMEOUT)
+    );
+
   return Status;
 }
 
+// TimeoutWaitingForStatusFlagClearMmio
+EFI_STATUS
+TimeoutWaitingForStatusFlagClearMmio (
+  IN SMC_ADDRESS  BaseAddress,
+  IN UINT32       Flag,
+  IN UINTN        Iterations
+  )
+{
+  return InternalWaitForStatusMmio (
+           BaseAddress,
+           Flag,
+           FALSE,
+           Iterations,
+           AppleSmcWaitArbitration
+           );
+}
+
+// TimeoutWaitingForStatusFlagSetMmio
+EFI_STATUS
+TimeoutWaitingForStatusFlagSetMmio (
+  IN SMC_ADDRESS  BaseAddress,
+  IN UINT32       Flag,
+  IN UINTN        Iterations
+  )
+{
+  return InternalWaitForStatusMmio (
+           BaseAddress,
+           Flag,
+           TRUE,
+           Iterations,
+           SmcIoWaitFromCommand (mSmcMmioCommand)
+           );
+}
+
 // sub_5FB
 EFI_STATUS
 sub_5FB (
@@ -340,7 +444,6 @@ SmcReadValueMmio (
 
   SMC_RESULT    Result;
   SMC_DATA_SIZE KeySize;
-  UINT8         Index;
 
   Status = ClearArbitration (BaseAddress);
 
@@ -364,15 +467,7 @@ SmcReadValueMmio (
           goto Done;
         }
 
-        Index = 0;
-
-        do {
-          Value[Index] = SmcReadData8Mmio (
-                           BaseAddress + SMC_MMIO_DATA_VARIABLE + Index
-                           );
-
-          ++Index;
-        } while (Index < *Size);
+        InternalSmcReadDataMmio (BaseAddress, KeySize, Value);
       }
     }
   }
@@ -400,7 +495,6 @@ SmcWriteValueMmio (
 {
   EFI_STATUS Status;
 
-  UINTN      Index;
   SMC_RESULT Result;
 
   Status = EFI_INVALID_PARAMETER;
@@ -410,13 +504,7 @@ SmcWriteValueMmio (
    && (Value != NULL)) {
     ClearArbitration (BaseAddress);
 
-    Index  = 0;
-
-    do {
-      SmcWriteData8Mmio ((UINTN)BaseAddress, Value[Index]);
-
-      ++Index;
-    } while (Index < (SMC_DATA_SIZE)Size);
+    InternalSmcWriteDataMmio (BaseAddress, (SMC_DATA_SIZE)Size, Value);
 
     SmcWriteData32Mmio (BaseAddress, (UINT32)Key);
     SmcWriteAttributesMmio (BaseAddress, 0);
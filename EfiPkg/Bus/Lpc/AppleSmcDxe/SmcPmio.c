@@ -5,13 +5,114 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/IoLib.h>
+#include <Library/TimerLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
 #include "SmcIoInternal.h"
 
 // ITERATION_STALL
+/// The longest stall in microseconds between two status reads.  The
+/// iteration limits of the waits are given in units of it.
 #define ITERATION_STALL  50
 
+// SMC_PMIO_POLL_SPINS
+/// The number of status reads issued back-to-back before stalling.
+#define SMC_PMIO_POLL_SPINS  8
+
+// InternalSmcPmioWait
+/** Polls the status while (Status & Mask) == Value.
+
+  The status is read back-to-back SMC_PMIO_POLL_SPINS times first.  Then the
+  stall in between the reads starts at the device's learned stall and is
+  doubled on every read up to ITERATION_STALL.  The learned stall follows
+  the time stalled by the successful waits, so that it settles near the
+  typical response time of the SMC.  The wait times out once the stalls add
+  up to Iterations times ITERATION_STALL.
+
+  @param[in]  SmcDev      The SMC device to poll.
+  @param[in]  Mask        The status flags to examine.
+  @param[in]  Value       The flag values to keep waiting on.
+  @param[in]  Iterations  The time budget in ITERATION_STALL units.
+  @param[out] SmcStatus   The status read last.
+
+  @retval EFI_SUCCESS  The status has left the awaited state.
+  @retval EFI_TIMEOUT  The time budget has been exceeded.
+**/
+STATIC
+EFI_STATUS
+InternalSmcPmioWait (
+  IN  SMC_DEV     *SmcDev,
+  IN  SMC_STATUS  Mask,
+  IN  SMC_STATUS  Value,
+  IN  UINTN       Iterations,
+  OUT SMC_STATUS  *SmcStatus
+  )
+{
+  EFI_STATUS           Status;
+
+  SMC_PMIO_TRANSACTION *Transaction;
+  UINT64               StartTime;
+  UINT64               Time;
+  UINTN                Budget;
+  UINTN                Polls;
+  UINTN                Delays;
+  UINTN                Stall;
+
+  StartTime = GetPerformanceCounter ();
+  Budget    = (Iterations * ITERATION_STALL);
+  Polls     = 0;
+  Delays    = 0;
+  Stall     = MAX (SmcDev->PmioStall, 1);
+
+  while (TRUE) {
+    *SmcStatus = SmcIoSmcReadStatus (SmcDev);
+    ++Polls;
+
+    Status = EFI_SUCCESS;
+
+    if ((*SmcStatus & Mask) != Value) {
+      break;
+    }
+
+    Status = EFI_TIMEOUT;
+
+    if (Delays >= Budget) {
+      break;
+    }
+
+    if (Polls > SMC_PMIO_POLL_SPINS) {
+      gBS->Stall (Stall);
+
+      Delays += Stall;
+      Stall   = MIN ((Stall * 2), ITERATION_STALL);
+    }
+  }
+
+  if (!EFI_ERROR (Status)) {
+    SmcDev->PmioStall = MIN (
+                          MAX ((((SmcDev->PmioStall * 3) + Delays) / 4), 1),
+                          ITERATION_STALL
+                          );
+  }
+
+  Time = GetTimeInNanoSecond (GetPerformanceCounter () - StartTime);
+
+  Transaction = &SmcDev->PmioTransaction;
+
+  Transaction->Iterations += Polls;
+  Transaction->WaitTime   += Time;
+
+  SmcIoStatisticsRecordWait (
+    Transaction->Wait,
+    Time,
+    Polls,
+    Delays,
+    (BOOLEAN)(Status == EFI_TIMEOUT)
+    );
+
+  return Status;
+}
+
 // SmcIoSmcReadStatus
 SMC_STATUS
 SmcIoSmcReadStatus (
@@ -27,6 +128,13 @@ SmcIoSmcReadResult (
   IN SMC_DEV  *SmcDev
   )
 {
+  SmcIoStatisticsRecordTransaction (&SmcDev->PmioTransaction);
+
+  ZeroMem (
+    (VOID *)&SmcDev->PmioTransaction,
+    sizeof (SmcDev->PmioTransaction)
+    );
+
   return IoRead8 (SmcDev->SmcIo.Address + SMC_PORT_OFFSET_RESULT);
 }
 
@@ -39,45 +147,30 @@ SmcIoSmcWriteCommand (
 {
   EFI_STATUS  Status;
 
-  UINTN       Index;
   SMC_STATUS  SmcStatus;
 
-  Index     = 60000;
-  SmcStatus = SmcIoSmcReadStatus (SmcDev);
+  Status = InternalSmcPmioWait (
+             SmcDev,
+             SMC_STATUS_IB_CLOSED,
+             SMC_STATUS_IB_CLOSED,
+             60000,
+             &SmcStatus
+             );
 
-  while ((SmcStatus & SMC_STATUS_IB_CLOSED) != 0) {
-    SmcStatus = SmcIoSmcReadStatus (SmcDev);
-
-    if (Index == 0) {
-      Status = EFI_TIMEOUT;
-      goto Done;
-    }
-
-    --Index;
-
-    gBS->Stall (ITERATION_STALL);
-  }
-
-  IoWrite8 ((SmcDev->SmcIo.Address + SMC_PORT_OFFSET_COMMAND), Command);
-
-  Index = 20000;
-
-  while ((SmcStatus & SMC_STATUS_BUSY) == 0) {
-    SmcStatus = SmcIoSmcReadStatus (SmcDev);
-
-    if (Index == 0) {
-      Status = EFI_TIMEOUT;
-      goto Done;
-    }
+  if (!EFI_ERROR (Status)) {
+    SmcDev->PmioTransaction.Wait = SmcIoWaitFromCommand (Command);
 
-    --Index;
+    IoWrite8 ((SmcDev->SmcIo.Address + SMC_PORT_OFFSET_COMMAND), Command);
 
-    gBS->Stall (ITERATION_STALL);
+    Status = InternalSmcPmioWait (
+               SmcDev,
+               SMC_STATUS_BUSY,
+               0,
+               20000,
+               &SmcStatus
+               );
   }
 
-  Status = EFI_SUCCESS;
-
-Done:
   return Status;
 }
 
@@ -90,36 +183,26 @@ SmcIoSmcReadData8 (
 {
   EFI_STATUS Status;
 
-  UINTN      Index;
   SMC_STATUS SmcStatus;
-  SMC_DATA   Buffer;
 
-  Index     = 60000;
-  SmcStatus = SmcIoSmcReadStatus (SmcDev);
+  Status = InternalSmcPmioWait (
+             SmcDev,
+             (SMC_STATUS_AWAITING_DATA | SMC_STATUS_BUSY),
+             SMC_STATUS_BUSY,
+             60000,
+             &SmcStatus
+             );
 
-  while ((SmcStatus & (SMC_STATUS_AWAITING_DATA | SMC_STATUS_BUSY)) == SMC_STATUS_BUSY) {
-    SmcStatus = SmcIoSmcReadStatus (SmcDev);
+  if (!EFI_ERROR (Status)) {
+    if ((SmcStatus & SMC_STATUS_BUSY) != 0) {
+      *Data = IoRead8 (SmcDev->SmcIo.Address + SMC_PORT_OFFSET_DATA);
 
-    if (Index == 0) {
-      Status = EFI_TIMEOUT;
-      goto Done;
+      ++SmcDev->PmioTransaction.Bytes;
+    } else {
+      Status = EFI_NOT_READY;
     }
-
-    --Index;
-
-    gBS->Stall (ITERATION_STALL);
-  }
-
-  if ((SmcStatus & SMC_STATUS_BUSY) != 0) {
-    Buffer = IoRead8 (SmcDev->SmcIo.Address + SMC_PORT_OFFSET_DATA);
-
-    Status = EFI_SUCCESS;
-    *Data  = Buffer;
-  } else {
-    Status = EFI_NOT_READY;
   }
 
-Done:
   return Status;
 }
 
@@ -180,34 +263,26 @@ SmcIoSmcWriteData8 (
 {
   EFI_STATUS Status;
 
-  UINTN      RemainingIterations;
   SMC_STATUS SmcStatus;
 
-  RemainingIterations = 60000;
-  SmcStatus           = SmcIoSmcReadStatus (SmcDev);
+  Status = InternalSmcPmioWait (
+             SmcDev,
+             SMC_STATUS_IB_CLOSED,
+             SMC_STATUS_IB_CLOSED,
+             60000,
+             &SmcStatus
+             );
 
-  while ((SmcStatus & SMC_STATUS_IB_CLOSED) != 0) {
-    SmcStatus = SmcIoSmcReadStatus (SmcDev);
+  if (!EFI_ERROR (Status)) {
+    if ((SmcStatus & SMC_STATUS_BUSY) != 0) {
+      IoWrite8 ((SmcDev->SmcIo.Address + SMC_PORT_OFFSET_DATA), Data);
 
-    if (RemainingIterations == 0) {
-      Status = EFI_TIMEOUT;
-      goto Done;
+      ++SmcDev->PmioTransaction.Bytes;
+    } else {
+      Status = EFI_NOT_READY;
     }
-
-    --RemainingIterations;
-
-    gBS->Stall (ITERATION_STALL);
-  }
-
-  if ((SmcStatus & SMC_STATUS_BUSY) != 0) {
-    IoWrite8 ((SmcDev->SmcIo.Address + SMC_PORT_OFFSET_DATA), Data);
-
-    Status = EFI_SUCCESS;
-  } else {
-    Status = EFI_NOT_READY;
   }
 
-Done:
   return Status;
 }
 
@@ -269,31 +344,15 @@ SmcIoSmcTimeoutWaitingForBusyClear (
   IN SMC_DEV  *SmcDev
   )
 {
-  EFI_STATUS Status;
-
   SMC_STATUS SmcStatus;
-  UINTN      Index;
-
-  Index     = 20000;
-  SmcStatus = SmcIoSmcReadStatus (SmcDev);
-
-  while ((SmcStatus & SMC_STATUS_BUSY) != 0) {
-    SmcStatus = SmcIoSmcReadStatus (SmcDev);
 
-    if (Index == 0) {
-      Status = EFI_TIMEOUT;
-      goto Done;
-    }
-
-    --Index;
-
-    gBS->Stall (ITERATION_STALL);
-  }
-
-  Status = EFI_SUCCESS;
-
-Done:
-  return Status;
+  return InternalSmcPmioWait (
+           SmcDev,
+           SMC_STATUS_BUSY,
+           SMC_STATUS_BUSY,
+           20000,
+           &SmcStatus
+           );
 }
 
 // SmcIoSmcTimeoutWaitingLongForBusyClear
@@ -302,31 +361,15 @@ SmcIoSmcTimeoutWaitingLongForBusyClear (
   IN SMC_DEV  *SmcDev
   )
 {
-  EFI_STATUS Status;
-
   SMC_STATUS SmcStatus;
-  UINTN      Index;
 
-  Index     = 100000;
-  SmcStatus = SmcIoSmcReadStatus (SmcDev);
-
-  while ((SmcStatus & SMC_STATUS_BUSY) != 0) {
-    SmcStatus = SmcIoSmcReadStatus (SmcDev);
-
-    if (Index == 0) {
-      Status = EFI_TIMEOUT;
-      goto Done;
-    }
-
-    --Index;
-
-    gBS->Stall (ITERATION_STALL);
-  }
-
-  Status = EFI_SUCCESS;
-
-Done:
-  return Status;
+  return InternalSmcPmioWait (
+           SmcDev,
+           SMC_STATUS_BUSY,
+           SMC_STATUS_BUSY,
+           100000,
+           &SmcStatus
+           );
 }
 
 // SmcIoSmcSmcInABadState
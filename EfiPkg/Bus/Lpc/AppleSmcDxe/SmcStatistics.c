@@ -0,0 +1,311 @@
+#include <AppleMacEfi.h>
+
+#include <Guid/AppleSmcStatistics.h>
+
+#include <Protocol/AppleSmcIo.h>
+
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "SmcIoInternal.h"
+
+// mSmcStatistics
+STATIC APPLE_SMC_STATISTICS *mSmcStatistics = NULL;
+
+// mSmcStatisticsReportEvent
+STATIC EFI_EVENT mSmcStatisticsReportEvent = NULL;
+
+// mSmcWaitNames
+STATIC CONST CHAR8 *mSmcWaitNames[] = {
+  "Arbitration",
+  "ReadValue",
+  "WriteValue",
+  "GetKeyFromIndex",
+  "GetKeyInfo",
+  "Reset",
+  "FlashType",
+  "FlashWrite",
+  "FlashAuth",
+  "Other"
+};
+
+// InternalSmcStatisticsReportNotifyFunction
+/** Reports the status waits of all commands issued to the debug log once
+    boot services are exited, so that the polling policy can be tuned from
+    the response times observed.
+**/
+STATIC
+VOID
+EFIAPI
+InternalSmcStatisticsReportNotifyFunction (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  UINTN                                  Index;
+  UINTN                                  Bucket;
+  CONST CHAR8                            *Name;
+  CONST APPLE_SMC_WAIT_STATISTICS        *Wait;
+  CONST APPLE_SMC_TRANSACTION_STATISTICS *Transaction;
+
+  DEBUG ((
+    EFI_D_INFO,
+    "AppleSmc: value cache hits %Ld misses %Ld flushes %Ld\n",
+    mSmcStatistics->ValueCache.Hits,
+    mSmcStatistics->ValueCache.Misses,
+    mSmcStatistics->ValueCache.Flushes
+    ));
+
+  for (Index = 0; Index < ARRAY_SIZE (mSmcWaitNames); ++Index) {
+    Name = mSmcWaitNames[Index];
+    Wait = &mSmcStatistics->Waits[Index];
+
+    if (Wait->Waits == 0) {
+      continue;
+    }
+
+    DEBUG ((
+      EFI_D_INFO,
+      "AppleSmc: %a waits %Ld timeouts %Ld polls %Ld delays %Ld us time %Ld ns max %Ld ns\n",
+      Name,
+      Wait->Waits,
+      Wait->Timeouts,
+      Wait->Polls,
+      Wait->Delays,
+      Wait->TotalTime,
+      Wait->MaximumTime
+      ));
+
+    Transaction = &mSmcStatistics->Transactions[Index];
+
+    if (Transaction->Transactions > 0) {
+      DEBUG ((
+        EFI_D_INFO,
+        "AppleSmc: %a transactions %Ld bytes %Ld iterations %Ld wait %Ld ns max %Ld ns\n",
+        Name,
+        Transaction->Transactions,
+        Transaction->Bytes,
+        Transaction->Iterations,
+        Transaction->TotalWaitTime,
+        Transaction->MaximumWaitTime
+        ));
+    }
+
+    for (Bucket = 0; Bucket < APPLE_SMC_WAIT_BUCKETS; ++Bucket) {
+      if (Wait->WaitHistogram[Bucket] > 0) {
+        DEBUG ((
+          EFI_D_INFO,
+          "AppleSmc: %a < %Ld us: %Ld\n",
+          Name,
+          LShiftU64 (1, Bucket),
+          Wait->WaitHistogram[Bucket]
+          ));
+      }
+    }
+  }
+}
+
+// SmcIoWaitFromCommand
+APPLE_SMC_WAIT
+SmcIoWaitFromCommand (
+  IN UINT32  Command
+  )
+{
+  APPLE_SMC_WAIT Wait;
+
+  switch (Command) {
+    case SmcCmdReadValue:
+    {
+      Wait = AppleSmcWaitReadValue;
+      break;
+    }
+
+    case SmcCmdWriteValue:
+    {
+      Wait = AppleSmcWaitWriteValue;
+      break;
+    }
+
+    case SmcCmdGetKeyFromIndex:
+    {
+      Wait = AppleSmcWaitGetKeyFromIndex;
+      break;
+    }
+
+    case SmcCmdGetKeyInfo:
+    {
+      Wait = AppleSmcWaitGetKeyInfo;
+      break;
+    }
+
+    case SmcCmdReset:
+    {
+      Wait = AppleSmcWaitReset;
+      break;
+    }
+
+    case SmcCmdFlashType:
+    {
+      Wait = AppleSmcWaitFlashType;
+      break;
+    }
+
+    case SmcCmdFlashWrite:
+    case SmcCmdFlashWriteMoreData:
+    {
+      Wait = AppleSmcWaitFlashWrite;
+      break;
+    }
+
+    case SmcCmdFlashAuth:
+    case SmcCmdFlashAuthMoreData:
+    {
+      Wait = AppleSmcWaitFlashAuth;
+      break;
+    }
+
+    default:
+    {
+      Wait = AppleSmcWaitOther;
+      break;
+    }
+  }
+
+  return Wait;
+}
+
+// SmcIoCreateStatistics
+EFI_STATUS
+SmcIoCreateStatistics (
+  VOID
+  )
+{
+  EFI_STATUS Status;
+
+  mSmcStatistics = AllocateRuntimeZeroPool (sizeof (*mSmcStatistics));
+
+  Status = EFI_OUT_OF_RESOURCES;
+
+  if (mSmcStatistics != NULL) {
+    mSmcStatistics->Revision      = APPLE_SMC_STATISTICS_REVISION;
+    mSmcStatistics->NumberOfWaits = AppleSmcWaitMaximum;
+
+    Status = gBS->InstallConfigurationTable (
+                    &gAppleSmcStatisticsGuid,
+                    (VOID *)mSmcStatistics
+                    );
+
+    if (!EFI_ERROR (Status)) {
+      gBS->CreateEvent (
+             EVT_SIGNAL_EXIT_BOOT_SERVICES,
+             TPL_NOTIFY,
+             InternalSmcStatisticsReportNotifyFunction,
+             NULL,
+             &mSmcStatisticsReportEvent
+             );
+    } else {
+      FreePool ((VOID *)mSmcStatistics);
+
+      mSmcStatistics = NULL;
+    }
+  }
+
+  return Status;
+}
+
+// SmcIoStatisticsRecordWait
+VOID
+SmcIoStatisticsRecordWait (
+  IN APPLE_SMC_WAIT  Wait,
+  IN UINT64          Time,
+  IN UINTN           Polls,
+  IN UINTN           Delays,
+  IN BOOLEAN         TimedOut
+  )
+{
+  APPLE_SMC_WAIT_STATISTICS *Statistics;
+  UINT64                    MicroSeconds;
+  UINTN                     Bucket;
+
+  if (mSmcStatistics != NULL) {
+    Statistics = &mSmcStatistics->Waits[Wait];
+
+    ++Statistics->Waits;
+
+    if (TimedOut) {
+      ++Statistics->Timeouts;
+    }
+
+    Statistics->Polls     += Polls;
+    Statistics->Delays    += Delays;
+    Statistics->TotalTime += Time;
+
+    if (Time > Statistics->MaximumTime) {
+      Statistics->MaximumTime = Time;
+    }
+
+    MicroSeconds = DivU64x32 (Time, 1000);
+    Bucket       = 0;
+
+    if (MicroSeconds > 0) {
+      Bucket = (UINTN)(HighBitSet64 (MicroSeconds) + 1);
+
+      if (Bucket >= APPLE_SMC_WAIT_BUCKETS) {
+        Bucket = (APPLE_SMC_WAIT_BUCKETS - 1);
+      }
+    }
+
+    ++Statistics->WaitHistogram[Bucket];
+  }
+}
+
+// SmcIoStatisticsRecordTransaction
+VOID
+SmcIoStatisticsRecordTransaction (
+  IN CONST SMC_PMIO_TRANSACTION  *Transaction
+  )
+{
+  APPLE_SMC_TRANSACTION_STATISTICS *Statistics;
+
+  if (mSmcStatistics != NULL) {
+    Statistics = &mSmcStatistics->Transactions[Transaction->Wait];
+
+    ++Statistics->Transactions;
+
+    Statistics->Bytes         += Transaction->Bytes;
+    Statistics->Iterations    += Transaction->Iterations;
+    Statistics->TotalWaitTime += Transaction->WaitTime;
+
+    if (Transaction->WaitTime > Statistics->MaximumWaitTime) {
+      Statistics->MaximumWaitTime = Transaction->WaitTime;
+    }
+  }
+}
+
+// SmcIoStatisticsCountValueCache
+VOID
+SmcIoStatisticsCountValueCache (
+  IN BOOLEAN  Hit
+  )
+{
+  if (mSmcStatistics != NULL) {
+    if (Hit) {
+      ++mSmcStatistics->ValueCache.Hits;
+    } else {
+      ++mSmcStatistics->ValueCache.Misses;
+    }
+  }
+}
+
+// SmcIoStatisticsCountValueCacheFlush
+VOID
+SmcIoStatisticsCountValueCacheFlush (
+  VOID
+  )
+{
+  if (mSmcStatistics != NULL) {
+    ++mSmcStatistics->ValueCache.Flushes;
+  }
+}
@@ -0,0 +1,291 @@
+#include <AppleMacEfi.h>
+
+#include <Guid/AppleSmcVariable.h>
+
+#include <Protocol/AppleSmcIo.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+
+#include "SmcIoInternal.h"
+
+// SMC_VALUE_CACHE_TTL_INFINITE
+#define SMC_VALUE_CACHE_TTL_INFINITE  APPLE_SMC_VALUE_CACHE_TTL_INFINITE
+
+// SMC_VALUE_CACHE_SENSOR_TTL
+/// The time in microseconds sensor readings are kept.
+#define SMC_VALUE_CACHE_SENSOR_TTL  100000
+
+// SMC_KEY_PREFIX_MASK
+#define SMC_KEY_PREFIX_MASK  SMC_MAKE_KEY (0xFF, 0x00, 0x00, 0x00)
+
+// SMC_VALUE_CACHE_MAX_TTL_OVERRIDES
+#define SMC_VALUE_CACHE_MAX_TTL_OVERRIDES  64
+
+// mSmcValueCacheTtls
+/// The time values of read-only keys are kept, matched in order.  Keys not
+/// listed are not cached unless their attributes mark them constant.  Status
+/// keys, e.g. the "M" keys, are polled and hence not listed.
+STATIC CONST APPLE_SMC_VALUE_CACHE_TTL mSmcValueCacheTtls[] = {
+  //
+  // Identity and revision keys, e.g. "REV ", "RPlt" and "RSSN".
+  //
+  {
+    SMC_MAKE_KEY ('R', 0x00, 0x00, 0x00),
+    SMC_KEY_PREFIX_MASK,
+    SMC_VALUE_CACHE_TTL_INFINITE
+  },
+  {
+    SMC_MAKE_KEY ('#', 'K', 'e', 'y'),
+    MAX_UINT32,
+    SMC_VALUE_CACHE_TTL_INFINITE
+  },
+  //
+  // Temperature, fan, voltage, current, power and battery sensors.
+  //
+  {
+    SMC_MAKE_KEY ('T', 0x00, 0x00, 0x00),
+    SMC_KEY_PREFIX_MASK,
+    SMC_VALUE_CACHE_SENSOR_TTL
+  },
+  {
+    SMC_MAKE_KEY ('F', 0x00, 0x00, 0x00),
+    SMC_KEY_PREFIX_MASK,
+    SMC_VALUE_CACHE_SENSOR_TTL
+  },
+  {
+    SMC_MAKE_KEY ('V', 0x00, 0x00, 0x00),
+    SMC_KEY_PREFIX_MASK,
+    SMC_VALUE_CACHE_SENSOR_TTL
+  },
+  {
+    SMC_MAKE_KEY ('I', 0x00, 0x00, 0x00),
+    SMC_KEY_PREFIX_MASK,
+    SMC_VALUE_CACHE_SENSOR_TTL
+  },
+  {
+    SMC_MAKE_KEY ('P', 0x00, 0x00, 0x00),
+    SMC_KEY_PREFIX_MASK,
+    SMC_VALUE_CACHE_SENSOR_TTL
+  },
+  {
+    SMC_MAKE_KEY ('B', 0x00, 0x00, 0x00),
+    SMC_KEY_PREFIX_MASK,
+    SMC_VALUE_CACHE_SENSOR_TTL
+  }
+};
+
+// mSmcValueCacheTtlOverrides
+/// The entries of the APPLE_SMC_VALUE_CACHE_TTL_VARIABLE_NAME variable.
+STATIC APPLE_SMC_VALUE_CACHE_TTL *mSmcValueCacheTtlOverrides = NULL;
+
+// mNumberOfSmcValueCacheTtlOverrides
+STATIC UINTN mNumberOfSmcValueCacheTtlOverrides = 0;
+
+// InternalGetValueCacheTime
+STATIC
+UINT64
+InternalGetValueCacheTime (
+  VOID
+  )
+{
+  return GetTimeInNanoSecond (GetPerformanceCounter ());
+}
+
+// InternalGetValueTtl
+/** Returns the time in microseconds a value of Key is kept, or 0 if it must
+    not be cached.  Overrides take precedence over the constant attribute, so
+    that caching of a misattributed key can be disabled.
+**/
+STATIC
+UINT64
+InternalGetValueTtl (
+  IN SMC_KEY             Key,
+  IN SMC_KEY_ATTRIBUTES  Attributes
+  )
+{
+  UINTN Index;
+
+  if (((Attributes & SMC_KEY_ATTRIBUTE_READ) == 0)
+   || ((Attributes & (SMC_KEY_ATTRIBUTE_WRITE
+                       | SMC_KEY_ATTRIBUTE_FUNCTION)) != 0)) {
+    return 0;
+  }
+
+  for (Index = 0; Index < mNumberOfSmcValueCacheTtlOverrides; ++Index) {
+    if ((Key & mSmcValueCacheTtlOverrides[Index].Mask)
+          == mSmcValueCacheTtlOverrides[Index].Key) {
+      return mSmcValueCacheTtlOverrides[Index].Ttl;
+    }
+  }
+
+  if ((Attributes & SMC_KEY_ATTRIBUTE_CONST) != 0) {
+    return SMC_VALUE_CACHE_TTL_INFINITE;
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (mSmcValueCacheTtls); ++Index) {
+    if ((Key & mSmcValueCacheTtls[Index].Mask)
+          == mSmcValueCacheTtls[Index].Key) {
+      return mSmcValueCacheTtls[Index].Ttl;
+    }
+  }
+
+  return 0;
+}
+
+// SmcIoLoadValueCacheTtls
+VOID
+SmcIoLoadValueCacheTtls (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+
+  UINTN                     DataSize;
+  APPLE_SMC_VALUE_CACHE_TTL *Ttls;
+
+  DataSize = 0;
+  Status   = gRT->GetVariable (
+                    APPLE_SMC_VALUE_CACHE_TTL_VARIABLE_NAME,
+                    &gAppleSmcVariableGuid,
+                    NULL,
+                    &DataSize,
+                    NULL
+                    );
+
+  if ((Status != EFI_BUFFER_TOO_SMALL)
+   || ((DataSize % sizeof (*Ttls)) != 0)
+   || (DataSize > (SMC_VALUE_CACHE_MAX_TTL_OVERRIDES * sizeof (*Ttls)))) {
+    return;
+  }
+
+  Ttls = AllocatePool (DataSize);
+
+  if (Ttls != NULL) {
+    Status = gRT->GetVariable (
+                    APPLE_SMC_VALUE_CACHE_TTL_VARIABLE_NAME,
+                    &gAppleSmcVariableGuid,
+                    NULL,
+                    &DataSize,
+                    (VOID *)Ttls
+                    );
+
+    if (!EFI_ERROR (Status) && ((DataSize % sizeof (*Ttls)) == 0)) {
+      mSmcValueCacheTtlOverrides         = Ttls;
+      mNumberOfSmcValueCacheTtlOverrides = (DataSize / sizeof (*Ttls));
+
+      DEBUG ((
+        EFI_D_INFO,
+        "AppleSmc: Loaded %d value cache TTL overrides\n",
+        (UINT32)mNumberOfSmcValueCacheTtlOverrides
+        ));
+    } else {
+      FreePool ((VOID *)Ttls);
+    }
+  }
+}
+
+// SmcIoLookupValue
+BOOLEAN
+SmcIoLookupValue (
+  IN  SMC_DEV        *SmcDev,
+  IN  SMC_KEY        Key,
+  IN  SMC_DATA_SIZE  Size,
+  OUT SMC_DATA       *Value
+  )
+{
+  BOOLEAN               Hit;
+
+  UINTN                 Index;
+  SMC_VALUE_CACHE_ENTRY *Entry;
+
+  Hit = FALSE;
+
+  for (Index = 0; Index < ARRAY_SIZE (SmcDev->ValueCache); ++Index) {
+    Entry = &SmcDev->ValueCache[Index];
+
+    if ((Entry->Key != Key) || (Entry->Size == 0)) {
+      continue;
+    }
+
+    if (Entry->Expiry < InternalGetValueCacheTime ()) {
+      Entry->Size = 0;
+    } else if (Entry->Size == Size) {
+      CopyMem ((VOID *)Value, (VOID *)&Entry->Value[0], Size);
+
+      Hit = TRUE;
+    }
+
+    break;
+  }
+
+  SmcIoStatisticsCountValueCache (Hit);
+
+  return Hit;
+}
+
+// SmcIoStoreValue
+VOID
+SmcIoStoreValue (
+  IN SMC_DEV             *SmcDev,
+  IN SMC_KEY             Key,
+  IN SMC_KEY_ATTRIBUTES  Attributes,
+  IN SMC_DATA_SIZE       Size,
+  IN CONST SMC_DATA      *Value
+  )
+{
+  UINT64                Ttl;
+  UINTN                 Index;
+  SMC_VALUE_CACHE_ENTRY *Entry;
+
+  Ttl = InternalGetValueTtl (Key, Attributes);
+
+  if ((Ttl == 0) || (Size == 0) || (Size > SMC_MAX_DATA_SIZE)) {
+    return;
+  }
+
+  //
+  // Replace the entry of the key if it is cached, or else the oldest entry.
+  //
+  for (Index = 0; Index < ARRAY_SIZE (SmcDev->ValueCache); ++Index) {
+    if ((SmcDev->ValueCache[Index].Key == Key)
+     && (SmcDev->ValueCache[Index].Size != 0)) {
+      break;
+    }
+  }
+
+  if (Index == ARRAY_SIZE (SmcDev->ValueCache)) {
+    Index = SmcDev->NextValueCacheEntry;
+
+    SmcDev->NextValueCacheEntry = ((Index + 1) % SMC_VALUE_CACHE_SIZE);
+  }
+
+  Entry = &SmcDev->ValueCache[Index];
+
+  Entry->Key    = Key;
+  Entry->Size   = Size;
+  Entry->Expiry = SMC_VALUE_CACHE_TTL_INFINITE;
+
+  if (Ttl != SMC_VALUE_CACHE_TTL_INFINITE) {
+    Entry->Expiry = (InternalGetValueCacheTime () + MultU64x32 (Ttl, 1000));
+  }
+
+  CopyMem ((VOID *)&Entry->Value[0], (VOID *)Value, Size);
+}
+
+// SmcIoFlushValueCache
+VOID
+SmcIoFlushValueCache (
+  IN SMC_DEV  *SmcDev
+  )
+{
+  ZeroMem ((VOID *)&SmcDev->ValueCache[0], sizeof (SmcDev->ValueCache));
+
+  SmcDev->NextValueCacheEntry = 0;
+
+  SmcIoStatisticsCountValueCacheFlush ();
+}
@@ -0,0 +1,58 @@
+#ifndef APPLE_BOOT_POLICY_STATISTICS_H_
+#define APPLE_BOOT_POLICY_STATISTICS_H_
+
+// APPLE_BOOT_POLICY_STATISTICS_GUID
+/// The configuration table publishing APPLE_BOOT_POLICY_STATISTICS.  The
+/// table resides in runtime memory and may be read by the OS.
+#define APPLE_BOOT_POLICY_STATISTICS_GUID                 \
+  { 0xC93DEED4, 0x1EC1, 0x4456,                           \
+    { 0x93, 0x4B, 0x61, 0xFC, 0xA9, 0x6A, 0xDE, 0x22 } }
+
+// APPLE_BOOT_POLICY_STATISTICS_REVISION
+#define APPLE_BOOT_POLICY_STATISTICS_REVISION  0x00000001
+
+// APPLE_BOOT_POLICY_LATENCY_BUCKETS
+/// Bucket 0 counts calls shorter than 1 us, bucket n calls of [2^(n-1), 2^n)
+/// us.  The last bucket also counts all longer calls.
+#define APPLE_BOOT_POLICY_LATENCY_BUCKETS  24
+
+// APPLE_BOOT_POLICY_FUNCTION
+enum {
+  AppleBootPolicyFunctionGetBootFile,
+  AppleBootPolicyFunctionGetBootFileEx,
+  AppleBootPolicyFunctionGetBootInfo,
+  AppleBootPolicyFunctionGetPathNameOnApfsRecovery,
+  AppleBootPolicyFunctionGetApfsRecoveryVolumes,
+  AppleBootPolicyFunctionGetNextVolume,
+  AppleBootPolicyFunctionGetVolumesByRole,
+  AppleBootPolicyFunctionMaximum
+};
+
+typedef UINT32 APPLE_BOOT_POLICY_FUNCTION;
+
+// APPLE_BOOT_POLICY_FUNCTION_STATISTICS
+/// The statistics of one boot policy function.  The times include nested
+/// boot policy functions, while the operations are only accounted to the
+/// innermost function issuing them.
+typedef struct {
+  UINT64 Calls;
+  UINT64 HandlesScanned;
+  UINT64 OpenCalls;
+  UINT64 GetInfoCalls;
+  UINT64 TotalTime;
+  UINT64 MaximumTime;
+  UINT64 LatencyHistogram[APPLE_BOOT_POLICY_LATENCY_BUCKETS];
+} APPLE_BOOT_POLICY_FUNCTION_STATISTICS;
+
+// APPLE_BOOT_POLICY_STATISTICS
+/// Times are reported in nanoseconds.
+typedef struct {
+  UINT32                                Revision;
+  UINT32                                NumberOfFunctions;
+  APPLE_BOOT_POLICY_FUNCTION_STATISTICS Functions[AppleBootPolicyFunctionMaximum];
+} APPLE_BOOT_POLICY_STATISTICS;
+
+// gAppleBootPolicyStatisticsGuid
+extern EFI_GUID gAppleBootPolicyStatisticsGuid;
+
+#endif // APPLE_BOOT_POLICY_STATISTICS_H_
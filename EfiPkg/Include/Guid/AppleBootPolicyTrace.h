@@ -0,0 +1,87 @@
+#ifndef APPLE_BOOT_POLICY_TRACE_H_
+#define APPLE_BOOT_POLICY_TRACE_H_
+
+// APPLE_BOOT_POLICY_TRACE_GUID
+/// The configuration table publishing APPLE_BOOT_POLICY_TRACE.  It is only
+/// installed if the trace has been enabled via the
+/// APPLE_BOOT_POLICY_TRACE_VARIABLE_NAME variable.
+#define APPLE_BOOT_POLICY_TRACE_GUID                      \
+  { 0x472E3A3D, 0x2D59, 0x4E3A,                           \
+    { 0x84, 0xEA, 0x14, 0x0E, 0x40, 0xDE, 0xC0, 0xA8 } }
+
+// APPLE_BOOT_POLICY_TRACE_REVISION
+#define APPLE_BOOT_POLICY_TRACE_REVISION  0x00000002
+
+// APPLE_BOOT_POLICY_TRACE_PATH_NAME_LENGTH
+/// The number of characters of a path name recorded, including the
+/// terminator.  Longer path names are truncated.
+#define APPLE_BOOT_POLICY_TRACE_PATH_NAME_LENGTH  64
+
+// APPLE_BOOT_POLICY_TRACE_INFORMATION_SIZE
+/// The number of bytes of a GetInfo() buffer recorded.  Larger buffers are
+/// truncated.
+#define APPLE_BOOT_POLICY_TRACE_INFORMATION_SIZE  128
+
+// APPLE_BOOT_POLICY_TRACE_RECORD_INFORMATION
+/// Enables recording the buffers returned by GetInfo(), see
+/// APPLE_BOOT_POLICY_TRACE_CONFIG.
+#define APPLE_BOOT_POLICY_TRACE_RECORD_INFORMATION  BIT0
+
+// APPLE_BOOT_POLICY_TRACE_CONFIG
+/// The content of the APPLE_BOOT_POLICY_TRACE_VARIABLE_NAME variable.  Flags
+/// may be omitted, in which case it defaults to 0.
+typedef struct {
+  UINT32 MaximumNumberOfRecords;
+  UINT32 Flags;
+} APPLE_BOOT_POLICY_TRACE_CONFIG;
+
+// APPLE_BOOT_POLICY_TRACE_OPERATION
+enum {
+  AppleBootPolicyTraceOpenVolume,
+  AppleBootPolicyTraceOpen,
+  AppleBootPolicyTraceOpenEx,
+  AppleBootPolicyTraceRead,
+  AppleBootPolicyTraceGetInfo
+};
+
+typedef UINT32 APPLE_BOOT_POLICY_TRACE_OPERATION;
+
+// APPLE_BOOT_POLICY_TRACE_RECORD
+/// A file system call.  Handle is the device handle for OpenVolume() and the
+/// file the call has been issued on otherwise.  NewHandle is the file
+/// returned by a successful OpenVolume(), OpenEx() or Open(), and 0
+/// otherwise.  InformationType is only valid for GetInfo(), PathName only for
+/// OpenEx() and Open().  Size is the buffer size returned by Read() and
+/// GetInfo().  Information holds the first InformationSize bytes of the
+/// buffer returned by a successful GetInfo(), if enabled.
+typedef struct {
+  UINT64                            Handle;
+  UINT64                            NewHandle;
+  UINT64                            Status;
+  UINT64                            Size;
+  UINT64                            Latency;
+  EFI_GUID                          InformationType;
+  APPLE_BOOT_POLICY_TRACE_OPERATION Operation;
+  UINT32                            InformationSize;
+  CHAR16                            PathName[APPLE_BOOT_POLICY_TRACE_PATH_NAME_LENGTH];
+  UINT8                             Information[APPLE_BOOT_POLICY_TRACE_INFORMATION_SIZE];
+} APPLE_BOOT_POLICY_TRACE_RECORD;
+
+// APPLE_BOOT_POLICY_TRACE
+/// The trace of all file system calls issued by the boot policy, in order of
+/// completion.  Records beyond MaximumNumberOfRecords are counted in
+/// NumberOfRecords, but are not stored.  Latencies are reported in
+/// nanoseconds.  Flags is the Flags value the trace has been enabled with.
+typedef struct {
+  UINT32                         Revision;
+  UINT32                         MaximumNumberOfRecords;
+  UINT64                         NumberOfRecords;
+  UINT32                         Flags;
+  UINT32                         Reserved;
+  APPLE_BOOT_POLICY_TRACE_RECORD Records[1];
+} APPLE_BOOT_POLICY_TRACE;
+
+// gAppleBootPolicyTraceGuid
+extern EFI_GUID gAppleBootPolicyTraceGuid;
+
+#endif // APPLE_BOOT_POLICY_TRACE_H_
@@ -0,0 +1,22 @@
+#ifndef APPLE_BOOT_POLICY_VARIABLE_H_
+#define APPLE_BOOT_POLICY_VARIABLE_H_
+
+// APPLE_BOOT_POLICY_VARIABLE_GUID
+#define APPLE_BOOT_POLICY_VARIABLE_GUID                   \
+  { 0xA071D512, 0x3AB3, 0x4CFB,                           \
+    { 0x8A, 0xA1, 0xA4, 0xBD, 0x21, 0x2C, 0x06, 0xF3 } }
+
+// APPLE_BOOT_POLICY_FILE_CACHE_VARIABLE_NAME
+/// The non-volatile variable caching the resolved boot files of volumes.
+#define APPLE_BOOT_POLICY_FILE_CACHE_VARIABLE_NAME  L"BootFileCache"
+
+// APPLE_BOOT_POLICY_TRACE_VARIABLE_NAME
+/// An APPLE_BOOT_POLICY_TRACE_CONFIG variable enabling the file system trace,
+/// see APPLE_BOOT_POLICY_TRACE.  A UINT32 holding only the number of records
+/// is accepted as well.
+#define APPLE_BOOT_POLICY_TRACE_VARIABLE_NAME  L"BootPolicyTrace"
+
+// gAppleBootPolicyVariableGuid
+extern EFI_GUID gAppleBootPolicyVariableGuid;
+
+#endif // APPLE_BOOT_POLICY_VARIABLE_H_
@@ -0,0 +1,85 @@
+#ifndef APPLE_SMC_STATISTICS_H_
+#define APPLE_SMC_STATISTICS_H_
+
+// APPLE_SMC_STATISTICS_GUID
+/// The configuration table publishing APPLE_SMC_STATISTICS.  The table
+/// resides in runtime memory and may be read by the OS.
+#define APPLE_SMC_STATISTICS_GUID                         \
+  { 0xBB2ACE7F, 0x3ABC, 0x4D20,                           \
+    { 0xB3, 0x45, 0xCE, 0xE7, 0x47, 0xEF, 0x42, 0x4B } }
+
+// APPLE_SMC_STATISTICS_REVISION
+#define APPLE_SMC_STATISTICS_REVISION  0x00000001
+
+// APPLE_SMC_WAIT_BUCKETS
+/// Bucket 0 counts waits shorter than 1 us, bucket n waits of [2^(n-1), 2^n)
+/// us.  The last bucket also counts all longer waits.
+#define APPLE_SMC_WAIT_BUCKETS  20
+
+// APPLE_SMC_WAIT
+/// The command a status wait has been accounted to.  Waits for the
+/// arbitration to clear precede the command and are accounted separately.
+enum {
+  AppleSmcWaitArbitration,
+  AppleSmcWaitReadValue,
+  AppleSmcWaitWriteValue,
+  AppleSmcWaitGetKeyFromIndex,
+  AppleSmcWaitGetKeyInfo,
+  AppleSmcWaitReset,
+  AppleSmcWaitFlashType,
+  AppleSmcWaitFlashWrite,
+  AppleSmcWaitFlashAuth,
+  AppleSmcWaitOther,
+  AppleSmcWaitMaximum
+};
+
+typedef UINT32 APPLE_SMC_WAIT;
+
+// APPLE_SMC_WAIT_STATISTICS
+/// The status waits of one command.  Polls counts the status reads issued,
+/// Delays the time slept in between in microseconds.
+typedef struct {
+  UINT64 Waits;
+  UINT64 Timeouts;
+  UINT64 Polls;
+  UINT64 Delays;
+  UINT64 TotalTime;
+  UINT64 MaximumTime;
+  UINT64 WaitHistogram[APPLE_SMC_WAIT_BUCKETS];
+} APPLE_SMC_WAIT_STATISTICS;
+
+// APPLE_SMC_TRANSACTION_STATISTICS
+/// The port I/O transactions of one command.  A transaction spans all bytes
+/// moved and status waits issued since the previous result has been read,
+/// including the arbitration preceding the command.
+typedef struct {
+  UINT64 Transactions;
+  UINT64 Bytes;
+  UINT64 Iterations;
+  UINT64 TotalWaitTime;
+  UINT64 MaximumWaitTime;
+} APPLE_SMC_TRANSACTION_STATISTICS;
+
+// APPLE_SMC_VALUE_CACHE_STATISTICS
+/// The value cache of hardware SMC reads.  Hits and misses add up to all
+/// values read, including those of keys which are never cached.
+typedef struct {
+  UINT64 Hits;
+  UINT64 Misses;
+  UINT64 Flushes;
+} APPLE_SMC_VALUE_CACHE_STATISTICS;
+
+// APPLE_SMC_STATISTICS
+/// Times are reported in nanoseconds unless stated otherwise.
+typedef struct {
+  UINT32                           Revision;
+  UINT32                           NumberOfWaits;
+  APPLE_SMC_WAIT_STATISTICS        Waits[AppleSmcWaitMaximum];
+  APPLE_SMC_TRANSACTION_STATISTICS Transactions[AppleSmcWaitMaximum];
+  APPLE_SMC_VALUE_CACHE_STATISTICS ValueCache;
+} APPLE_SMC_STATISTICS;
+
+// gAppleSmcStatisticsGuid
+extern EFI_GUID gAppleSmcStatisticsGuid;
+
+#endif // APPLE_SMC_STATISTICS_H_
@@ -0,0 +1,36 @@
+#ifndef APPLE_SMC_VARIABLE_H_
+#define APPLE_SMC_VARIABLE_H_
+
+// APPLE_SMC_VARIABLE_GUID
+#define APPLE_SMC_VARIABLE_GUID                           \
+  { 0x66EEF041, 0xBB82, 0x4FEF,                           \
+    { 0xB5, 0x70, 0xE8, 0x0D, 0xCF, 0xE3, 0x51, 0xCE } }
+
+// APPLE_SMC_KEY_PRELOAD_VARIABLE_NAME
+/// A UINT8 variable which, when non-zero, makes the SMC driver enumerate the
+/// full key directory of the SMC once at startup.  Key lookups are then
+/// answered from memory.
+#define APPLE_SMC_KEY_PRELOAD_VARIABLE_NAME  L"SmcKeyPreload"
+
+// APPLE_SMC_VALUE_CACHE_TTL_VARIABLE_NAME
+/// An array of APPLE_SMC_VALUE_CACHE_TTL overriding how long the SMC driver
+/// caches the values of read-only keys.  Its entries are matched before the
+/// built-in ones.
+#define APPLE_SMC_VALUE_CACHE_TTL_VARIABLE_NAME  L"SmcValueCacheTtl"
+
+// APPLE_SMC_VALUE_CACHE_TTL_INFINITE
+#define APPLE_SMC_VALUE_CACHE_TTL_INFINITE  MAX_UINT64
+
+// APPLE_SMC_VALUE_CACHE_TTL
+/// The time values of the keys matching Key under Mask are cached.  A Ttl of
+/// 0 disables caching.
+typedef struct {
+  UINT32 Key;
+  UINT32 Mask;
+  UINT64 Ttl;   ///< In microseconds.
+} APPLE_SMC_VALUE_CACHE_TTL;
+
+// gAppleSmcVariableGuid
+extern EFI_GUID gAppleSmcVariableGuid;
+
+#endif // APPLE_SMC_VARIABLE_H_
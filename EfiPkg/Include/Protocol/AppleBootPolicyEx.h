@@ -0,0 +1,160 @@
+#ifndef APPLE_BOOT_POLICY_EX_H_
+#define APPLE_BOOT_POLICY_EX_H_
+
+#include <Guid/AppleApfsInfo.h>
+
+#include <Protocol/DevicePath.h>
+#include <Protocol/SimpleFileSystem.h>
+
+// APPLE_BOOT_POLICY_EX_PROTOCOL_GUID
+#define APPLE_BOOT_POLICY_EX_PROTOCOL_GUID                \
+  { 0x779C5EE1, 0x298D, 0x44FB,                           \
+    { 0xAB, 0xF5, 0x12, 0x61, 0x66, 0x19, 0xF7, 0xCC } }
+
+// APPLE_BOOT_POLICY_EX_PROTOCOL_REVISION
+#define APPLE_BOOT_POLICY_EX_PROTOCOL_REVISION  0x00000001
+
+// APPLE_BOOT_POLICY_VOLUME_CURSOR
+/// An opaque enumeration state returned by OpenVolumeCursor().
+typedef struct APPLE_BOOT_POLICY_VOLUME_CURSOR APPLE_BOOT_POLICY_VOLUME_CURSOR;
+
+// BOOT_POLICY_OPEN_VOLUME_CURSOR
+/** Starts an incremental enumeration of the bootable volumes.
+
+  The file systems present at the time of the call are snapshotted, though no
+  volume is probed before it is requested via GetNextVolume().
+
+  @param[in]  Mode    The mode to resolve the boot files with, as passed to
+                      APPLE_BOOT_POLICY_PROTOCOL.GetBootFileEx().
+  @param[out] Cursor  Receives the enumeration state.
+
+  @retval EFI_SUCCESS           The cursor has been created.
+  @retval EFI_NOT_FOUND         No file system is present.
+  @retval EFI_OUT_OF_RESOURCES  The cursor could not be allocated.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *BOOT_POLICY_OPEN_VOLUME_CURSOR)(
+  IN  UINT32                           Mode,
+  OUT APPLE_BOOT_POLICY_VOLUME_CURSOR  **Cursor
+  );
+
+// BOOT_POLICY_GET_NEXT_VOLUME
+/** Probes the remaining volumes of Cursor until a bootable one is found.
+    Volumes without a boot file are skipped.  Any other error is returned
+    for the volume it occurred on, and the enumeration may be resumed after
+    it with the next call.
+
+  @param[in]  Cursor    The enumeration state returned by OpenVolumeCursor().
+  @param[out] Device    Receives the handle of the bootable volume.
+  @param[out] FilePath  Receives the device path of the volume's boot file.
+                        The caller is responsible for freeing it.
+
+  @retval EFI_SUCCESS            A bootable volume has been returned.
+  @retval EFI_NOT_FOUND          The enumeration has completed.
+  @retval EFI_INVALID_PARAMETER  Cursor is not a valid cursor.
+  @retval other                  Probing the next volume failed, as returned
+                                 by GetBootFileEx().
+**/
+typedef
+EFI_STATUS
+(EFIAPI *BOOT_POLICY_GET_NEXT_VOLUME)(
+  IN  APPLE_BOOT_POLICY_VOLUME_CURSOR  *Cursor,
+  OUT EFI_HANDLE                       *Device,
+  OUT EFI_DEVICE_PATH_PROTOCOL         **FilePath
+  );
+
+// BOOT_POLICY_CLOSE_VOLUME_CURSOR
+/** Ends an enumeration, which may be done before it has completed.
+
+  @param[in] Cursor  The enumeration state to release.
+**/
+typedef
+VOID
+(EFIAPI *BOOT_POLICY_CLOSE_VOLUME_CURSOR)(
+  IN APPLE_BOOT_POLICY_VOLUME_CURSOR  *Cursor
+  );
+
+// APPLE_BOOT_POLICY_GUID_STRING_LENGTH
+/// The number of characters of a GUID formatted as by "%g".
+#define APPLE_BOOT_POLICY_GUID_STRING_LENGTH  36
+
+// APPLE_BOOT_POLICY_VOLUME_ROLE_ANY
+/// Passed as RoleMask to GetVolumesByRole() to return all APFS volumes,
+/// including those without a role.
+#define APPLE_BOOT_POLICY_VOLUME_ROLE_ANY  0
+
+// APPLE_BOOT_POLICY_VOLUME_ENTRY
+/// An APFS volume returned by GetVolumesByRole().  VolumeDirName names the
+/// directory of the volume within the preboot and recovery volumes of its
+/// container.
+typedef struct {
+  EFI_HANDLE             Handle;
+  EFI_GUID               ContainerGuid;
+  EFI_GUID               VolumeGuid;
+  APPLE_APFS_VOLUME_ROLE Role;
+  CHAR16                 VolumeDirName[APPLE_BOOT_POLICY_GUID_STRING_LENGTH + 1];
+} APPLE_BOOT_POLICY_VOLUME_ENTRY;
+
+// APPLE_BOOT_POLICY_VOLUME_LIST
+/// The result of GetVolumesByRole(), released by a single FreePool().  The
+/// volumes of a container are stored contiguously.
+typedef struct {
+  UINTN                          NumberOfVolumes;
+  APPLE_BOOT_POLICY_VOLUME_ENTRY Volumes[1];
+} APPLE_BOOT_POLICY_VOLUME_LIST;
+
+// BOOT_POLICY_GET_VOLUMES_BY_ROLE
+/** Retrieves all APFS volumes with any of the roles in RoleMask.
+
+  No file is opened, the volumes are served from the APFS volume cache.  Use
+  OpenVolumeRoot() to access the volumes needed.
+
+  @param[in]  RoleMask  The APPLE_APFS_VOLUME_ROLE bits to match, or
+                        APPLE_BOOT_POLICY_VOLUME_ROLE_ANY.
+  @param[out] List      Receives the matching volumes in a single pool
+                        allocation.  The caller is responsible for freeing it.
+
+  @retval EFI_SUCCESS           The volumes have been returned.
+  @retval EFI_NOT_FOUND         No volume matches RoleMask.
+  @retval EFI_OUT_OF_RESOURCES  The list could not be allocated.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *BOOT_POLICY_GET_VOLUMES_BY_ROLE)(
+  IN  APPLE_APFS_VOLUME_ROLE         RoleMask,
+  OUT APPLE_BOOT_POLICY_VOLUME_LIST  **List
+  );
+
+// BOOT_POLICY_OPEN_VOLUME_ROOT
+/** Opens the root directory of a volume returned by GetVolumesByRole().
+
+  @param[in]  Volume  The volume to open.
+  @param[out] Root    Receives the opened root.  The caller is responsible for
+                      closing it.
+
+  @retval EFI_SUCCESS  The root has been opened.
+  @retval other        The file system is gone or could not be opened.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *BOOT_POLICY_OPEN_VOLUME_ROOT)(
+  IN  CONST APPLE_BOOT_POLICY_VOLUME_ENTRY  *Volume,
+  OUT EFI_FILE_PROTOCOL                     **Root
+  );
+
+// APPLE_BOOT_POLICY_EX_PROTOCOL
+/// Companion of APPLE_BOOT_POLICY_PROTOCOL, installed on the same handle.
+typedef struct {
+  UINTN                           Revision;
+  BOOT_POLICY_OPEN_VOLUME_CURSOR  OpenVolumeCursor;
+  BOOT_POLICY_GET_NEXT_VOLUME     GetNextVolume;
+  BOOT_POLICY_CLOSE_VOLUME_CURSOR CloseVolumeCursor;
+  BOOT_POLICY_GET_VOLUMES_BY_ROLE GetVolumesByRole;
+  BOOT_POLICY_OPEN_VOLUME_ROOT    OpenVolumeRoot;
+} APPLE_BOOT_POLICY_EX_PROTOCOL;
+
+// gAppleBootPolicyExProtocolGuid
+extern EFI_GUID gAppleBootPolicyExProtocolGuid;
+
+#endif // APPLE_BOOT_POLICY_EX_H_
@@ -0,0 +1,66 @@
+#ifndef APPLE_SMC_IO_EX_H_
+#define APPLE_SMC_IO_EX_H_
+
+#include <IndustryStandard/AppleSmc.h>
+
+// APPLE_SMC_IO_EX_PROTOCOL_GUID
+#define APPLE_SMC_IO_EX_PROTOCOL_GUID                     \
+  { 0x6FC037C7, 0x9F33, 0x4DFB,                           \
+    { 0x93, 0x15, 0xF4, 0x23, 0x03, 0x61, 0xBE, 0x3E } }
+
+// APPLE_SMC_IO_EX_PROTOCOL_REVISION
+#define APPLE_SMC_IO_EX_PROTOCOL_REVISION  0x00000001
+
+typedef struct APPLE_SMC_IO_EX_PROTOCOL APPLE_SMC_IO_EX_PROTOCOL;
+
+// APPLE_SMC_READ_REQUEST
+/// A key to read via ReadValues().  If Size is 0 on input, the size of the
+/// key is read and returned in Size, in which case Value must be able to
+/// hold SMC_MAX_DATA_SIZE bytes.  Otherwise Size must not be smaller than
+/// the size of the key, or Status is set to EFI_BUFFER_TOO_SMALL.
+typedef struct {
+  SMC_KEY       Key;
+  SMC_DATA_SIZE Size;
+  SMC_DATA      *Value;
+  EFI_STATUS    Status;
+} APPLE_SMC_READ_REQUEST;
+
+// SMC_IO_READ_VALUES
+/** Reads the values of multiple keys in one call.
+
+  The keys are resolved first.  Their values are then served from the cache
+  or read from the SMC in order while the SMC is locked once, so that other
+  callers cannot interleave with the batch.
+
+  @param[in]     This              The SMC I/O extension protocol.
+  @param[in]     NumberOfRequests  The number of entries in Requests.
+  @param[in,out] Requests          The keys to read.  The Status of each
+                                   request receives the result of reading it,
+                                   as returned by SmcReadValue().
+
+  @retval EFI_SUCCESS            All values have been read.
+  @retval EFI_NOT_READY          Some values could not be read, see the
+                                 Status of the requests.
+  @retval EFI_INVALID_PARAMETER  Requests is NULL or NumberOfRequests is 0.
+  @retval EFI_ACCESS_DENIED      The SMC is in use, no value of a present
+                                 hardware key has been read.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *SMC_IO_READ_VALUES)(
+  IN     APPLE_SMC_IO_EX_PROTOCOL  *This,
+  IN     UINTN                     NumberOfRequests,
+  IN OUT APPLE_SMC_READ_REQUEST    *Requests
+  );
+
+// APPLE_SMC_IO_EX_PROTOCOL
+/// Companion of APPLE_SMC_IO_PROTOCOL, installed on the same handle.
+struct APPLE_SMC_IO_EX_PROTOCOL {
+  UINTN              Revision;
+  SMC_IO_READ_VALUES ReadValues;
+};
+
+// gAppleSmcIoExProtocolGuid
+extern EFI_GUID gAppleSmcIoExProtocolGuid;
+
+#endif // APPLE_SMC_IO_EX_H_
@@ -6,20 +6,15 @@
 
 #include <Protocol/SimpleFileSystem.h>
 #include <Protocol/AppleBootPolicy.h>
+#include <Protocol/AppleBootPolicyEx.h>
 
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/MemoryAllocationLib.h>
-#include <Library/PrintLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
-typedef struct {
-  EFI_HANDLE             Handle;
-  GUID                   ContainerGuid;
-  GUID                   VolumeGuid;
-  APPLE_APFS_VOLUME_ROLE VolumeRole;
-} APFS_VOLUME_INFO;
+#include "AppleBootPolicyInternal.h"
 
 typedef struct {
   EFI_HANDLE        Handle;
@@ -27,6 +22,17 @@ typedef struct {
   EFI_FILE_PROTOCOL *Root;
 } APFS_VOLUME_ROOT;
 
+typedef struct {
+  EFI_GUID InformationType;
+  UINTN    Size;
+} FILE_INFO_SIZE_HINT;
+
+///
+/// The buffer sizes GetInfo() succeeded with per information type, unused
+/// entries have a Size of 0.
+///
+STATIC FILE_INFO_SIZE_HINT mFileInfoSizeHints[8];
+
 ///
 /// An array of file paths to search for in case no file is blessed.
 ///
@@ -92,6 +98,66 @@ STATIC APPLE_BOOT_POLICY_PROTOCOL mAppleBootPolicyProtocol = {
   BootPolicyGetApfsRecoveryVolumes
 };
 
+///
+/// The APPLE_BOOT_POLICY_EX_PROTOCOL instance to get installed.
+///
+STATIC APPLE_BOOT_POLICY_EX_PROTOCOL mAppleBootPolicyExProtocol = {
+  APPLE_BOOT_POLICY_EX_PROTOCOL_REVISION,
+  BootPolicyOpenVolumeCursor,
+  BootPolicyGetNextVolume,
+  BootPolicyCloseVolumeCursor,
+  BootPolicyGetVolumesByRole,
+  BootPolicyOpenVolumeRoot
+};
+
+/**
+  Opens a file for reading.
+
+  @param[in]  Root      The directory to open the file relative to.
+  @param[in]  FileName  The path of the file to open.
+  @param[out] File      Receives the opened file.
+
+  @return  The status of the Open() request is returned.
+
+**/
+STATIC
+EFI_STATUS
+InternalOpenFile (
+  IN  EFI_FILE_PROTOCOL  *Root,
+  IN  CONST CHAR16       *FileName,
+  OUT EFI_FILE_PROTOCOL  **File
+  )
+{
+  EFI_STATUS                Status;
+
+  BOOT_POLICY_TRACE_CONTEXT Trace;
+
+  BootPolicyCountOpen ();
+  BootPolicyTraceBegin (&Trace);
+
+  Status = Root->Open (
+                   Root,
+                   File,
+                   (CHAR16 *)FileName,
+                   EFI_FILE_MODE_READ,
+                   0
+                   );
+
+  BootPolicyTraceEnd (
+    &Trace,
+    AppleBootPolicyTraceOpen,
+    Root,
+    *File,
+    FileName,
+    NULL,
+    Status,
+    0,
+    NULL
+    );
+
+  return Status;
+}
+
 /**
   Checks whether the given file exists or not.
 
@@ -101,7 +167,6 @@ STATIC APPLE_BOOT_POLICY_PROTOCOL mAppleBootPolicyProtocol = {
   @return  Returned is whether the specified file exists or not.
 
 **/
-STATIC
 BOOLEAN
 InternalFileExists (
   IN EFI_FILE_HANDLE  Root,
@@ -113,13 +178,7 @@ InternalFileExists (
   EFI_STATUS      Status;
   EFI_FILE_HANDLE FileHandle;
 
-  Status = Root->Open (
-                   Root,
-                   &FileHandle,
-                   (CHAR16 *)FileName,
-                   EFI_FILE_MODE_READ,
-                   0
-                   );
+  Status = InternalOpenFile (Root, FileName, &FileHandle);
 
   if (!EFI_ERROR (Status)) {
     FileHandle->Close (FileHandle);
@@ -132,78 +191,179 @@ InternalFileExists (
   return Exists;
 }
 
+/**
+  Locates the first existing file of mBootPathNames.  Each candidate lives in
+  a different directory, so that a directory listing could not be shared and
+  every candidate is opened directly.
+
+  @param[in]  Directory      The directory the boot paths are relative to.
+  @param[out] BootPathIndex  Receives the index of the matching entry of
+                             mBootPathNames.
+
+  @retval EFI_SUCCESS    A boot file has been found.
+  @retval EFI_NOT_FOUND  None of the boot files exist.
+
+**/
 STATIC
 EFI_STATUS
-InternalGetBlessedSystemFilePath (
-  IN  EFI_FILE_PROTOCOL               *Root,
-  OUT CONST EFI_DEVICE_PATH_PROTOCOL  **FilePath
+InternalFindBootPathName (
+  IN  EFI_FILE_PROTOCOL  *Directory,
+  OUT UINTN              *BootPathIndex
   )
 {
-  EFI_STATUS       Status;
+  UINTN        Index;
+  CONST CHAR16 *FilePathName;
 
-  UINTN            Size;
-  EFI_DEV_PATH_PTR DevPath;
-  
-  Size   = 0;
-  Status = Root->GetInfo (
-                   Root,
-                   &gAppleBlessedSystemFileInfoGuid,
-                   &Size,
-                   NULL
-                   );
+  for (Index = 0; Index < ARRAY_SIZE (mBootPathNames); ++Index) {
+    FilePathName = mBootPathNames[Index];
 
-  if (Status == EFI_BUFFER_TOO_SMALL) {
-    DevPath.FilePath = AllocateZeroPool (Size);
+    if (InternalFileExists (
+          Directory,
+          (FilePathName[0] == L'\\') ? &FilePathName[1] : &FilePathName[0]
+          )) {
+      *BootPathIndex = Index;
 
-    Status = EFI_OUT_OF_RESOURCES;
+      return EFI_SUCCESS;
+    }
+  }
 
-    if (DevPath.FilePath != NULL) {
-      Status = Root->GetInfo (
-                       Root,
-                       &gAppleBlessedSystemFileInfoGuid,
-                       &Size,
-                       DevPath.FilePath
-                       );
+  return EFI_NOT_FOUND;
+}
 
-      if (!EFI_ERROR (Status)) {
-        *FilePath = DuplicateDevicePath (DevPath.DevPath);
-      }
+/**
+  Locates the boot file blessed on a volume.  The blessing is queried once
+  per volume and shared by all GetBootFile*() variants.
 
-      gBS->FreePool ((VOID *)DevPath.DevPath);
-    }
-  } else {
+  @param[in]  Device    The handle of the volume.
+  @param[in]  Root      The opened root of the volume.
+  @param[out] FilePath  Receives the device path of the blessed boot file.
+                        The caller is responsible for freeing it.
+
+  @retval EFI_SUCCESS           The blessed boot file has been returned.
+  @retval EFI_NOT_FOUND         The volume has no blessed boot file.
+  @retval EFI_OUT_OF_RESOURCES  The device path could not be allocated.
+
+**/
+STATIC
+EFI_STATUS
+InternalGetBlessedBootFile (
+  IN  EFI_HANDLE                Device,
+  IN  EFI_FILE_PROTOCOL         *Root,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **FilePath
+  )
+{
+  EFI_STATUS Status;
+
+  Status = BootPolicyGetBlessedInfo (Device, Root, FilePath, NULL);
+
+  if (!EFI_ERROR (Status) && (*FilePath == NULL)) {
     Status = EFI_NOT_FOUND;
   }
 
   return Status;
 }
 
+/**
+  Retrieves the size hint of an information type.  The hint is the largest
+  size the type has been returned with so far.
+
+  @param[in] InformationType  The type identifier of the information.
+
+  @return  Returned is the hint, or NULL if the table is exhausted.
+
+**/
 STATIC
+UINTN *
+InternalGetFileInfoSizeHint (
+  IN CONST EFI_GUID  *InformationType
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mFileInfoSizeHints); ++Index) {
+    if (mFileInfoSizeHints[Index].Size == 0) {
+      CopyGuid (&mFileInfoSizeHints[Index].InformationType, InformationType);
+
+      return &mFileInfoSizeHints[Index].Size;
+    }
+
+    if (CompareGuid (
+          &mFileInfoSizeHints[Index].InformationType,
+          InformationType
+          )) {
+      return &mFileInfoSizeHints[Index].Size;
+    }
+  }
+
+  return NULL;
+}
+
 VOID *
 InternalGetFileInfo (
   IN EFI_FILE_PROTOCOL  *Root,
   IN EFI_GUID           *InformationType
   )
 {
-  VOID       *FileInfoBuffer;
+  VOID                      *FileInfoBuffer;
 
-  UINTN      FileInfoSize;
-  EFI_STATUS Status;
+  UINTN                     *SizeHint;
+  UINTN                     FileInfoSize;
+  EFI_STATUS                Status;
+  BOOT_POLICY_TRACE_CONTEXT Trace;
 
   FileInfoSize   = 0;
   FileInfoBuffer = NULL;
+  SizeHint       = InternalGetFileInfoSizeHint (InformationType);
+
+  //
+  // Query with a buffer of the hinted size so that usually a single call is
+  // needed.  The size is probed only for unknown information types or if the
+  // hint is too small.
+  //
+  if ((SizeHint != NULL) && (*SizeHint > 0)) {
+    FileInfoSize   = *SizeHint;
+    FileInfoBuffer = AllocateZeroPool (FileInfoSize);
+
+    if (FileInfoBuffer == NULL) {
+      return NULL;
+    }
+  }
+
+  BootPolicyCountGetInfo ();
+  BootPolicyTraceBegin (&Trace);
 
   Status = Root->GetInfo (
                    Root,
                    InformationType,
                    &FileInfoSize,
-                   NULL
+                   FileInfoBuffer
                    );
 
+  BootPolicyTraceEnd (
+    &Trace,
+    AppleBootPolicyTraceGetInfo,
+    Root,
+    NULL,
+    NULL,
+    InformationType,
+    Status,
+    FileInfoSize,
+    FileInfoBuffer
+    );
+
   if (Status == EFI_BUFFER_TOO_SMALL) {
+    if (FileInfoBuffer != NULL) {
+      FreePool (FileInfoBuffer);
+    }
+
     FileInfoBuffer = AllocateZeroPool (FileInfoSize);
 
+    Status = EFI_OUT_OF_RESOURCES;
+
     if (FileInfoBuffer != NULL) {
+      BootPolicyCountGetInfo ();
+      BootPolicyTraceBegin (&Trace);
+
       Status = Root->GetInfo (
                        Root,
                        InformationType,
@@ -211,65 +371,31 @@ InternalGetFileInfo (
                        FileInfoBuffer
                        );
 
-      if (EFI_ERROR (Status)) {
-        FreePool (FileInfoBuffer);
-
-        FileInfoBuffer = NULL;
-      }
+      BootPolicyTraceEnd (
+        &Trace,
+        AppleBootPolicyTraceGetInfo,
+        Root,
+        NULL,
+        NULL,
+        InformationType,
+        Status,
+        FileInfoSize,
+        FileInfoBuffer
+        );
     }
   }
 
-  return FileInfoBuffer;
-}
-
-// BUG: Memory leak. PathName is never used or deallocated.
-STATIC
-EFI_STATUS
-InternalGetFilePathName (
-  IN EFI_FILE_PROTOCOL  *Root
-  )
-{
-  EFI_STATUS           Status;
-
-  CONST VOID           *DevicePath;
-  CONST VOID           *DevicePathWalker;
-  FILEPATH_DEVICE_PATH *FilePath;
-  UINTN                PathNameSize;
-  CHAR16               *PathName;
-
-  Status = EFI_NOT_FOUND;
-
-  DevicePath = InternalGetFileInfo (
-                 Root,
-                 &gAppleBlessedSystemFolderInfoGuid
-                 );
-
-  if (DevicePath != NULL) {
-    DevicePathWalker = DevicePath;
-
-    while (!IsDevicePathEnd (DevicePathWalker)) {
-      if ((DevicePathType (DevicePathWalker) == MEDIA_DEVICE_PATH)
-       && (DevicePathSubType (DevicePathWalker) == MEDIA_FILEPATH_DP)) {
-        FilePath     = (FILEPATH_DEVICE_PATH *)DevicePathWalker;
-        PathNameSize = StrSize (&FilePath->PathName[0]);
-        PathName     = AllocatePool (PathNameSize);
-
-        if (PathName != NULL) {
-          StrCpy (PathName, &FilePath->PathName[0]);
-        } else {
-          Status = EFI_OUT_OF_RESOURCES;
-        }
-
-        break;
-      }
-
-      DevicePathWalker = NextDevicePathNode (DevicePathWalker);
+  if (!EFI_ERROR (Status)) {
+    if ((SizeHint != NULL) && (FileInfoSize > *SizeHint)) {
+      *SizeHint = FileInfoSize;
     }
+  } else if (FileInfoBuffer != NULL) {
+    FreePool (FileInfoBuffer);
 
-    gBS->FreePool ((VOID *)DevicePath);
+    FileInfoBuffer = NULL;
   }
 
-  return Status;
+  return FileInfoBuffer;
 }
 
 STATIC
@@ -280,296 +406,158 @@ InternalAppendBootPathName (
   OUT CONST EFI_DEVICE_PATH_PROTOCOL  **DevicePath
   )
 {
-  EFI_STATUS   Status;
+  EFI_STATUS Status;
 
-  UINTN        Index;
-  CONST CHAR16 *PathName;
+  GUID       VolumeKey;
+  BOOLEAN    Cacheable;
+  UINTN      CachedIndex;
+  UINTN      Index;
 
-  Status = EFI_NOT_FOUND;
+  Status    = BootPolicyGetBootFileCacheKey (Device, Root, &VolumeKey);
+  Cacheable = (BOOLEAN)!EFI_ERROR (Status);
 
-  for (Index = 0; Index < ARRAY_SIZE (mBootPathNames); ++Index) {
-    PathName = mBootPathNames[Index];
+  CachedIndex = ARRAY_SIZE (mBootPathNames);
 
-    if (InternalFileExists (Root, PathName)) {
-      *DevicePath = FileDevicePath (Device, PathName);
+  if (Cacheable) {
+    BootPolicyGetCachedBootPathIndex (&VolumeKey, &CachedIndex);
+  }
 
-      Status = EFI_SUCCESS;
+  //
+  // A cached boot file is only valid while no file of higher priority exists,
+  // hence the candidates before it are probed as well.  This is the search in
+  // priority order, which costs a single Open() when the cached file is the
+  // first candidate.  The cache is only written when the result differs.
+  //
+  Status = InternalFindBootPathName (Root, &Index);
 
-      break;
+  if (!EFI_ERROR (Status)) {
+    *DevicePath = FileDevicePath (Device, mBootPathNames[Index]);
+
+    if (Cacheable && (Index != CachedIndex)) {
+      BootPolicyUpdateBootFileCache (&VolumeKey, Index);
     }
   }
 
   return Status;
 }
 
-STATIC
-EFI_STATUS
-InternalGetApfsVolumeInfo (
-  IN  EFI_HANDLE              Device,
-  OUT EFI_GUID                *ContainerGuid,
-  OUT EFI_GUID                *VolumeGuid,
-  OUT APPLE_APFS_VOLUME_ROLE  *VolumeRole
-)
-{
-  EFI_STATUS                      Status;
+/**
+  Locates the boot files of the volumes of an APFS container.  Each volume
+  may provide its boot file within the "\\<VolumeUUID>" directory of the
+  preboot volume.
 
-  EFI_FILE_PROTOCOL               *Root;
-  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *FileSystem;
-  APPLE_APFS_CONTAINER_INFO       *ApfsContainerInfo;
-  APPLE_APFS_VOLUME_INFO          *ApfsVolumeInfo;
+  @param[in]      Device         The handle of the preboot volume.
+  @param[in]      Root           The opened root of the preboot volume.
+  @param[in]      ContainerUuid  The UUID of the APFS container.
+  @param[in, out] Builder        The builder to append the boot files to.
 
-  Root = NULL;
+  @retval EFI_SUCCESS           At least one boot file has been appended.
+  @retval EFI_NOT_FOUND         No boot file has been found.
+  @retval EFI_OUT_OF_RESOURCES  The device path could not be assembled.
 
-  Status = gBS->HandleProtocol (
-                  Device,
-                  &gEfiSimpleFileSystemProtocolGuid,
-                  (VOID **)&FileSystem
-                  );
+**/
+STATIC
+EFI_STATUS
+InternalGetApfsBootFile (
+  IN     EFI_HANDLE                       Device,
+  IN     EFI_FILE_PROTOCOL                *Root,
+  IN     CONST GUID                       *ContainerUuid,
+  IN OUT BOOT_POLICY_DEVICE_PATH_BUILDER  *Builder
+  )
+{
+  EFI_STATUS             Status;
+
+  CONST APFS_VOLUME_INFO *Volumes;
+  UINTN                  NumberOfVolumes;
+  UINTN                  Index;
+  CHAR16                 DirPathName[APPLE_BOOT_POLICY_GUID_STRING_LENGTH + 1];
+  EFI_FILE_PROTOCOL      *NewHandle;
+  EFI_FILE_INFO          *VolumeDirectoryInfo;
+  UINTN                  BootPathIndex;
+  EFI_STATUS             Status2;
+
+  Status = BootPolicyGetApfsContainerVolumes (
+             ContainerUuid,
+             &Volumes,
+             &NumberOfVolumes
+             );
 
   if (!EFI_ERROR (Status)) {
-    Status = FileSystem->OpenVolume (FileSystem, &Root);
-
-    if (!EFI_ERROR (Status)) {
-      Status = EFI_NOT_FOUND;
+    Status = EFI_NOT_FOUND;
 
-      ApfsContainerInfo = InternalGetFileInfo (
-                            Root,
-                            &gAppleApfsContainerInfoGuid
-                            );
+    for (Index = 0; Index < NumberOfVolumes; ++Index) {
+      BootPolicyGuidToStr (&Volumes[Index].VolumeGuid, &DirPathName[0]);
 
-      if (ApfsContainerInfo != NULL) {
-        CopyGuid (
-          ContainerGuid,
-          &ApfsContainerInfo->Uuid
-          );
+      Status2 = InternalOpenFile (Root, &DirPathName[0], &NewHandle);
 
-        FreePool ((VOID *)ApfsContainerInfo);
-        
-        Status = EFI_SUCCESS;
+      if (EFI_ERROR (Status2)) {
+        continue;
       }
 
-      ApfsVolumeInfo = InternalGetFileInfo (Root, &gAppleApfsVolumeInfoGuid);
+      VolumeDirectoryInfo = InternalGetFileInfo (NewHandle, &gEfiFileInfoGuid);
 
-      if (ApfsVolumeInfo != NULL) {
-        CopyGuid (
-          VolumeGuid,
-          &ApfsVolumeInfo->Uuid
-          );
+      if (VolumeDirectoryInfo != NULL) {
+        if ((VolumeDirectoryInfo->Attribute & EFI_FILE_DIRECTORY) != 0) {
+          Status2 = InternalFindBootPathName (NewHandle, &BootPathIndex);
+
+          if (!EFI_ERROR (Status2)) {
+            Status2 = BootPolicyAppendFilePathInstance (
+                        Builder,
+                        Device,
+                        &DirPathName[0],
+                        mBootPathNames[BootPathIndex]
+                        );
 
-        *VolumeRole = ApfsVolumeInfo->Role;
+            if (!EFI_ERROR (Status2)) {
+              Status = EFI_SUCCESS;
+            } else if (Status2 == EFI_OUT_OF_RESOURCES) {
+              Status = Status2;
+            }
+          }
+        }
 
-        FreePool ((VOID *)ApfsVolumeInfo);
+        FreePool ((VOID *)VolumeDirectoryInfo);
       }
 
-      Root->Close (Root);
+      NewHandle->Close (NewHandle);
+
+      if (Status == EFI_OUT_OF_RESOURCES) {
+        break;
+      }
     }
   }
 
   return Status;
 }
 
+/**
+  Locates the bootable file of an opened volume, see BootPolicyGetBootFile().
+
+  @param[in]      Device    The handle of the volume.
+  @param[in]      Root      The opened root of the volume.
+  @param[out]     FilePath  Receives the device path of the boot file.
+
+  @return  The status of the operation is returned.
+
+**/
 STATIC
 EFI_STATUS
-InternalGetApfsBootFile (
-  IN  EFI_HANDLE                      Device,
-  IN  EFI_FILE_PROTOCOL               *Root,
-  IN  CONST GUID                      *ContainerUuid,
-  IN  CONST CHAR16                    *VolumeUuid,
-  OUT CONST EFI_DEVICE_PATH_PROTOCOL  **DevicePath,
-  OUT EFI_HANDLE                      *VolumeHandle
+InternalGetBootFile (
+  IN     EFI_HANDLE                Device,
+  IN     EFI_FILE_PROTOCOL         *Root,
+  OUT    EFI_DEVICE_PATH_PROTOCOL  **FilePath
   )
 {
-  EFI_STATUS                      Status;
-
-  UINTN                           NumberOfHandles;
-  EFI_HANDLE                      *HandleBuffer;
-  UINTN                           Index;
-  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *FileSystem;
-  EFI_FILE_PROTOCOL               *HandleRoot;
-  APPLE_APFS_CONTAINER_INFO       *ContainerInfo;
-  BOOLEAN                         Equal;
-  APPLE_APFS_VOLUME_INFO          *VolumeInfo;
-  CHAR16                          DirPathNameBuffer[38];
-  EFI_FILE_PROTOCOL               *NewHandle;
-  EFI_FILE_INFO                   *VolumeDirectoryInfo;
-  CONST EFI_DEVICE_PATH_PROTOCOL  *FilePath;
-  CONST CHAR16                    *FilePathName;
-  UINTN                           GuidPathNameSize;
-  BOOLEAN                         DirectoryExists;
-  UINTN                           BootFileNameSize;
-  CHAR16                          *FullPathName;
-  UINTN                           DevPathSize;
-  EFI_DEVICE_PATH_PROTOCOL        *DevPath;
-  EFI_DEVICE_PATH_PROTOCOL        *DevPathWalker;
-  INTN                            Result;
-
-  Status =  gBS->LocateHandleBuffer (
-                   ByProtocol,
-                   &gEfiSimpleFileSystemProtocolGuid,
-                   NULL,
-                   &NumberOfHandles,
-                   &HandleBuffer
-                   );
-
-  if (!EFI_ERROR (Status)) {
-    Status = EFI_NOT_FOUND;
-
-    for (Index = 0; Index < NumberOfHandles; ++Index) {
-      Status = gBS->HandleProtocol (
-                      HandleBuffer[Index],
-                      &gEfiSimpleFileSystemProtocolGuid,
-                      (VOID **)&FileSystem
-                      );
-
-      if (!EFI_ERROR (Status)) {
-        Status = FileSystem->OpenVolume (FileSystem, &HandleRoot);
-
-        if (!EFI_ERROR (Status)) {
-          ContainerInfo = InternalGetFileInfo (
-                            HandleRoot,
-                            &gAppleApfsContainerInfoGuid
-                            );
-
-          if (ContainerInfo != NULL) {
-            Equal = CompareGuid (&ContainerInfo->Uuid, ContainerUuid);
-
-            if (Equal) {
-              VolumeInfo = InternalGetFileInfo (
-                              HandleRoot,
-                              &gAppleApfsVolumeInfoGuid
-                              );
-
-              if (VolumeInfo != NULL) {
-                UnicodeSPrint (
-                  &DirPathNameBuffer[0],
-                  sizeof (DirPathNameBuffer),
-                  L"%g", 
-                  &VolumeInfo->Uuid
-                  );
-
-                if ((VolumeUuid != NULL)
-                 && StrStr (VolumeUuid, &DirPathNameBuffer[0]) != NULL) {
-                  *VolumeHandle = HandleBuffer[Index];
-                }
-
-                // BUG: NewHandle is not closed.
-                Status = Root->Open (
-                                 Root,
-                                 &NewHandle,
-                                 &DirPathNameBuffer[0],
-                                 EFI_FILE_MODE_READ,
-                                 0
-                                 );
-
-                if (!EFI_ERROR (Status)) {
-                  VolumeDirectoryInfo = InternalGetFileInfo (
-                                          NewHandle,
-                                          &gEfiFileInfoGuid
-                                          );
-
-                  if (VolumeDirectoryInfo != NULL) {
-                    if ((VolumeDirectoryInfo->Attribute & EFI_FILE_DIRECTORY) != 0) {
-                      Status = EFI_NOT_FOUND;
-                        
-                      for (Index = 0; Index < ARRAY_SIZE (mBootPathNames); ++Index) {
-                        FilePathName = mBootPathNames[Index];
-
-                        DirectoryExists = InternalFileExists (
-                                            NewHandle,
-                                            (FilePathName[0] == L'\\')
-                                              ? &FilePathName[1]
-                                              : &FilePathName[0]
-                                            );
-
-                        if (DirectoryExists) {
-                          GuidPathNameSize = (StrSize (&DirPathNameBuffer[0]) + 1);
-                          BootFileNameSize = StrSize (FilePathName);
-
-                          FullPathName = AllocateZeroPool (
-                                           GuidPathNameSize + BootFileNameSize
-                                           );
-
-                          if (FullPathName != NULL) {
-                            //
-                            // BUG: FullPathName[0] cannot be \0 for just
-                            //      having been allocated.  Likely this is
-                            //      supposed to be checking DirPathNameBuffer
-                            //      for the case it's not starting with '\'.
-                            //
-                            if (FullPathName[0] != L'\\') {
-                              StrCpy (FullPathName, L"\\");
-                            }
-
-                            StrCat (FullPathName, &DirPathNameBuffer[0]);
-                            StrCat (FullPathName, FilePathName);
-
-                            FilePath = FileDevicePath (Device, FullPathName);
-
-                            FreePool ((VOID *)FullPathName);
-
-                            if (FilePath != NULL) {
-                              Status = EFI_SUCCESS;
-
-                              DevPathSize = GetDevicePathSize (FilePath);
-                              DevPath = (EFI_DEVICE_PATH_PROTOCOL *)*DevicePath;
-
-                              do {
-                                DevPathWalker = GetNextDevicePathInstance (
-                                                  &DevPath,
-                                                  &DevPathSize
-                                                  );
-
-                                if (DevPathWalker == NULL) {
-                                  *DevicePath = AppendDevicePath (
-                                                  *DevicePath,
-                                                  FilePath
-                                                  );
-
-                                  break;
-                                }
-
-                                if ((DevPathSize == 0)
-                                 || (DevPathWalker == FilePath)) {
-                                  FreePool ((VOID *)DevPathWalker);
-
-                                  break;
-                                }
-
-                                Result = CompareMem (
-                                            (VOID *)DevPathWalker,
-                                            (VOID *)FilePath,
-                                            DevPathSize
-                                            );
-
-                                FreePool ((VOID *)DevPathWalker);
-                              } while (Result != 0);
-                            }
-                          }
-
-                          break;
-                        }
-                      }
-                    }
-
-                    FreePool ((VOID *)VolumeDirectoryInfo);
-                  }
-                }
-              }
-
-              if (VolumeInfo != NULL) {
-                FreePool ((VOID *)VolumeInfo);
-              }
-            }
-
-            FreePool ((VOID *)ContainerInfo);
-          }
+  EFI_STATUS Status;
 
-          HandleRoot->Close (HandleRoot);
-        }
-      }
-    }
+  //
+  // The blessing takes precedence over the cached fallback search, so that a
+  // blessed file is returned even while a fallback candidate exists.
+  //
+  Status = InternalGetBlessedBootFile (Device, Root, FilePath);
 
-    FreePool ((VOID *)HandleBuffer);
+  if (EFI_ERROR (Status)) {
+    Status = InternalAppendBootPathName (Device, Root, FilePath);
   }
 
   return Status;
@@ -609,8 +597,13 @@ BootPolicyGetBootFile (
 
   EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *FileSystem;
   EFI_FILE_PROTOCOL               *Root;
+  BOOT_POLICY_TRACE_CONTEXT       Trace;
+  BOOT_POLICY_STATISTICS_CONTEXT  StatisticsContext;
 
-  Root = NULL;
+  BootPolicyStatisticsEnter (
+    AppleBootPolicyFunctionGetBootFile,
+    &StatisticsContext
+    );
 
   Status = gBS->HandleProtocol (
                   Device,
@@ -619,26 +612,31 @@ BootPolicyGetBootFile (
                   );
 
   if (!EFI_ERROR (Status)) {
-    Status = FileSystem->OpenVolume (FileSystem, &Root);
+    BootPolicyCountOpen ();
+    BootPolicyTraceBegin (&Trace);
 
-    if (!EFI_ERROR (Status)) {
-      Status = InternalGetBlessedSystemFilePath (Root, FilePath);
+    Status = FileSystem->OpenVolume (FileSystem, &Root);
 
-      if (EFI_ERROR (Status)) {
-        Status = InternalGetFilePathName (Root);
+    BootPolicyTraceEnd (
+      &Trace,
+      AppleBootPolicyTraceOpenVolume,
+      Device,
+      Root,
+      NULL,
+      NULL,
+      Status,
+      0,
+      NULL
+      );
 
-        if (EFI_ERROR (Status)) {
-          Status = InternalAppendBootPathName (Device, Root, FilePath);
-        }
-      }
+    if (!EFI_ERROR (Status)) {
+      Status = InternalGetBootFile (Device, Root, FilePath);
 
-      // BUG: Root should be closed here, it cannot be open before.
+      Root->Close (Root);
     }
   }
 
-  if (Root != NULL) {
-    Root->Close (Root);
-  }
+  BootPolicyStatisticsExit (&StatisticsContext);
 
   return Status;
 }
@@ -658,6 +656,23 @@ BootPolicyGetBootFileEx (
   APPLE_APFS_CONTAINER_INFO       *ContainerInfo;
   APPLE_APFS_VOLUME_INFO          *VolumeInfo;
   EFI_STATUS                      Status2;
+  EFI_DEVICE_PATH_PROTOCOL        *BlessedFilePath;
+  BOOT_POLICY_DEVICE_PATH_BUILDER Builder;
+  UINT8                           DevicePathBuffer[BOOT_POLICY_DEVICE_PATH_SCRATCH_SIZE];
+
+  BOOT_POLICY_TRACE_CONTEXT       Trace;
+  BOOT_POLICY_STATISTICS_CONTEXT  StatisticsContext;
+
+  BootPolicyStatisticsEnter (
+    AppleBootPolicyFunctionGetBootFileEx,
+    &StatisticsContext
+    );
+
+  Status = BootPolicyLookupBootFileResult (Device, Mode, FilePath);
+
+  if (!EFI_ERROR (Status)) {
+    goto Done;
+  }
 
   *FilePath = NULL;
 
@@ -668,8 +683,23 @@ BootPolicyGetBootFileEx (
                   );
 
   if (!EFI_ERROR (Status)) {
+    BootPolicyCountOpen ();
+    BootPolicyTraceBegin (&Trace);
+
     Status = FileSystem->OpenVolume (FileSystem, &Root);
 
+    BootPolicyTraceEnd (
+      &Trace,
+      AppleBootPolicyTraceOpenVolume,
+      Device,
+      Root,
+      NULL,
+      NULL,
+      Status,
+      0,
+      NULL
+      );
+
     if (!EFI_ERROR (Status)) {
       VolumeInfo = InternalGetFileInfo (Root, &gAppleApfsVolumeInfoGuid);
 
@@ -680,85 +710,167 @@ BootPolicyGetBootFileEx (
           Status = EFI_NOT_FOUND;
 
           if ((VolumeInfo->Role & APPLE_APFS_VOLUME_ROLE_PREBOOT) != 0) {
-            Status2 = InternalGetBlessedSystemFilePath (Root, FilePath);
+            BootPolicyInitDevicePathBuilder (
+              &Builder,
+              &DevicePathBuffer[0],
+              sizeof (DevicePathBuffer)
+              );
+
+            Status2 = InternalGetBlessedBootFile (
+                        Device,
+                        Root,
+                        &BlessedFilePath
+                        );
+
+            if (!EFI_ERROR (Status2)) {
+              Status2 = BootPolicyAppendDevicePathInstances (
+                          &Builder,
+                          BlessedFilePath
+                          );
 
-            if (EFI_ERROR (Status2)) {
-              Status2 = InternalGetFilePathName (Root);
+              FreePool ((VOID *)BlessedFilePath);
             }
 
             Status = InternalGetApfsBootFile (
                        Device,
                        Root,
                        &ContainerInfo->Uuid,
-                       NULL,
-                       FilePath,
-                       NULL
+                       &Builder
                        );
 
             if (!EFI_ERROR (Status2)) {
               Status = Status2;
             }
+
+            Status2 = BootPolicyFinishDevicePathBuilder (&Builder, FilePath);
+
+            if (!EFI_ERROR (Status)) {
+              Status = Status2;
+            } else if (*FilePath != NULL) {
+              FreePool ((VOID *)*FilePath);
+
+              *FilePath = NULL;
+            }
           }
 
           FreePool ((VOID *)ContainerInfo);
         }
 
         FreePool ((VOID *)VolumeInfo);
-
-        Root->Close (Root);
       } else {
-        // BUG: Root should be closed here too.
-
-        Status = BootPolicyGetBootFile (Device, FilePath);
+        Status = InternalGetBootFile (Device, Root, FilePath);
       }
+
+      Root->Close (Root);
     }
   }
 
+  if (!EFI_ERROR (Status)) {
+    BootPolicyStoreBootFileResult (Device, Mode, *FilePath);
+  }
+
+Done:
+  BootPolicyStatisticsExit (&StatisticsContext);
+
   return Status;
 }
 
+/**
+  Locates the APFS volume with the given UUID within the container of Device.
+  Only the volume cache is consulted.
+
+  @param[in]  Device                    The handle of the preboot volume.
+  @param[in]  VolumeGuid                The UUID of the volume to locate.
+  @param[out] ContainerVolumes          Receives the cached volumes of the
+                                        container.
+  @param[out] NumberOfContainerVolumes  Receives the number of entries in
+                                        ContainerVolumes.
+  @param[out] Volume                    Receives the matching volume.
+
+  @retval EFI_SUCCESS    The volume has been found.
+  @retval EFI_NOT_FOUND  Device is no APFS volume or VolumeGuid refers to no
+                         volume of its container.
+
+**/
 STATIC
-BOOLEAN
-IsValidGuidString (
-  IN CONST CHAR16  *String
+EFI_STATUS
+InternalFindApfsVolume (
+  IN  EFI_HANDLE              Device,
+  IN  CONST EFI_GUID          *VolumeGuid,
+  OUT CONST APFS_VOLUME_INFO  **ContainerVolumes,
+  OUT UINTN                   *NumberOfContainerVolumes,
+  OUT CONST APFS_VOLUME_INFO  **Volume
   )
 {
-  UINTN Length;
-  UINTN Index;
+  EFI_STATUS             Status;
+
+  GUID                   ContainerGuid;
+  GUID                   DeviceVolumeGuid;
+  APPLE_APFS_VOLUME_ROLE VolumeRole;
+  CONST APFS_VOLUME_INFO *Volumes;
+  UINTN                  NumberOfVolumes;
+  UINTN                  Index;
 
-  Length = StrLen (String);
+  Status = BootPolicyGetApfsVolumeInfo (
+             Device,
+             &ContainerGuid,
+             &DeviceVolumeGuid,
+             &VolumeRole
+             );
 
-  if (Length >= 36) {
-    for (Index = 0; Index < 36; ++Index) {
-      if (
-        ((Index == 8) || (Index == 12) || (Index == 16) || (Index == 20))
-        ) {
-        if (String[Index] != '-') {
-          return FALSE;
-        }
-      }
-      else {
-        if (!((String[Index] >= L'0') && (String[Index] <= L'9'))
-          && !((String[Index] >= L'A') && (String[Index] <= L'F'))
-          ) {
-          return FALSE;
+  if (!EFI_ERROR (Status)) {
+    Status = BootPolicyGetApfsContainerVolumes (
+               &ContainerGuid,
+               &Volumes,
+               &NumberOfVolumes
+               );
+
+    if (!EFI_ERROR (Status)) {
+      Status = EFI_NOT_FOUND;
+
+      for (Index = 0; Index < NumberOfVolumes; ++Index) {
+        if (CompareGuid (&Volumes[Index].VolumeGuid, VolumeGuid)) {
+          *ContainerVolumes         = Volumes;
+          *NumberOfContainerVolumes = NumberOfVolumes;
+          *Volume                   = &Volumes[Index];
+
+          Status = EFI_SUCCESS;
+
+          break;
         }
       }
     }
-
-    return TRUE;
   }
 
-  return FALSE;
+  return Status;
 }
 
+/**
+  Retrieves the volume and path name a boot device path refers to, see
+  BootPolicyGetBootInfo().
+
+  @param[in]  DevicePath                The boot device path.
+  @param[out] BootPathName              Receives the directory path name.
+  @param[out] Device                    Receives the handle of the volume.
+  @param[out] ContainerVolumes          Receives the cached volumes of the
+                                        APFS container if Volume is found.
+  @param[out] NumberOfContainerVolumes  Receives the number of entries in
+                                        ContainerVolumes.
+  @param[out] Volume                    Receives the cached APFS volume the
+                                        path name refers to, or NULL.
+
+  @return  The status of the operation is returned.
+
+**/
+STATIC
 EFI_STATUS
-EFIAPI
-BootPolicyGetBootInfo (
+InternalGetBootInfo (
   IN  EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
   OUT CHAR16                    **BootPathName,
   OUT EFI_HANDLE                *Device,
-  OUT EFI_HANDLE                *ApfsVolumeHandle
+  OUT CONST APFS_VOLUME_INFO    **ContainerVolumes,
+  OUT UINTN                     *NumberOfContainerVolumes,
+  OUT CONST APFS_VOLUME_INFO    **Volume
   )
 {
   EFI_STATUS                      Status;
@@ -770,14 +882,11 @@ BootPolicyGetBootInfo (
   CHAR16                          *Slash;
   UINTN                           Len;
   CHAR16                          *FilePathName;
-  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *FileSystem;
-  EFI_FILE_PROTOCOL               *Root;
-  APPLE_APFS_CONTAINER_INFO       *ContainerInfo;
-  CONST EFI_DEVICE_PATH_PROTOCOL  *BootDevicePath;
+  EFI_GUID                        VolumeGuid;
 
   *BootPathName = NULL;
   *Device       = NULL;
-  *ApfsVolumeHandle = NULL;
+  *Volume       = NULL;
 
   Status = gBS->LocateDevicePath (
                   &gEfiSimpleFileSystemProtocolGuid,
@@ -823,7 +932,7 @@ BootPolicyGetBootInfo (
           StrCpy (PathName, L"\\");
         }
       } else {
-        return EFI_OUT_OF_RESOURCES;
+        goto Done;
       }
     } else {
       // BUG: + 1 is unnecessary.
@@ -842,48 +951,87 @@ BootPolicyGetBootInfo (
 
     // This cannot be FALSE.
     if (FilePathName != NULL) {
-      if (IsValidGuidString (FilePathName)) {
-        Status = gBS->HandleProtocol (
-                        DeviceHandle,
-                        &gEfiSimpleFileSystemProtocolGuid,
-                        (VOID **)&FileSystem
-                        );
-
-        if (!EFI_ERROR (Status)) {
-          Status = FileSystem->OpenVolume (FileSystem, &Root);
-
-          if (!EFI_ERROR (Status)) {
-            ContainerInfo = InternalGetFileInfo (
-                              Root,
-                              &gAppleApfsContainerInfoGuid
-                              );
-
-            if (ContainerInfo != NULL) {
-              BootDevicePath = NULL;
-
-              InternalGetApfsBootFile (
-                DeviceHandle,
-                Root,
-                &ContainerInfo->Uuid,
-                FilePathName,
-                &BootDevicePath,
-                ApfsVolumeHandle
-                );
-
-              if (BootDevicePath != NULL) {
-                FreePool ((VOID *)BootDevicePath);
-              }
-
-              FreePool ((VOID *)ContainerInfo);
-            }
-          }
-        }
+      //
+      // Only a path name starting with a volume UUID component refers to an
+      // APFS volume.
+      //
+      if (!EFI_ERROR (BootPolicyStrToGuid (FilePathName, &VolumeGuid))
+       && ((FilePathName[APPLE_BOOT_POLICY_GUID_STRING_LENGTH] == L'\\')
+        || (FilePathName[APPLE_BOOT_POLICY_GUID_STRING_LENGTH] == L'\0'))) {
+        InternalFindApfsVolume (
+          DeviceHandle,
+          &VolumeGuid,
+          ContainerVolumes,
+          NumberOfContainerVolumes,
+          Volume
+          );
       }
     }
 
     *BootPathName = PathName;
   }
 
+Done:
+  return Status;
+}
+
+EFI_STATUS
+EFIAPI
+BootPolicyGetBootInfo (
+  IN  EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  OUT CHAR16                    **BootPathName,
+  OUT EFI_HANDLE                *Device,
+  OUT EFI_HANDLE                *ApfsVolumeHandle
+  )
+{
+  EFI_STATUS                     Status;
+
+  CONST APFS_VOLUME_INFO         *ContainerVolumes;
+  UINTN                          NumberOfContainerVolumes;
+  CONST APFS_VOLUME_INFO         *Volume;
+
+  BOOT_POLICY_STATISTICS_CONTEXT StatisticsContext;
+
+  BootPolicyStatisticsEnter (
+    AppleBootPolicyFunctionGetBootInfo,
+    &StatisticsContext
+    );
+
+  *ApfsVolumeHandle = NULL;
+
+  Status = BootPolicyLookupBootInfoResult (
+             DevicePath,
+             BootPathName,
+             Device,
+             ApfsVolumeHandle
+             );
+
+  if (EFI_ERROR (Status)) {
+    Status = InternalGetBootInfo (
+               DevicePath,
+               BootPathName,
+               Device,
+               &ContainerVolumes,
+               &NumberOfContainerVolumes,
+               &Volume
+               );
+
+    if (Volume != NULL) {
+      *ApfsVolumeHandle = Volume->Handle;
+    }
+
+    if (!EFI_ERROR (Status) && (*BootPathName != NULL)) {
+      BootPolicyStoreBootInfoResult (
+        DevicePath,
+        *BootPathName,
+        *Device,
+        *ApfsVolumeHandle
+        );
+    }
+  }
+
+  BootPolicyStatisticsExit (&StatisticsContext);
+
   return Status;
 }
 
@@ -904,22 +1052,12 @@ BootPolicyGetPathNameOnApfsRecovery (
 
   CHAR16                          *BootPathName;
   EFI_HANDLE                      Device;
-  EFI_HANDLE                      VolumeHandle;
 
-  GUID                            ContainerGuid;
-  GUID                            VolumeGuid;
-  APPLE_APFS_VOLUME_ROLE          VolumeRole;
-
-  GUID                            ContainerGuid2;
-  GUID                            VolumeGuid2;
-  APPLE_APFS_VOLUME_ROLE          VolumeRole2;
-
-  UINTN                           NoHandles;
-  EFI_HANDLE                      *HandleBuffer;
+  CONST APFS_VOLUME_INFO          *Volumes;
+  UINTN                           NumberOfVolumes;
+  CONST APFS_VOLUME_INFO          *Volume;
   UINTN                           Index;
 
-  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *FileSystem;
-
   CHAR16                          *FullPathBuffer;
   UINTN                           FullPathNameSize;
 
@@ -927,6 +1065,13 @@ BootPolicyGetPathNameOnApfsRecovery (
 
   EFI_FILE_INFO                   *FileInfo;
 
+  BOOT_POLICY_STATISTICS_CONTEXT  StatisticsContext;
+
+  BootPolicyStatisticsEnter (
+    AppleBootPolicyFunctionGetPathNameOnApfsRecovery,
+    &StatisticsContext
+    );
+
   Result = EFI_INVALID_PARAMETER;
 
   NewHandle     = NULL;
@@ -937,114 +1082,214 @@ BootPolicyGetPathNameOnApfsRecovery (
   if ((PathName != NULL) && (DevicePath != NULL)) {
     Result = EFI_NOT_FOUND;
 
-    Status = BootPolicyGetBootInfo (
+    //
+    // The volumes of the container are retrieved along with the boot volume,
+    // hence the recovery volumes are looked up without another scan.
+    //
+    Status = InternalGetBootInfo (
                DevicePath,
                &BootPathName,
                &Device,
-               &VolumeHandle
+               &Volumes,
+               &NumberOfVolumes,
+               &Volume
                );
 
     if (!EFI_ERROR (Status)) {
-      Status = InternalGetApfsVolumeInfo (
-                 VolumeHandle,
-                 &ContainerGuid,
-                 &VolumeGuid,
-                 &VolumeRole
-                 );
+      if (BootPathName != NULL) {
+        FreePool ((VOID *)BootPathName);
+      }
 
-      if (!EFI_ERROR (Status)) {
-        Result = gBS->LocateHandleBuffer (
-                        ByProtocol,
-                        &gEfiSimpleFileSystemProtocolGuid,
-                        NULL,
-                        &NoHandles,
-                        &HandleBuffer
-                        );
+      if (Volume != NULL) {
+        for (Index = 0; Index < NumberOfVolumes; ++Index) {
+          if (Volumes[Index].VolumeRole != APPLE_APFS_VOLUME_ROLE_RECOVERY) {
+            continue;
+          }
 
-        if (!EFI_ERROR (Result)) {
-          Result = EFI_NOT_FOUND;
+          //
+          // The root of a candidate is only kept open when it is returned.
+          //
+          Result = BootPolicyOpenFileSystemRoot (Volumes[Index].Handle, Root);
 
-          for (Index = 0; Index < NoHandles; ++Index) {
-            Result = InternalGetApfsVolumeInfo (
-                       HandleBuffer[Index],
-                       &ContainerGuid2,
-                       &VolumeGuid2,
-                       &VolumeRole2
-                       );
+          if (EFI_ERROR (Result)) {
+            continue;
+          }
 
-            if (!EFI_ERROR (Result)
-             && VolumeRole2 == APPLE_APFS_VOLUME_ROLE_RECOVERY
-             && CompareGuid (&ContainerGuid2, &ContainerGuid)) {
-              Result = gBS->HandleProtocol (
-                              HandleBuffer[Index],
-                              &gEfiSimpleFileSystemProtocolGuid,
-                              (VOID **)&FileSystem
-                              );
-
-              if (!EFI_ERROR (Result)) {
-                Result = FileSystem->OpenVolume (FileSystem, Root);
-
-                if (!EFI_ERROR (Result)) {
-                  FullPathNameSize  = StrSize (PathName);
-                  // BUG: Buffer seems to be too large.
-                  FullPathNameSize += 40 * sizeof (*FullPathBuffer);
-                  // BUG: Only set the last character to \0.
-                  FullPathBuffer    = AllocateZeroPool (FullPathNameSize);
-
-                  UnicodeSPrint (
-                    FullPathBuffer,
-                    FullPathNameSize,
-                    L"%g%s",
-                    &VolumeGuid,
-                    PathName
-                    );
+          FullPathNameSize  = StrSize (PathName);
+          // BUG: Buffer seems to be too large.
+          FullPathNameSize += 40 * sizeof (*FullPathBuffer);
+          // BUG: Only set the last character to \0.
+          FullPathBuffer    = AllocateZeroPool (FullPathNameSize);
 
-                  Result = (*Root)->Open (
-                                      *Root,
-                                      &NewHandle,
-                                      FullPathBuffer,
-                                      EFI_FILE_MODE_READ,
-                                      0
-                                      );
+          if (FullPathBuffer == NULL) {
+            (*Root)->Close (*Root);
+
+            *Root = NULL;
 
-                  if (!EFI_ERROR (Result)) {
-                    FileInfo = InternalGetFileInfo (
-                                 NewHandle,
-                                 &gEfiFileInfoGuid
-                                 );
+            Result = EFI_OUT_OF_RESOURCES;
+
+            break;
+          }
 
-                    // BUG: Return an error code if FALSE.
-                    if (FileInfo != NULL) {
-                      if ((FileInfo->Attribute & EFI_FILE_DIRECTORY) != 0) {
-                        *FullPathName = FullPathBuffer;
-                        *DeviceHandle = HandleBuffer[Index];
+          BootPolicyGuidToStr (&Volume->VolumeGuid, FullPathBuffer);
+          StrCat (FullPathBuffer, PathName);
 
-                        // BUG: NewHandle is not closed.
+          Result = InternalOpenFile (*Root, FullPathBuffer, &NewHandle);
 
-                        FreePool ((VOID *)FileInfo);
+          if (!EFI_ERROR (Result)) {
+            FileInfo = InternalGetFileInfo (NewHandle, &gEfiFileInfoGuid);
 
-                        break;
-                      }
+            NewHandle->Close (NewHandle);
 
-                      FreePool ((VOID *)FileInfo);
-                    }
+            // BUG: Return an error code if FALSE.
+            if (FileInfo != NULL) {
+              if ((FileInfo->Attribute & EFI_FILE_DIRECTORY) != 0) {
+                *FullPathName = FullPathBuffer;
+                *DeviceHandle = Volumes[Index].Handle;
 
-                    NewHandle->Close (NewHandle);
-                  }
-                }
+                FreePool ((VOID *)FileInfo);
+
+                break;
               }
+
+              FreePool ((VOID *)FileInfo);
             }
           }
 
-          FreePool ((VOID *)HandleBuffer);
+          FreePool ((VOID *)FullPathBuffer);
+
+          (*Root)->Close (*Root);
+
+          *Root = NULL;
+
+          Result = EFI_NOT_FOUND;
         }
       }
     }
   }
 
+  BootPolicyStatisticsExit (&StatisticsContext);
+
   return Result;
 }
 
+/**
+  Appends an entry for every volume directory found on the recovery volumes of
+  a single APFS container.
+
+  @param[in]      Volumes          The volumes of the container.
+  @param[in]      NumberOfVolumes  The number of entries in Volumes.
+  @param[in, out] ApfsVolumes      The array to append the entries to.
+  @param[in, out] NumberOfEntries  The number of entries in ApfsVolumes.
+
+  @retval EFI_OUT_OF_RESOURCES  An entry could not be allocated.
+  @retval other                 The container has been processed.
+
+**/
+STATIC
+EFI_STATUS
+InternalAddApfsRecoveryVolumes (
+  IN     CONST APFS_VOLUME_INFO  *Volumes,
+  IN     UINTN                   NumberOfVolumes,
+  IN OUT APFS_VOLUME_ROOT        **ApfsVolumes,
+  IN OUT UINTN                   *NumberOfEntries
+  )
+{
+  EFI_STATUS              Status;
+
+  UINTN                   Index;
+  UINTN                   Index2;
+  EFI_FILE_PROTOCOL       *Root;
+  BOOLEAN                 RootReturned;
+  CHAR16                  String[APPLE_BOOT_POLICY_GUID_STRING_LENGTH + 1];
+  EFI_FILE_PROTOCOL       *NewHandle;
+  EFI_FILE_INFO           *FileInfo;
+  APFS_VOLUME_ROOT        *ApfsRoot;
+
+  Status = EFI_SUCCESS;
+
+  for (Index = 0; Index < NumberOfVolumes; ++Index) {
+    if ((Volumes[Index].VolumeRole & APPLE_APFS_VOLUME_ROLE_RECOVERY) == 0) {
+      continue;
+    }
+
+    //
+    // All entries of a recovery volume share its root, which is closed right
+    // away if no entry has been returned.
+    //
+    Status = BootPolicyOpenFileSystemRoot (Volumes[Index].Handle, &Root);
+
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+
+    RootReturned = FALSE;
+
+    for (Index2 = 0; Index2 < NumberOfVolumes; ++Index2) {
+      BootPolicyGuidToStr (&Volumes[Index2].VolumeGuid, &String[0]);
+
+      Status = InternalOpenFile (Root, &String[0], &NewHandle);
+
+      if (EFI_ERROR (Status)) {
+        continue;
+      }
+
+      FileInfo = InternalGetFileInfo (NewHandle, &gEfiFileInfoGuid);
+
+      NewHandle->Close (NewHandle);
+
+      if (FileInfo == NULL) {
+        continue;
+      }
+
+      if ((FileInfo->Attribute & EFI_FILE_DIRECTORY) != 0) {
+        ApfsRoot = AllocateZeroPool (sizeof (*ApfsRoot));
+
+        if (ApfsRoot != NULL) {
+          ApfsRoot->VolumeDirName = AllocateCopyPool (
+                                      StrSize (String),
+                                      (VOID *)&String[0]
+                                      );
+
+          if (ApfsRoot->VolumeDirName == NULL) {
+            FreePool ((VOID *)ApfsRoot);
+
+            ApfsRoot = NULL;
+          }
+        }
+
+        if (ApfsRoot == NULL) {
+          FreePool ((VOID *)FileInfo);
+
+          Status = EFI_OUT_OF_RESOURCES;
+
+          break;
+        }
+
+        ApfsRoot->Handle = Volumes[Index].Handle;
+        ApfsRoot->Root   = Root;
+
+        RootReturned = TRUE;
+
+        ApfsVolumes[*NumberOfEntries] = ApfsRoot;
+        ++(*NumberOfEntries);
+      }
+
+      FreePool ((VOID *)FileInfo);
+    }
+
+    if (!RootReturned) {
+      Root->Close (Root);
+    }
+
+    if (Status == EFI_OUT_OF_RESOURCES) {
+      break;
+    }
+  }
+
+  return Status;
+}
+
 EFI_STATUS
 EFIAPI
 BootPolicyGetApfsRecoveryVolumes (
@@ -1053,203 +1298,138 @@ BootPolicyGetApfsRecoveryVolumes (
   OUT UINTN       *NumberOfEntries
   )
 {
-  EFI_STATUS                      Status;
+  EFI_STATUS                     Status;
 
-  UINTN                           NumberOfHandles;
-  EFI_HANDLE                      *HandleBuffer;
-  APFS_VOLUME_INFO                *VolumeInfo;
-  GUID                            **ContainerGuids;
-  GUID                            UnusedGuid; // BUG: This variable is never used.
-  UINTN                           Index;
-  EFI_GUID                        ContainerGuid;
-  EFI_GUID                        VolumeGuid;
-  APPLE_APFS_VOLUME_ROLE          VolumeRole;
-  UINTN                           Index2;
-  UINTN                           NumberOfContainers;
-  UINTN                           NumberOfVolumeInfo;
-  APFS_VOLUME_ROOT                **ApfsVolumes;
-  UINTN                           Index3;
-  UINTN                           Index4;
-  BOOLEAN                         GuidPresent;
-  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *FileSystem;
-  EFI_FILE_PROTOCOL               *Root;
-  EFI_FILE_PROTOCOL               *NewHandle;
-  CHAR16                          String[40];
-  EFI_FILE_INFO                   *FileInfo;
-  APFS_VOLUME_ROOT                *ApfsRoot;
+  CONST APFS_VOLUME_INFO         *VolumeInfo;
+  UINTN                          NumberOfVolumeInfo;
+  CONST GUID                     *HandleContainerGuid;
+  UINTN                          MaxNumberOfEntries;
+  UINTN                          NumberOfRecoveryVolumes;
+  UINTN                          Pass;
+  BOOLEAN                        HandleContainer;
+  UINTN                          Index;
+  UINTN                          Index2;
+  APFS_VOLUME_ROOT               **ApfsVolumes;
 
-  Status = gBS->LocateHandleBuffer (
-                  ByProtocol,
-                  &gEfiSimpleFileSystemProtocolGuid,
-                  NULL,
-                  &NumberOfHandles,
-                  &HandleBuffer
-                  );
+  BOOT_POLICY_STATISTICS_CONTEXT StatisticsContext;
 
-  if (!EFI_ERROR (Status)) {
-    Status = EFI_NOT_FOUND;
+  BootPolicyStatisticsEnter (
+    AppleBootPolicyFunctionGetApfsRecoveryVolumes,
+    &StatisticsContext
+    );
 
-    if (NumberOfHandles > 0) {
-      VolumeInfo = AllocateZeroPool (NumberOfHandles * sizeof (*VolumeInfo));
+  Status = BootPolicyGetApfsVolumes (&VolumeInfo, &NumberOfVolumeInfo);
 
-      Status = EFI_OUT_OF_RESOURCES;
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
 
-      if (VolumeInfo != NULL) {
-        // BUG: The previous allocation is verified, this isn't.
-        ContainerGuids = AllocateZeroPool (
-                           NumberOfHandles * sizeof (**ContainerGuids)
-                           );
-
-        ZeroMem ((VOID *)&UnusedGuid, sizeof (UnusedGuid));
-
-        NumberOfVolumeInfo = 0;
-        NumberOfContainers = 0;
-
-        Status = EFI_NOT_FOUND;
-
-        for (Index = 0; Index < NumberOfHandles; ++Index) {
-          Status = InternalGetApfsVolumeInfo (
-                     HandleBuffer[Index],
-                     &ContainerGuid,
-                     &VolumeGuid,
-                     &VolumeRole
-                     );
-
-          if (!EFI_ERROR (Status)) {
-            CopyGuid (
-              &VolumeInfo[NumberOfVolumeInfo].ContainerGuid,
-              &ContainerGuid
-              );
+  //
+  // The volumes are grouped by container.  Every recovery volume may provide
+  // a directory for each volume of its container.
+  //
+  HandleContainerGuid = NULL;
+  MaxNumberOfEntries  = 0;
+
+  for (Index = 0; Index < NumberOfVolumeInfo; Index = Index2) {
+    NumberOfRecoveryVolumes = 0;
+
+    for (Index2 = Index; Index2 < NumberOfVolumeInfo; ++Index2) {
+      if (!CompareGuid (
+             &VolumeInfo[Index2].ContainerGuid,
+             &VolumeInfo[Index].ContainerGuid
+             )) {
+        break;
+      }
 
-            CopyGuid (
-              &VolumeInfo[NumberOfVolumeInfo].VolumeGuid,
-              &VolumeGuid
-              );
+      if (VolumeInfo[Index2].Handle == Handle) {
+        HandleContainerGuid = &VolumeInfo[Index2].ContainerGuid;
+      }
 
-            VolumeInfo[NumberOfVolumeInfo].VolumeRole = VolumeRole;
-            VolumeInfo[NumberOfVolumeInfo].Handle     = HandleBuffer[Index];
+      if ((VolumeInfo[Index2].VolumeRole & APPLE_APFS_VOLUME_ROLE_RECOVERY) != 0) {
+        ++NumberOfRecoveryVolumes;
+      }
+    }
 
-            GuidPresent = FALSE;
+    MaxNumberOfEntries += (NumberOfRecoveryVolumes * (Index2 - Index));
+  }
 
-            for (Index2 = 0; Index2 < NumberOfContainers; ++Index2) {
-              if (CompareGuid (ContainerGuids[Index2], &ContainerGuid)) {
-                GuidPresent = TRUE;
-                break;
-              }
-            }
+  if (MaxNumberOfEntries == 0) {
+    Status = EFI_NOT_FOUND;
 
-            if (!GuidPresent || (NumberOfContainers == 0)) {
-              CopyGuid (
-                ContainerGuids[NumberOfContainers],
-                &VolumeInfo[NumberOfVolumeInfo].ContainerGuid
-                );
-
-              // BUG: This may overwrite the GUID at [0]?
-              if ((Index2 != 0) && (HandleBuffer[Index] == Handle)) {
-                CopyGuid (
-                  ContainerGuids[0],
-                  &VolumeInfo[NumberOfVolumeInfo].ContainerGuid
-                  );
-              }
+    goto Done;
+  }
 
-              ++NumberOfContainers;
-            }
+  ApfsVolumes = AllocateZeroPool (MaxNumberOfEntries * sizeof (*ApfsVolumes));
 
-            ++NumberOfVolumeInfo;
-          }
+  if (ApfsVolumes == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+
+    goto Done;
+  }
+
+  *Volumes         = ApfsVolumes;
+  *NumberOfEntries = 0;
+
+  //
+  // The container of Handle is reported first, the others follow in the
+  // second pass.
+  //
+  for (Pass = 0; Pass < 2; ++Pass) {
+    for (Index = 0; Index < NumberOfVolumeInfo; Index = Index2) {
+      for (Index2 = (Index + 1); Index2 < NumberOfVolumeInfo; ++Index2) {
+        if (!CompareGuid (
+               &VolumeInfo[Index2].ContainerGuid,
+               &VolumeInfo[Index].ContainerGuid
+               )) {
+          break;
         }
+      }
 
-        if (NumberOfVolumeInfo != 0) {
-          ApfsVolumes = AllocateZeroPool (
-                          NumberOfVolumeInfo * sizeof (ApfsVolumes)
+      HandleContainer = (BOOLEAN)(
+                          (HandleContainerGuid != NULL)
+                            && CompareGuid (
+                                 &VolumeInfo[Index].ContainerGuid,
+                                 HandleContainerGuid
+                                 )
                           );
 
-          Status = EFI_OUT_OF_RESOURCES;
+      if (HandleContainer != (Pass == 0)) {
+        continue;
+      }
 
-          if (ApfsVolumes != NULL) {
-            *Volumes         = ApfsVolumes;
-            *NumberOfEntries = 0;
-
-            for (Index2 = 0; Index2 < NumberOfContainers; ++Index2) {
-              for (Index3 = 0; Index3 < NumberOfVolumeInfo; ++Index3) {
-                if (CompareGuid (
-                      ContainerGuids[Index2],
-                      &VolumeInfo[Index3].ContainerGuid
-                      )
-                 && ((VolumeInfo[Index3].VolumeRole & APPLE_APFS_VOLUME_ROLE_RECOVERY) != 0)
-                 ) {
-                  Status = gBS->HandleProtocol (
-                                  VolumeInfo[Index3].Handle,
-                                  &gEfiSimpleFileSystemProtocolGuid,
-                                  (VOID **)&FileSystem
-                                  );
-
-                  if (!EFI_ERROR (Status)) {
-                    Status = FileSystem->OpenVolume (FileSystem, &Root);
-                    
-                    if (!EFI_ERROR (Status)) {
-                      for (Index4 = 0; Index4 < NumberOfVolumeInfo; ++Index4) {
-                        if (
-                          CompareGuid (
-                            ContainerGuids[Index2],
-                            &VolumeInfo[Index4].ContainerGuid
-                            )
-                          ) {
-                          UnicodeSPrint (
-                            &String[0],
-                            sizeof (String),
-                            L"%g",
-                            &VolumeInfo[Index4].VolumeGuid
-                            );
-
-                          Status = Root->Open (
-                                           Root,
-                                           &NewHandle,
-                                           String,
-                                           EFI_FILE_MODE_READ,
-                                           0
-                                           );
-
-                          if (!EFI_ERROR (Status)) {
-                            FileInfo = InternalGetFileInfo (
-                                         NewHandle,
-                                         &gEfiFileInfoGuid
-                                         );
-
-                            if ((FileInfo != NULL)
-                             && ((FileInfo->Attribute & EFI_FILE_DIRECTORY) != 0)
-                             ) {
-                              ApfsRoot = ApfsVolumes[*NumberOfEntries];
-
-                              ApfsRoot->Handle = VolumeInfo[Index3].Handle;
-
-                              ApfsRoot->VolumeDirName = AllocateCopyPool (
-                                                          StrSize (String),
-                                                          (VOID *)&String[0]
-                                                          );
-
-                              ApfsRoot->Root = Root;
-
-                              ++(*NumberOfEntries);
-                            }
-                          }
-                        }
-                      }
-                    }
-                  }
-                }
-              }
-            }
+      Status = InternalAddApfsRecoveryVolumes (
+                 &VolumeInfo[Index],
+                 (Index2 - Index),
+                 ApfsVolumes,
+                 NumberOfEntries
+                 );
 
-            FreePool ((VOID *)VolumeInfo);
-            FreePool ((VOID *)ContainerGuids);
-            FreePool ((VOID *)HandleBuffer);
-          }
-        }
+      if (Status == EFI_OUT_OF_RESOURCES) {
+        break;
       }
     }
+
+    if (Status == EFI_OUT_OF_RESOURCES) {
+      break;
+    }
+  }
+
+  if (*NumberOfEntries > 0) {
+    Status = EFI_SUCCESS;
+  } else {
+    FreePool ((VOID *)ApfsVolumes);
+
+    *Volumes = NULL;
+
+    if (Status != EFI_OUT_OF_RESOURCES) {
+      Status = EFI_NOT_FOUND;
+    }
   }
 
+Done:
+  BootPolicyStatisticsExit (&StatisticsContext);
+
   return Status;
 }
 
@@ -1282,11 +1462,26 @@ AppleBootPolicyMain (
                   );
 
   if (EFI_ERROR (Status)) {
-    Status = gBS->InstallProtocolInterface (
+    //
+    // Without the notifications the volume cache is rebuilt on every query
+    // and no results are memoized, without the statistics and trace tables
+    // nothing is accounted, hence failures are not fatal.
+    //
+    BootPolicyCreateVolumeCache ();
+    BootPolicyCreateResultCache ();
+    BootPolicyCreateBlessedInfoCache ();
+    BootPolicyCreateStatistics ();
+    BootPolicyCreateTrace ();
+
+    Handle = NULL;
+
+    Status = gBS->InstallMultipleProtocolInterfaces (
                     &Handle,
                     &gAppleBootPolicyProtocolGuid,
-                    EFI_NATIVE_INTERFACE,
-                    (VOID **)&mAppleBootPolicyProtocol
+                    (VOID *)&mAppleBootPolicyProtocol,
+                    &gAppleBootPolicyExProtocolGuid,
+                    (VOID *)&mAppleBootPolicyExProtocol,
+                    NULL
                     );
   } else {
     Status = EFI_ALREADY_STARTED;
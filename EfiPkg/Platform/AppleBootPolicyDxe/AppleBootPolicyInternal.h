@@ -0,0 +1,583 @@
+#ifndef APPLE_BOOT_POLICY_INTERNAL_H_
+#define APPLE_BOOT_POLICY_INTERNAL_H_
+
+#include <Guid/AppleApfsInfo.h>
+#include <Guid/AppleBootPolicyStatistics.h>
+#include <Guid/AppleBootPolicyTrace.h>
+
+#include <Protocol/AppleBootPolicyEx.h>
+#include <Protocol/SimpleFileSystem.h>
+
+// APFS_VOLUME_INFO
+typedef struct {
+  EFI_HANDLE             Handle;
+  GUID                   ContainerGuid;
+  GUID                   VolumeGuid;
+  APPLE_APFS_VOLUME_ROLE VolumeRole;
+} APFS_VOLUME_INFO;
+
+// BOOT_POLICY_BLESSED_INFO
+/// The blessing of a volume, unused entries have a Device of NULL.
+typedef struct {
+  EFI_HANDLE               Device;
+  EFI_DEVICE_PATH_PROTOCOL *SystemFile;
+  EFI_DEVICE_PATH_PROTOCOL *SystemFolder;
+} BOOT_POLICY_BLESSED_INFO;
+
+// BOOT_POLICY_TRACE_CONTEXT
+typedef struct {
+  UINT64 StartTime;
+} BOOT_POLICY_TRACE_CONTEXT;
+
+// BOOT_POLICY_STATISTICS_CONTEXT
+typedef struct {
+  APPLE_BOOT_POLICY_FUNCTION_STATISTICS *Function;
+  APPLE_BOOT_POLICY_FUNCTION_STATISTICS *Caller;
+  UINT64                                StartTime;
+} BOOT_POLICY_STATISTICS_CONTEXT;
+
+// BOOT_POLICY_DEVICE_PATH_SCRATCH_SIZE
+/// The size of the stack buffers device paths are assembled in.  Larger
+/// results are moved into pool memory.
+#define BOOT_POLICY_DEVICE_PATH_SCRATCH_SIZE  1024
+
+// BOOT_POLICY_DEVICE_PATH_INLINE_SLOTS
+/// The number of instance index slots available before the index is moved
+/// into pool memory.  Must be a power of two.
+#define BOOT_POLICY_DEVICE_PATH_INLINE_SLOTS  32
+
+// BOOT_POLICY_DEVICE_PATH_SLOT
+/// An instance index slot, unused if Hash is 0.
+typedef struct {
+  UINT32 Hash;
+  UINT32 Offset;
+  UINT32 Size;
+} BOOT_POLICY_DEVICE_PATH_SLOT;
+
+// BOOT_POLICY_DEVICE_PATH_BUILDER
+/// Assembles a multi-instance device path within a caller-provided buffer.
+/// The committed instances are indexed by their hash to reject duplicates.
+typedef struct {
+  UINT8                        *Buffer;
+  UINTN                        BufferSize;
+  UINTN                        Size;
+  BOOLEAN                      BufferAllocated;
+  BOOT_POLICY_DEVICE_PATH_SLOT *Slots;
+  UINTN                        NumberOfSlots;
+  UINTN                        NumberOfInstances;
+  BOOT_POLICY_DEVICE_PATH_SLOT InlineSlots[BOOT_POLICY_DEVICE_PATH_INLINE_SLOTS];
+} BOOT_POLICY_DEVICE_PATH_BUILDER;
+
+// InternalFileExists
+BOOLEAN
+InternalFileExists (
+  IN EFI_FILE_HANDLE  Root,
+  IN CONST CHAR16     *FileName
+  );
+
+// InternalGetFileInfo
+VOID *
+InternalGetFileInfo (
+  IN EFI_FILE_PROTOCOL  *Root,
+  IN EFI_GUID           *InformationType
+  );
+
+// BootPolicyCreateVolumeCache
+/** Registers for EFI_SIMPLE_FILE_SYSTEM_PROTOCOL installations so that the
+    APFS volume cache gets invalidated whenever the set of file systems
+    changes.
+
+  @retval EFI_SUCCESS  The notification has been registered successfully.
+  @retval other        The cache is rebuilt on every query.
+**/
+EFI_STATUS
+BootPolicyCreateVolumeCache (
+  VOID
+  );
+
+// BootPolicyGetApfsVolumes
+/** Retrieves the cached information of all APFS volumes, refreshing the cache
+    if it has been invalidated.  The volumes are sorted by container UUID.
+
+  The returned buffer is owned by the cache and stays valid until the next
+  call of any BootPolicy volume cache function.
+
+  @param[out] Volumes          Receives the array of cached APFS volumes.
+  @param[out] NumberOfVolumes  Receives the number of entries in Volumes.
+
+  @retval EFI_SUCCESS    The volume information has been returned.
+  @retval EFI_NOT_FOUND  No APFS volume is present.
+  @retval other          The file system handles could not be located.
+**/
+EFI_STATUS
+BootPolicyGetApfsVolumes (
+  OUT CONST APFS_VOLUME_INFO  **Volumes,
+  OUT UINTN                   *NumberOfVolumes
+  );
+
+// BootPolicyGetApfsContainerVolumes
+/** Retrieves the cached information of all APFS volumes of a container.
+
+  The cache is kept sorted by container UUID, hence the volumes of a container
+  are stored contiguously and are located by a binary search.  The returned
+  buffer is owned by the cache with the same lifetime as described for
+  BootPolicyGetApfsVolumes().
+
+  @param[in]  ContainerGuid    The UUID of the APFS container to look up.
+  @param[out] Volumes          Receives the first volume of the container.
+  @param[out] NumberOfVolumes  Receives the number of volumes of the container.
+
+  @retval EFI_SUCCESS    The volume information has been returned.
+  @retval EFI_NOT_FOUND  The container has no volumes.
+**/
+EFI_STATUS
+BootPolicyGetApfsContainerVolumes (
+  IN  CONST GUID              *ContainerGuid,
+  OUT CONST APFS_VOLUME_INFO  **Volumes,
+  OUT UINTN                   *NumberOfVolumes
+  );
+
+// BootPolicyGetApfsVolumeInfo
+/** Retrieves the cached APFS information of Device.
+
+  @param[in]  Device         The handle of the file system to look up.
+  @param[out] ContainerGuid  Receives the UUID of the APFS container.
+  @param[out] VolumeGuid     Receives the UUID of the APFS volume.
+  @param[out] VolumeRole     Receives the role of the APFS volume.
+
+  @retval EFI_SUCCESS    The volume information has been returned.
+  @retval EFI_NOT_FOUND  Device is not an APFS volume.
+**/
+EFI_STATUS
+BootPolicyGetApfsVolumeInfo (
+  IN  EFI_HANDLE              Device,
+  OUT EFI_GUID                *ContainerGuid,
+  OUT EFI_GUID                *VolumeGuid,
+  OUT APPLE_APFS_VOLUME_ROLE  *VolumeRole
+  );
+
+// BootPolicyOpenFileSystemRoot
+/** Opens the root of the file system installed on Handle.
+
+  @param[in]  Handle  The handle of the file system.
+  @param[out] Root    Receives the opened root.
+
+  @retval EFI_SUCCESS  The root has been opened.
+  @retval other        The root could not be opened.
+**/
+EFI_STATUS
+BootPolicyOpenFileSystemRoot (
+  IN  EFI_HANDLE         Handle,
+  OUT EFI_FILE_PROTOCOL  **Root
+  );
+
+// BootPolicyStrToGuid
+/** Parses the GUID String starts with, as formatted by "%g".  Hexadecimal
+    digits of either case are accepted.
+
+  @param[in]  String  The string to parse.  Characters following the GUID
+                      are ignored.
+  @param[out] Guid    Receives the parsed GUID.
+
+  @retval EFI_SUCCESS            The GUID has been parsed.
+  @retval EFI_INVALID_PARAMETER  String does not start with a GUID.
+**/
+EFI_STATUS
+BootPolicyStrToGuid (
+  IN  CONST CHAR16  *String,
+  OUT EFI_GUID      *Guid
+  );
+
+// BootPolicyGuidToStr
+/** Formats Guid as done by "%g".
+
+  @param[in]  Guid    The GUID to format.
+  @param[out] String  Receives the string.  It must have room for
+                      APPLE_BOOT_POLICY_GUID_STRING_LENGTH + 1 characters.
+**/
+VOID
+BootPolicyGuidToStr (
+  IN  CONST EFI_GUID  *Guid,
+  OUT CHAR16          *String
+  );
+
+// BootPolicyGetBootFileEx
+EFI_STATUS
+EFIAPI
+BootPolicyGetBootFileEx (
+  IN  EFI_HANDLE                Device,
+  IN  UINT32                    Mode,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **FilePath
+  );
+
+// BootPolicyOpenVolumeCursor
+EFI_STATUS
+EFIAPI
+BootPolicyOpenVolumeCursor (
+  IN  UINT32                           Mode,
+  OUT APPLE_BOOT_POLICY_VOLUME_CURSOR  **Cursor
+  );
+
+// BootPolicyGetNextVolume
+EFI_STATUS
+EFIAPI
+BootPolicyGetNextVolume (
+  IN  APPLE_BOOT_POLICY_VOLUME_CURSOR  *Cursor,
+  OUT EFI_HANDLE                       *Device,
+  OUT EFI_DEVICE_PATH_PROTOCOL         **FilePath
+  );
+
+// BootPolicyCloseVolumeCursor
+VOID
+EFIAPI
+BootPolicyCloseVolumeCursor (
+  IN APPLE_BOOT_POLICY_VOLUME_CURSOR  *Cursor
+  );
+
+// BootPolicyGetVolumesByRole
+EFI_STATUS
+EFIAPI
+BootPolicyGetVolumesByRole (
+  IN  APPLE_APFS_VOLUME_ROLE         RoleMask,
+  OUT APPLE_BOOT_POLICY_VOLUME_LIST  **List
+  );
+
+// BootPolicyOpenVolumeRoot
+EFI_STATUS
+EFIAPI
+BootPolicyOpenVolumeRoot (
+  IN  CONST APPLE_BOOT_POLICY_VOLUME_ENTRY  *Volume,
+  OUT EFI_FILE_PROTOCOL                     **Root
+  );
+
+// BootPolicyGetBootFileCacheKey
+/** Retrieves a key identifying a volume across boots.  APFS volumes are
+    identified by their volume UUID, others by their GPT partition GUID.
+
+  @param[in]  Device     The handle of the volume.
+  @param[in]  Root       The opened root of the volume.
+  @param[out] VolumeKey  Receives the key of the volume.
+
+  @retval EFI_SUCCESS    The key has been returned.
+  @retval EFI_NOT_FOUND  The volume cannot be identified.
+**/
+EFI_STATUS
+BootPolicyGetBootFileCacheKey (
+  IN  EFI_HANDLE         Device,
+  IN  EFI_FILE_PROTOCOL  *Root,
+  OUT GUID               *VolumeKey
+  );
+
+// BootPolicyGetCachedBootPathIndex
+/** Retrieves the index of the fallback boot file found for a volume on a
+    previous boot.  The caller must verify that the file still exists and
+    that no file of higher priority has appeared.
+
+  @param[in]  VolumeKey      The key of the volume.
+  @param[out] BootPathIndex  Receives the cached index.
+
+  @retval EFI_SUCCESS    The cached index has been returned.
+  @retval EFI_NOT_FOUND  The volume is not cached.
+**/
+EFI_STATUS
+BootPolicyGetCachedBootPathIndex (
+  IN  CONST GUID  *VolumeKey,
+  OUT UINTN       *BootPathIndex
+  );
+
+// BootPolicyUpdateBootFileCache
+/** Stores the index of the fallback boot file of a volume.  The variable is
+    only written when the cached index differs, or when an unknown volume
+    takes a free entry or one of a volume not seen during this boot.
+
+  @param[in] VolumeKey      The key of the volume.
+  @param[in] BootPathIndex  The index of the boot file found.
+**/
+VOID
+BootPolicyUpdateBootFileCache (
+  IN CONST GUID  *VolumeKey,
+  IN UINTN       BootPathIndex
+  );
+
+// BootPolicyCreateBlessedInfoCache
+/** Registers for EFI_SIMPLE_FILE_SYSTEM_PROTOCOL installations so that the
+    queried blessings are dropped whenever a file system is reinstalled.
+
+  @retval EFI_SUCCESS  The notification has been registered successfully.
+  @retval other        The blessing is queried on every lookup.
+**/
+EFI_STATUS
+BootPolicyCreateBlessedInfoCache (
+  VOID
+  );
+
+// BootPolicyGetBlessedInfo
+/** Retrieves the blessed system file and folder of a volume.  Both are
+    queried together on the first lookup of Device and served from the cache
+    afterwards.
+
+  A blessing changed through the file system is not detected until the file
+  system is reinstalled.
+
+  @param[in]  Device        The handle of the volume.
+  @param[in]  Root          The opened root of the volume.
+  @param[out] SystemFile    Receives a copy of the blessed system file, or
+                            NULL if there is none.
+  @param[out] SystemFolder  Receives a copy of the blessed system folder, or
+                            NULL if there is none.
+
+  @retval EFI_SUCCESS           The blessing has been returned.
+  @retval EFI_OUT_OF_RESOURCES  A copy could not be allocated.
+**/
+EFI_STATUS
+BootPolicyGetBlessedInfo (
+  IN  EFI_HANDLE                Device,
+  IN  EFI_FILE_PROTOCOL         *Root,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **SystemFile,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **SystemFolder OPTIONAL
+  );
+
+// BootPolicyCreateResultCache
+/** Registers for EFI_SIMPLE_FILE_SYSTEM_PROTOCOL installations so that
+    memoized results are flushed whenever a file system is reinstalled.  The
+    results are freed by the next lookup or store rather than by the
+    notification itself.
+
+  @retval EFI_SUCCESS  The notification has been registered successfully.
+  @retval other        No results are memoized.
+**/
+EFI_STATUS
+BootPolicyCreateResultCache (
+  VOID
+  );
+
+// BootPolicyLookupBootFileResult
+/** Retrieves the memoized result of GetBootFileEx() for Device and Mode.  It
+    is only returned if the file system is still present and the media of
+    its block device has not changed.
+
+  Changes to the volume contents, such as a new blessing, are not detected
+  until the file system is reinstalled.
+
+  @param[in]  Device    The handle of the volume.
+  @param[in]  Mode      The mode passed to GetBootFileEx().
+  @param[out] FilePath  Receives a copy of the memoized boot file.
+
+  @retval EFI_SUCCESS    The memoized result has been returned.
+  @retval EFI_NOT_FOUND  No valid result is memoized.
+**/
+EFI_STATUS
+BootPolicyLookupBootFileResult (
+  IN  EFI_HANDLE                Device,
+  IN  UINT32                    Mode,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **FilePath
+  );
+
+// BootPolicyStoreBootFileResult
+VOID
+BootPolicyStoreBootFileResult (
+  IN EFI_HANDLE                      Device,
+  IN UINT32                          Mode,
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *FilePath
+  );
+
+// BootPolicyLookupBootInfoResult
+/** Retrieves the memoized result of GetBootInfo() for DevicePath, see
+    BootPolicyLookupBootFileResult().  The APFS volume handle must still
+    carry a file system as well.
+
+  @param[in]  DevicePath        The device path passed to GetBootInfo().
+  @param[out] BootPathName      Receives a copy of the memoized path name.
+  @param[out] Device            Receives the handle of the volume.
+  @param[out] ApfsVolumeHandle  Receives the handle of the APFS volume.
+
+  @retval EFI_SUCCESS    The memoized result has been returned.
+  @retval EFI_NOT_FOUND  No valid result is memoized.
+**/
+EFI_STATUS
+BootPolicyLookupBootInfoResult (
+  IN  CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  OUT CHAR16                          **BootPathName,
+  OUT EFI_HANDLE                      *Device,
+  OUT EFI_HANDLE                      *ApfsVolumeHandle
+  );
+
+// BootPolicyStoreBootInfoResult
+VOID
+BootPolicyStoreBootInfoResult (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN CONST CHAR16                    *BootPathName,
+  IN EFI_HANDLE                      Device,
+  IN EFI_HANDLE                      ApfsVolumeHandle
+  );
+
+// BootPolicyInitDevicePathBuilder
+/** Initializes Builder to assemble a device path within Buffer.
+
+  @param[out] Builder     The builder to initialize.
+  @param[in]  Buffer      The scratch buffer to assemble the device path in.
+  @param[in]  BufferSize  The size, in bytes, of Buffer.
+**/
+VOID
+BootPolicyInitDevicePathBuilder (
+  OUT BOOT_POLICY_DEVICE_PATH_BUILDER  *Builder,
+  IN  VOID                             *Buffer,
+  IN  UINTN                            BufferSize
+  );
+
+// BootPolicyAppendDevicePathInstances
+/** Appends all instances of DevicePath not yet part of Builder.
+
+  @param[in, out] Builder     The builder to append to.
+  @param[in]      DevicePath  The possibly multi-instance device path.
+
+  @retval EFI_SUCCESS           The instances have been appended.
+  @retval EFI_OUT_OF_RESOURCES  The scratch buffer could not be grown.
+**/
+EFI_STATUS
+BootPolicyAppendDevicePathInstances (
+  IN OUT BOOT_POLICY_DEVICE_PATH_BUILDER  *Builder,
+  IN     CONST EFI_DEVICE_PATH_PROTOCOL   *DevicePath
+  );
+
+// BootPolicyAppendFilePathInstance
+/** Appends the instance FileDevicePath (Device, "\<DirectoryName><FileName>")
+    would return unless it is already part of Builder.
+
+  @param[in, out] Builder        The builder to append to.
+  @param[in]      Device         The handle of the volume.
+  @param[in]      DirectoryName  The directory on the volume.
+  @param[in]      FileName       The path of the file within DirectoryName.
+
+  @retval EFI_SUCCESS            The instance has been appended.
+  @retval EFI_INVALID_PARAMETER  The path name exceeds a device path node.
+  @retval EFI_OUT_OF_RESOURCES   The scratch buffer could not be grown.
+**/
+EFI_STATUS
+BootPolicyAppendFilePathInstance (
+  IN OUT BOOT_POLICY_DEVICE_PATH_BUILDER  *Builder,
+  IN     EFI_HANDLE                       Device,
+  IN     CONST CHAR16                     *DirectoryName,
+  IN     CONST CHAR16                     *FileName
+  );
+
+// BootPolicyFinishDevicePathBuilder
+/** Returns the assembled device path in pool memory and releases the
+    resources of Builder.  Each builder must be finished.
+
+  @param[in, out] Builder     The builder to finish.
+  @param[out]     DevicePath  Receives the assembled device path.
+
+  @retval EFI_SUCCESS           The device path has been returned.
+  @retval EFI_NOT_FOUND         No instance has been appended.
+  @retval EFI_OUT_OF_RESOURCES  The device path could not be allocated.
+**/
+EFI_STATUS
+BootPolicyFinishDevicePathBuilder (
+  IN OUT BOOT_POLICY_DEVICE_PATH_BUILDER  *Builder,
+  OUT    EFI_DEVICE_PATH_PROTOCOL         **DevicePath
+  );
+
+// BootPolicyCreateStatistics
+/** Allocates the boot policy statistics in runtime memory and publishes them
+    as a configuration table.
+
+  @retval EFI_SUCCESS  The statistics have been published.
+  @retval other        No statistics are collected.
+**/
+EFI_STATUS
+BootPolicyCreateStatistics (
+  VOID
+  );
+
+// BootPolicyStatisticsEnter
+/** Starts accounting a call of Function.  Operations are accounted to the
+    innermost function entered until the matching BootPolicyStatisticsExit().
+
+  @param[in]  Function  The boot policy function being called.
+  @param[out] Context   Receives the state to pass to
+                        BootPolicyStatisticsExit().
+**/
+VOID
+BootPolicyStatisticsEnter (
+  IN  APPLE_BOOT_POLICY_FUNCTION      Function,
+  OUT BOOT_POLICY_STATISTICS_CONTEXT  *Context
+  );
+
+// BootPolicyStatisticsExit
+VOID
+BootPolicyStatisticsExit (
+  IN CONST BOOT_POLICY_STATISTICS_CONTEXT  *Context
+  );
+
+// BootPolicyCountHandlesScanned
+VOID
+BootPolicyCountHandlesScanned (
+  IN UINTN  NumberOfHandles
+  );
+
+// BootPolicyCountOpen
+VOID
+BootPolicyCountOpen (
+  VOID
+  );
+
+// BootPolicyCountGetInfo
+VOID
+BootPolicyCountGetInfo (
+  VOID
+  );
+
+// BootPolicyCreateTrace
+/** Allocates the file system trace in runtime memory and publishes it as a
+    configuration table if enabled by the
+    APPLE_BOOT_POLICY_TRACE_VARIABLE_NAME variable.
+
+  @retval EFI_SUCCESS  The trace has been published.
+  @retval other        No file system calls are traced.
+**/
+EFI_STATUS
+BootPolicyCreateTrace (
+  VOID
+  );
+
+// BootPolicyTraceBegin
+/** Starts timing a file system call.
+
+  @param[out] Context  Receives the state to pass to BootPolicyTraceEnd().
+**/
+VOID
+BootPolicyTraceBegin (
+  OUT BOOT_POLICY_TRACE_CONTEXT  *Context
+  );
+
+// BootPolicyTraceEnd
+/** Records a completed file system call in the trace, if enabled.
+
+  @param[in] Context          The state returned by BootPolicyTraceBegin().
+  @param[in] Operation        The file system call.
+  @param[in] Handle           The device handle or file the call was issued
+                              on.
+  @param[in] NewHandle        The file opened.  Ignored if Status is an
+                              error.  Optional.
+  @param[in] PathName         The path name opened.  Optional.
+  @param[in] InformationType  The information type queried.  Optional.
+  @param[in] Status           The result of the call.
+  @param[in] Size             The buffer size returned by the call.
+  @param[in] Information      The buffer returned by GetInfo().  Ignored if
+                              Status is an error.  Optional.
+**/
+VOID
+BootPolicyTraceEnd (
+  IN CONST BOOT_POLICY_TRACE_CONTEXT   *Context,
+  IN APPLE_BOOT_POLICY_TRACE_OPERATION  Operation,
+  IN CONST VOID                         *Handle,
+  IN CONST VOID                         *NewHandle OPTIONAL,
+  IN CONST CHAR16                       *PathName OPTIONAL,
+  IN CONST EFI_GUID                     *InformationType OPTIONAL,
+  IN EFI_STATUS                         Status,
+  IN UINTN                              Size,
+  IN CONST VOID                         *Information OPTIONAL
+  );
+
+#endif // APPLE_BOOT_POLICY_INTERNAL_H_
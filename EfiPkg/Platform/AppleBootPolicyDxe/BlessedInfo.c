@@ -0,0 +1,233 @@
+#include <AppleMacEfi.h>
+
+#include <Guid/AppleBless.h>
+
+#include <Protocol/SimpleFileSystem.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "AppleBootPolicyInternal.h"
+
+// BLESSED_INFO_CACHE_MAX_ENTRIES
+#define BLESSED_INFO_CACHE_MAX_ENTRIES  16
+
+// mBlessedInfoCache
+/// The queried blessings, unused entries have a Device of NULL.
+STATIC
+BOOT_POLICY_BLESSED_INFO
+mBlessedInfoCache[BLESSED_INFO_CACHE_MAX_ENTRIES];
+
+// mNextBlessedInfoCacheEntry
+STATIC UINTN mNextBlessedInfoCacheEntry = 0;
+
+// mBlessedInfoCacheNotifyEvent
+STATIC EFI_EVENT mBlessedInfoCacheNotifyEvent = NULL;
+
+// mBlessedInfoCacheNotifyRegistration
+STATIC VOID *mBlessedInfoCacheNotifyRegistration = NULL;
+
+// mBlessedInfoCacheValid
+STATIC BOOLEAN mBlessedInfoCacheValid = TRUE;
+
+// InternalFreeBlessedInfo
+STATIC
+VOID
+InternalFreeBlessedInfo (
+  IN OUT BOOT_POLICY_BLESSED_INFO  *Info
+  )
+{
+  if (Info->SystemFile != NULL) {
+    FreePool ((VOID *)Info->SystemFile);
+  }
+
+  if (Info->SystemFolder != NULL) {
+    FreePool ((VOID *)Info->SystemFolder);
+  }
+
+  ZeroMem ((VOID *)Info, sizeof (*Info));
+}
+
+// InternalBlessedInfoCacheNotifyFunction
+/** Invalidates all blessings as a file system has been installed or
+    reinstalled.  The entries are freed by the next lookup, as this may
+    preempt one copying them.
+**/
+STATIC
+VOID
+EFIAPI
+InternalBlessedInfoCacheNotifyFunction (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  mBlessedInfoCacheValid = FALSE;
+}
+
+// InternalValidateBlessedInfoCache
+STATIC
+VOID
+InternalValidateBlessedInfoCache (
+  VOID
+  )
+{
+  UINTN Index;
+
+  if (!mBlessedInfoCacheValid) {
+    mBlessedInfoCacheValid = TRUE;
+
+    for (Index = 0; Index < BLESSED_INFO_CACHE_MAX_ENTRIES; ++Index) {
+      InternalFreeBlessedInfo (&mBlessedInfoCache[Index]);
+    }
+
+    mNextBlessedInfoCacheEntry = 0;
+  }
+}
+
+// BootPolicyCreateBlessedInfoCache
+EFI_STATUS
+BootPolicyCreateBlessedInfoCache (
+  VOID
+  )
+{
+  EFI_STATUS Status;
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  InternalBlessedInfoCacheNotifyFunction,
+                  NULL,
+                  &mBlessedInfoCacheNotifyEvent
+                  );
+
+  if (!EFI_ERROR (Status)) {
+    Status = gBS->RegisterProtocolNotify (
+                    &gEfiSimpleFileSystemProtocolGuid,
+                    mBlessedInfoCacheNotifyEvent,
+                    &mBlessedInfoCacheNotifyRegistration
+                    );
+
+    if (EFI_ERROR (Status)) {
+      gBS->CloseEvent (mBlessedInfoCacheNotifyEvent);
+
+      mBlessedInfoCacheNotifyEvent = NULL;
+    }
+  }
+
+  return Status;
+}
+
+// BootPolicyGetBlessedInfo
+EFI_STATUS
+BootPolicyGetBlessedInfo (
+  IN  EFI_HANDLE                Device,
+  IN  EFI_FILE_PROTOCOL         *Root,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **SystemFile,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **SystemFolder OPTIONAL
+  )
+{
+  EFI_STATUS               Status;
+
+  UINTN                    Index;
+  BOOT_POLICY_BLESSED_INFO *Info;
+  BOOT_POLICY_BLESSED_INFO NewInfo;
+  VOID                     *Interface;
+
+  Info = NULL;
+
+  if (mBlessedInfoCacheNotifyEvent != NULL) {
+    InternalValidateBlessedInfoCache ();
+
+    for (Index = 0; Index < BLESSED_INFO_CACHE_MAX_ENTRIES; ++Index) {
+      if (mBlessedInfoCache[Index].Device == Device) {
+        Info = &mBlessedInfoCache[Index];
+
+        //
+        // The UEFI specification offers no notification for protocol
+        // removal, verify the file system is still present.
+        //
+        Status = gBS->HandleProtocol (
+                        Device,
+                        &gEfiSimpleFileSystemProtocolGuid,
+                        &Interface
+                        );
+
+        if (EFI_ERROR (Status)) {
+          InternalFreeBlessedInfo (Info);
+
+          Info = NULL;
+        }
+
+        break;
+      }
+    }
+  }
+
+  if (Info == NULL) {
+    //
+    // Both blessings are queried together, so that every GetBootFile*()
+    // variant is served from the same query.
+    //
+    NewInfo.Device       = Device;
+    NewInfo.SystemFile   = InternalGetFileInfo (
+                             Root,
+                             &gAppleBlessedSystemFileInfoGuid
+                             );
+    NewInfo.SystemFolder = InternalGetFileInfo (
+                             Root,
+                             &gAppleBlessedSystemFolderInfoGuid
+                             );
+
+    Info = &NewInfo;
+
+    if (mBlessedInfoCacheNotifyEvent != NULL) {
+      Info = &mBlessedInfoCache[mNextBlessedInfoCacheEntry];
+
+      mNextBlessedInfoCacheEntry = ((mNextBlessedInfoCacheEntry + 1)
+                                      % BLESSED_INFO_CACHE_MAX_ENTRIES);
+
+      InternalFreeBlessedInfo (Info);
+      CopyMem ((VOID *)Info, (VOID *)&NewInfo, sizeof (*Info));
+    }
+  }
+
+  *SystemFile = NULL;
+
+  if (SystemFolder != NULL) {
+    *SystemFolder = NULL;
+  }
+
+  Status = EFI_SUCCESS;
+
+  if (Info->SystemFile != NULL) {
+    *SystemFile = AllocateCopyPool (
+                    GetDevicePathSize (Info->SystemFile),
+                    (VOID *)Info->SystemFile
+                    );
+
+    if (*SystemFile == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  if ((SystemFolder != NULL)
+   && (Info->SystemFolder != NULL)
+   && !EFI_ERROR (Status)) {
+    *SystemFolder = AllocateCopyPool (
+                      GetDevicePathSize (Info->SystemFolder),
+                      (VOID *)Info->SystemFolder
+                      );
+
+    if (*SystemFolder == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  if (Info == &NewInfo) {
+    InternalFreeBlessedInfo (Info);
+  }
+
+  return Status;
+}
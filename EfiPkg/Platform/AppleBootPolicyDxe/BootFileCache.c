@@ -0,0 +1,256 @@
+#include <AppleMacEfi.h>
+
+#include <Guid/AppleApfsInfo.h>
+#include <Guid/AppleBootPolicyVariable.h>
+
+#include <Protocol/SimpleFileSystem.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+
+#include "AppleBootPolicyInternal.h"
+
+#pragma pack (1)
+
+// BOOT_FILE_CACHE_ENTRY
+/// A cache entry mapping a volume to the index of its fallback boot file
+/// within the boot path names searched.
+typedef PACKED struct {
+  GUID  VolumeKey;
+  UINT8 BootPathIndex;
+} BOOT_FILE_CACHE_ENTRY;
+
+#pragma pack ()
+
+// BOOT_FILE_CACHE_MAX_ENTRIES
+/// The number of volumes cached.  Entries are only evicted for volumes not
+/// seen during the current boot, hence this limits how many volumes can be
+/// cached at once without rewriting the variable on every boot.
+#define BOOT_FILE_CACHE_MAX_ENTRIES  16
+
+// mBootFileCache
+STATIC BOOT_FILE_CACHE_ENTRY mBootFileCache[BOOT_FILE_CACHE_MAX_ENTRIES];
+
+// mBootFileCacheNumberOfEntries
+STATIC UINTN mBootFileCacheNumberOfEntries = 0;
+
+// mBootFileCacheUsed
+/// A bit per entry set when the volume of the entry has been looked up or
+/// updated during the current boot.
+STATIC UINT32 mBootFileCacheUsed = 0;
+
+// mBootFileCacheLoaded
+STATIC BOOLEAN mBootFileCacheLoaded = FALSE;
+
+// InternalLoadBootFileCache
+/** Reads the boot file cache variable once.  A trailing partial entry is
+    ignored.
+**/
+STATIC
+VOID
+InternalLoadBootFileCache (
+  VOID
+  )
+{
+  EFI_STATUS Status;
+
+  UINTN      Size;
+
+  if (mBootFileCacheLoaded) {
+    return;
+  }
+
+  mBootFileCacheLoaded = TRUE;
+
+  Size   = sizeof (mBootFileCache);
+  Status = gRT->GetVariable (
+                  APPLE_BOOT_POLICY_FILE_CACHE_VARIABLE_NAME,
+                  &gAppleBootPolicyVariableGuid,
+                  NULL,
+                  &Size,
+                  (VOID *)&mBootFileCache[0]
+                  );
+
+  if (EFI_ERROR (Status)) {
+    Size = 0;
+  }
+
+  mBootFileCacheNumberOfEntries = (Size / sizeof (mBootFileCache[0]));
+}
+
+// InternalFindBootFileCacheEntry
+/** Locates the entry of VolumeKey and marks it used during this boot.
+
+  @return  The index of the entry, or mBootFileCacheNumberOfEntries if the
+           volume is not cached.
+**/
+STATIC
+UINTN
+InternalFindBootFileCacheEntry (
+  IN CONST GUID  *VolumeKey
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < mBootFileCacheNumberOfEntries; ++Index) {
+    if (CompareGuid (&mBootFileCache[Index].VolumeKey, VolumeKey)) {
+      mBootFileCacheUsed |= (1U << Index);
+
+      break;
+    }
+  }
+
+  return Index;
+}
+
+// BootPolicyGetBootFileCacheKey
+EFI_STATUS
+BootPolicyGetBootFileCacheKey (
+  IN  EFI_HANDLE         Device,
+  IN  EFI_FILE_PROTOCOL  *Root,
+  OUT GUID               *VolumeKey
+  )
+{
+  EFI_STATUS               Status;
+
+  APPLE_APFS_VOLUME_INFO   *VolumeInfo;
+  EFI_DEVICE_PATH_PROTOCOL *DevicePath;
+  HARDDRIVE_DEVICE_PATH    *HardDrive;
+
+  //
+  // Query the opened root rather than the APFS volume cache, which may scan
+  // every file system present to answer a lookup on a FAT or HFS+ volume.
+  //
+  VolumeInfo = InternalGetFileInfo (Root, &gAppleApfsVolumeInfoGuid);
+
+  if (VolumeInfo != NULL) {
+    CopyGuid (VolumeKey, &VolumeInfo->Uuid);
+
+    FreePool ((VOID *)VolumeInfo);
+
+    return EFI_SUCCESS;
+  }
+
+  Status     = EFI_NOT_FOUND;
+  DevicePath = DevicePathFromHandle (Device);
+
+  if (DevicePath != NULL) {
+    while (!IsDevicePathEnd (DevicePath)) {
+      if ((DevicePathType (DevicePath) == MEDIA_DEVICE_PATH)
+       && (DevicePathSubType (DevicePath) == MEDIA_HARDDRIVE_DP)) {
+        HardDrive = (HARDDRIVE_DEVICE_PATH *)DevicePath;
+
+        if (HardDrive->SignatureType == SIGNATURE_TYPE_GUID) {
+          CopyMem (
+            (VOID *)VolumeKey,
+            (VOID *)&HardDrive->Signature[0],
+            sizeof (*VolumeKey)
+            );
+
+          Status = EFI_SUCCESS;
+        }
+
+        break;
+      }
+
+      DevicePath = NextDevicePathNode (DevicePath);
+    }
+  }
+
+  return Status;
+}
+
+// BootPolicyGetCachedBootPathIndex
+EFI_STATUS
+BootPolicyGetCachedBootPathIndex (
+  IN  CONST GUID  *VolumeKey,
+  OUT UINTN       *BootPathIndex
+  )
+{
+  UINTN Index;
+
+  InternalLoadBootFileCache ();
+
+  Index = InternalFindBootFileCacheEntry (VolumeKey);
+
+  if (Index == mBootFileCacheNumberOfEntries) {
+    return EFI_NOT_FOUND;
+  }
+
+  *BootPathIndex = mBootFileCache[Index].BootPathIndex;
+
+  return EFI_SUCCESS;
+}
+
+// BootPolicyUpdateBootFileCache
+VOID
+BootPolicyUpdateBootFileCache (
+  IN CONST GUID  *VolumeKey,
+  IN UINTN       BootPathIndex
+  )
+{
+  EFI_STATUS            Status;
+
+  UINTN                 Index;
+  UINTN                 NumberOfEntries;
+  BOOT_FILE_CACHE_ENTRY Entry;
+
+  if (BootPathIndex > MAX_UINT8) {
+    return;
+  }
+
+  InternalLoadBootFileCache ();
+
+  //
+  // Only write the variable when the resolution has changed to spare the
+  // flash.  Entries keep their position, so that lookups never cause writes.
+  //
+  Index = InternalFindBootFileCacheEntry (VolumeKey);
+
+  if (Index < mBootFileCacheNumberOfEntries) {
+    if (mBootFileCache[Index].BootPathIndex == BootPathIndex) {
+      return;
+    }
+  } else if (mBootFileCacheNumberOfEntries == BOOT_FILE_CACHE_MAX_ENTRIES) {
+    //
+    // Replace the first entry of a volume not seen during this boot.  If all
+    // volumes have been seen, the new volume is not cached, as it would only
+    // evict another one present on every boot.
+    //
+    for (Index = 0; Index < mBootFileCacheNumberOfEntries; ++Index) {
+      if ((mBootFileCacheUsed & (1U << Index)) == 0) {
+        break;
+      }
+    }
+
+    if (Index == mBootFileCacheNumberOfEntries) {
+      return;
+    }
+  }
+
+  CopyMem ((VOID *)&Entry, (VOID *)&mBootFileCache[Index], sizeof (Entry));
+
+  CopyGuid (&mBootFileCache[Index].VolumeKey, VolumeKey);
+  mBootFileCache[Index].BootPathIndex = (UINT8)BootPathIndex;
+
+  NumberOfEntries = MAX (mBootFileCacheNumberOfEntries, (Index + 1));
+
+  Status = gRT->SetVariable (
+                  APPLE_BOOT_POLICY_FILE_CACHE_VARIABLE_NAME,
+                  &gAppleBootPolicyVariableGuid,
+                  (EFI_VARIABLE_NON_VOLATILE
+                    | EFI_VARIABLE_BOOTSERVICE_ACCESS),
+                  (NumberOfEntries * sizeof (mBootFileCache[0])),
+                  (VOID *)&mBootFileCache[0]
+                  );
+
+  if (!EFI_ERROR (Status)) {
+    mBootFileCacheNumberOfEntries = NumberOfEntries;
+    mBootFileCacheUsed           |= (1U << Index);
+  } else {
+    CopyMem ((VOID *)&mBootFileCache[Index], (VOID *)&Entry, sizeof (Entry));
+  }
+}
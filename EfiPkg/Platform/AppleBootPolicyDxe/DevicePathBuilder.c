@@ -0,0 +1,447 @@
+#include <AppleMacEfi.h>
+
+#include <Protocol/DevicePath.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#include "AppleBootPolicyInternal.h"
+
+// InternalGetDevicePathInstanceSize
+/** Returns the size of the first instance of DevicePath, excluding its end
+    node.
+**/
+STATIC
+UINTN
+InternalGetDevicePathInstanceSize (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  )
+{
+  CONST EFI_DEVICE_PATH_PROTOCOL *Walker;
+
+  Walker = DevicePath;
+
+  while (!IsDevicePathEndType (Walker)) {
+    Walker = NextDevicePathNode (Walker);
+  }
+
+  return (UINTN)((UINT8 *)Walker - (UINT8 *)DevicePath);
+}
+
+// InternalReserveDevicePathBuilder
+/** Ensures Size bytes are available behind the committed instances.  The
+    buffer is only moved into pool memory once the caller's buffer is
+    exhausted.
+**/
+STATIC
+EFI_STATUS
+InternalReserveDevicePathBuilder (
+  IN OUT BOOT_POLICY_DEVICE_PATH_BUILDER  *Builder,
+  IN     UINTN                            Size
+  )
+{
+  UINTN NewBufferSize;
+  UINT8 *NewBuffer;
+
+  if ((Builder->BufferSize - Builder->Size) >= Size) {
+    return EFI_SUCCESS;
+  }
+
+  NewBufferSize = (Builder->BufferSize * 2);
+
+  if (NewBufferSize < (Builder->Size + Size)) {
+    NewBufferSize = (Builder->Size + Size);
+  }
+
+  NewBuffer = AllocatePool (NewBufferSize);
+
+  if (NewBuffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CopyMem ((VOID *)NewBuffer, (VOID *)Builder->Buffer, Builder->Size);
+
+  if (Builder->BufferAllocated) {
+    FreePool ((VOID *)Builder->Buffer);
+  }
+
+  Builder->Buffer          = NewBuffer;
+  Builder->BufferSize      = NewBufferSize;
+  Builder->BufferAllocated = TRUE;
+
+  return EFI_SUCCESS;
+}
+
+// InternalHashDevicePathInstance
+/** Returns the non-zero 32-bit FNV-1a hash of an instance.
+**/
+STATIC
+UINT32
+InternalHashDevicePathInstance (
+  IN CONST UINT8  *Instance,
+  IN UINTN        InstanceSize
+  )
+{
+  UINT32 Hash;
+  UINTN  Index;
+
+  Hash = 0x811C9DC5;
+
+  for (Index = 0; Index < InstanceSize; ++Index) {
+    Hash ^= Instance[Index];
+    Hash *= 0x01000193;
+  }
+
+  return ((Hash != 0) ? Hash : 1);
+}
+
+// InternalFindDevicePathSlot
+/** Locates the slot of the instance equal to Instance, or the free slot it
+    is to be inserted at.  If Instance is NULL, the first free slot of the
+    probe sequence is returned.
+**/
+STATIC
+BOOT_POLICY_DEVICE_PATH_SLOT *
+InternalFindDevicePathSlot (
+  IN CONST BOOT_POLICY_DEVICE_PATH_BUILDER  *Builder,
+  IN CONST BOOT_POLICY_DEVICE_PATH_SLOT     *Slots,
+  IN UINTN                                  NumberOfSlots,
+  IN UINT32                                 Hash,
+  IN CONST UINT8                            *Instance,
+  IN UINTN                                  InstanceSize
+  )
+{
+  UINTN Index;
+
+  Index = (Hash & (NumberOfSlots - 1));
+
+  while (Slots[Index].Hash != 0) {
+    if ((Instance != NULL)
+     && (Slots[Index].Hash == Hash)
+     && (Slots[Index].Size == InstanceSize)
+     && (CompareMem (
+           (VOID *)&Builder->Buffer[Slots[Index].Offset],
+           (VOID *)Instance,
+           InstanceSize
+           ) == 0)) {
+      break;
+    }
+
+    Index = ((Index + 1) & (NumberOfSlots - 1));
+  }
+
+  return (BOOT_POLICY_DEVICE_PATH_SLOT *)&Slots[Index];
+}
+
+// InternalGrowDevicePathSlots
+STATIC
+EFI_STATUS
+InternalGrowDevicePathSlots (
+  IN OUT BOOT_POLICY_DEVICE_PATH_BUILDER  *Builder
+  )
+{
+  BOOT_POLICY_DEVICE_PATH_SLOT *Slots;
+  UINTN                        NumberOfSlots;
+  UINTN                        Index;
+  BOOT_POLICY_DEVICE_PATH_SLOT *Slot;
+
+  NumberOfSlots = (Builder->NumberOfSlots * 2);
+  Slots         = AllocateZeroPool (NumberOfSlots * sizeof (*Slots));
+
+  if (Slots == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Committed instances are unique, hence they are not compared while
+  // rehashing.
+  //
+  for (Index = 0; Index < Builder->NumberOfSlots; ++Index) {
+    if (Builder->Slots[Index].Hash != 0) {
+      Slot = InternalFindDevicePathSlot (
+               Builder,
+               Slots,
+               NumberOfSlots,
+               Builder->Slots[Index].Hash,
+               NULL,
+               0
+               );
+
+      CopyMem ((VOID *)Slot, (VOID *)&Builder->Slots[Index], sizeof (*Slot));
+    }
+  }
+
+  if (Builder->Slots != &Builder->InlineSlots[0]) {
+    FreePool ((VOID *)Builder->Slots);
+  }
+
+  Builder->Slots         = Slots;
+  Builder->NumberOfSlots = NumberOfSlots;
+
+  return EFI_SUCCESS;
+}
+
+// InternalCommitDevicePathInstance
+/** Commits the instance composed behind the committed instances unless an
+    equal instance has been committed before.
+**/
+STATIC
+EFI_STATUS
+InternalCommitDevicePathInstance (
+  IN OUT BOOT_POLICY_DEVICE_PATH_BUILDER  *Builder,
+  IN     UINTN                            InstanceSize
+  )
+{
+  EFI_STATUS                   Status;
+
+  UINT8                        *Instance;
+  UINT32                       Hash;
+  BOOT_POLICY_DEVICE_PATH_SLOT *Slot;
+  EFI_DEVICE_PATH_PROTOCOL     *EndNode;
+
+  Instance = &Builder->Buffer[Builder->Size];
+  Hash     = InternalHashDevicePathInstance (Instance, InstanceSize);
+  Slot     = InternalFindDevicePathSlot (
+               Builder,
+               Builder->Slots,
+               Builder->NumberOfSlots,
+               Hash,
+               Instance,
+               InstanceSize
+               );
+
+  if (Slot->Hash != 0) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Keep the load factor below 3/4 so that probe sequences stay short.  The
+  // current index is used as long as it has a free slot left.
+  //
+  if (((Builder->NumberOfInstances + 1) * 4) > (Builder->NumberOfSlots * 3)) {
+    Status = InternalGrowDevicePathSlots (Builder);
+
+    if (!EFI_ERROR (Status)) {
+      Slot = InternalFindDevicePathSlot (
+               Builder,
+               Builder->Slots,
+               Builder->NumberOfSlots,
+               Hash,
+               NULL,
+               0
+               );
+    } else if ((Builder->NumberOfInstances + 1) >= Builder->NumberOfSlots) {
+      return Status;
+    }
+  }
+
+  Slot->Hash   = Hash;
+  Slot->Offset = (UINT32)Builder->Size;
+  Slot->Size   = (UINT32)InstanceSize;
+
+  ++Builder->NumberOfInstances;
+
+  EndNode          = (EFI_DEVICE_PATH_PROTOCOL *)&Instance[InstanceSize];
+  EndNode->Type    = END_DEVICE_PATH_TYPE;
+  EndNode->SubType = END_INSTANCE_DEVICE_PATH_SUBTYPE;
+
+  SetDevicePathNodeLength (EndNode, END_DEVICE_PATH_LENGTH);
+
+  Builder->Size += (InstanceSize + END_DEVICE_PATH_LENGTH);
+
+  return EFI_SUCCESS;
+}
+
+// BootPolicyInitDevicePathBuilder
+VOID
+BootPolicyInitDevicePathBuilder (
+  OUT BOOT_POLICY_DEVICE_PATH_BUILDER  *Builder,
+  IN  VOID                             *Buffer,
+  IN  UINTN                            BufferSize
+  )
+{
+  Builder->Buffer          = (UINT8 *)Buffer;
+  Builder->BufferSize      = BufferSize;
+  Builder->Size            = 0;
+  Builder->BufferAllocated = FALSE;
+
+  ZeroMem ((VOID *)&Builder->InlineSlots[0], sizeof (Builder->InlineSlots));
+
+  Builder->Slots             = &Builder->InlineSlots[0];
+  Builder->NumberOfSlots     = ARRAY_SIZE (Builder->InlineSlots);
+  Builder->NumberOfInstances = 0;
+}
+
+// BootPolicyAppendDevicePathInstances
+EFI_STATUS
+BootPolicyAppendDevicePathInstances (
+  IN OUT BOOT_POLICY_DEVICE_PATH_BUILDER  *Builder,
+  IN     CONST EFI_DEVICE_PATH_PROTOCOL   *DevicePath
+  )
+{
+  EFI_STATUS                     Status;
+
+  CONST EFI_DEVICE_PATH_PROTOCOL *Walker;
+  UINTN                          InstanceSize;
+
+  Status = EFI_SUCCESS;
+  Walker = DevicePath;
+
+  while (TRUE) {
+    InstanceSize = InternalGetDevicePathInstanceSize (Walker);
+
+    if (InstanceSize > 0) {
+      Status = InternalReserveDevicePathBuilder (
+                 Builder,
+                 (InstanceSize + END_DEVICE_PATH_LENGTH)
+                 );
+
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+
+      CopyMem (
+        (VOID *)&Builder->Buffer[Builder->Size],
+        (VOID *)Walker,
+        InstanceSize
+        );
+
+      Status = InternalCommitDevicePathInstance (Builder, InstanceSize);
+
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+    }
+
+    Walker = (CONST EFI_DEVICE_PATH_PROTOCOL *)(
+               (UINT8 *)Walker + InstanceSize
+               );
+
+    if (!IsDevicePathEndInstance (Walker)) {
+      break;
+    }
+
+    Walker = NextDevicePathNode (Walker);
+  }
+
+  return Status;
+}
+
+// BootPolicyAppendFilePathInstance
+EFI_STATUS
+BootPolicyAppendFilePathInstance (
+  IN OUT BOOT_POLICY_DEVICE_PATH_BUILDER  *Builder,
+  IN     EFI_HANDLE                       Device,
+  IN     CONST CHAR16                     *DirectoryName,
+  IN     CONST CHAR16                     *FileName
+  )
+{
+  EFI_STATUS                     Status;
+
+  CONST EFI_DEVICE_PATH_PROTOCOL *DevicePath;
+  UINTN                          PrefixSize;
+  UINTN                          DirectoryNameSize;
+  UINTN                          FileNameSize;
+  UINTN                          NodeSize;
+  UINT8                          *Instance;
+  FILEPATH_DEVICE_PATH           *FilePath;
+  UINT8                          *PathName;
+  CHAR16                         Separator;
+
+  PrefixSize = 0;
+  DevicePath = DevicePathFromHandle (Device);
+
+  if (DevicePath != NULL) {
+    PrefixSize = InternalGetDevicePathInstanceSize (DevicePath);
+  }
+
+  DirectoryNameSize = (StrLen (DirectoryName) * sizeof (*DirectoryName));
+  FileNameSize      = StrSize (FileName);
+  NodeSize          = (SIZE_OF_FILEPATH_DEVICE_PATH
+                        + sizeof (CHAR16)
+                        + DirectoryNameSize
+                        + FileNameSize);
+
+  if (NodeSize > MAX_UINT16) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = InternalReserveDevicePathBuilder (
+             Builder,
+             (PrefixSize + NodeSize + END_DEVICE_PATH_LENGTH)
+             );
+
+  if (!EFI_ERROR (Status)) {
+    Instance = &Builder->Buffer[Builder->Size];
+
+    CopyMem ((VOID *)Instance, (VOID *)DevicePath, PrefixSize);
+
+    //
+    // Compose "\<DirectoryName><FileName>" in place, matching the node
+    // FileDevicePath() would have created.
+    //
+    FilePath                 = (FILEPATH_DEVICE_PATH *)&Instance[PrefixSize];
+    FilePath->Header.Type    = MEDIA_DEVICE_PATH;
+    FilePath->Header.SubType = MEDIA_FILEPATH_DP;
+
+    SetDevicePathNodeLength (&FilePath->Header, NodeSize);
+
+    PathName  = (UINT8 *)&FilePath->PathName[0];
+    Separator = L'\\';
+
+    CopyMem ((VOID *)PathName, (VOID *)&Separator, sizeof (Separator));
+
+    PathName += sizeof (Separator);
+
+    CopyMem ((VOID *)PathName, (VOID *)DirectoryName, DirectoryNameSize);
+
+    PathName += DirectoryNameSize;
+
+    CopyMem ((VOID *)PathName, (VOID *)FileName, FileNameSize);
+
+    Status = InternalCommitDevicePathInstance (
+               Builder,
+               (PrefixSize + NodeSize)
+               );
+  }
+
+  return Status;
+}
+
+// BootPolicyFinishDevicePathBuilder
+EFI_STATUS
+BootPolicyFinishDevicePathBuilder (
+  IN OUT BOOT_POLICY_DEVICE_PATH_BUILDER  *Builder,
+  OUT    EFI_DEVICE_PATH_PROTOCOL         **DevicePath
+  )
+{
+  EFI_STATUS Status;
+
+  *DevicePath = NULL;
+
+  Status = EFI_NOT_FOUND;
+
+  if (Builder->Size > 0) {
+    SetDevicePathEndNode (
+      (VOID *)&Builder->Buffer[Builder->Size - END_DEVICE_PATH_LENGTH]
+      );
+
+    *DevicePath = AllocateCopyPool (Builder->Size, (VOID *)Builder->Buffer);
+
+    Status = ((*DevicePath != NULL) ? EFI_SUCCESS : EFI_OUT_OF_RESOURCES);
+  }
+
+  if (Builder->BufferAllocated) {
+    FreePool ((VOID *)Builder->Buffer);
+  }
+
+  if (Builder->Slots != &Builder->InlineSlots[0]) {
+    FreePool ((VOID *)Builder->Slots);
+  }
+
+  BootPolicyInitDevicePathBuilder (Builder, NULL, 0);
+
+  return Status;
+}
@@ -0,0 +1,127 @@
+#include <AppleMacEfi.h>
+
+#include <Library/BaseMemoryLib.h>
+
+#include "AppleBootPolicyInternal.h"
+
+// mGuidByteOrder
+/// The order the bytes of an EFI_GUID are formatted in by "%g".
+STATIC CONST UINT8 mGuidByteOrder[sizeof (EFI_GUID)] = {
+  3, 2, 1, 0, 5, 4, 7, 6, 8, 9, 10, 11, 12, 13, 14, 15
+};
+
+// mHexDigits
+STATIC CONST CHAR16 mHexDigits[] = L"0123456789ABCDEF";
+
+// InternalIsGuidSeparator
+/** Returns whether a dash precedes the byte at Index in mGuidByteOrder.
+**/
+STATIC
+BOOLEAN
+InternalIsGuidSeparator (
+  IN UINTN  Index
+  )
+{
+  return (BOOLEAN)(
+           (Index == 4) || (Index == 6) || (Index == 8) || (Index == 10)
+           );
+}
+
+// InternalHexDigitValue
+STATIC
+INTN
+InternalHexDigitValue (
+  IN CHAR16  Char
+  )
+{
+  if ((Char >= L'0') && (Char <= L'9')) {
+    return (Char - L'0');
+  }
+
+  if ((Char >= L'A') && (Char <= L'F')) {
+    return ((Char - L'A') + 10);
+  }
+
+  if ((Char >= L'a') && (Char <= L'f')) {
+    return ((Char - L'a') + 10);
+  }
+
+  return -1;
+}
+
+// BootPolicyStrToGuid
+EFI_STATUS
+BootPolicyStrToGuid (
+  IN  CONST CHAR16  *String,
+  OUT EFI_GUID      *Guid
+  )
+{
+  EFI_GUID Result;
+  UINT8    *Bytes;
+  UINTN    Index;
+  INTN     High;
+  INTN     Low;
+
+  Bytes = (UINT8 *)&Result;
+
+  //
+  // The characters are validated in order, hence a terminator is rejected
+  // before reading past it.
+  //
+  for (Index = 0; Index < sizeof (Result); ++Index) {
+    if (InternalIsGuidSeparator (Index)) {
+      if (*String != L'-') {
+        return EFI_INVALID_PARAMETER;
+      }
+
+      ++String;
+    }
+
+    High = InternalHexDigitValue (String[0]);
+
+    if (High < 0) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Low = InternalHexDigitValue (String[1]);
+
+    if (Low < 0) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Bytes[mGuidByteOrder[Index]] = (UINT8)((High << 4) | Low);
+
+    String += 2;
+  }
+
+  CopyGuid (Guid, &Result);
+
+  return EFI_SUCCESS;
+}
+
+// BootPolicyGuidToStr
+VOID
+BootPolicyGuidToStr (
+  IN  CONST EFI_GUID  *Guid,
+  OUT CHAR16          *String
+  )
+{
+  CONST UINT8 *Bytes;
+  UINTN       Index;
+  UINT8       Byte;
+
+  Bytes = (CONST UINT8 *)Guid;
+
+  for (Index = 0; Index < sizeof (*Guid); ++Index) {
+    if (InternalIsGuidSeparator (Index)) {
+      *(String++) = L'-';
+    }
+
+    Byte = Bytes[mGuidByteOrder[Index]];
+
+    *(String++) = mHexDigits[Byte >> 4];
+    *(String++) = mHexDigits[Byte & 0x0F];
+  }
+
+  *String = L'\0';
+}
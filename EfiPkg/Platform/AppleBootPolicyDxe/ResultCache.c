@@ -0,0 +1,479 @@
+#include <AppleMacEfi.h>
+
+#include <Protocol/BlockIo.h>
+#include <Protocol/SimpleFileSystem.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "AppleBootPolicyInternal.h"
+
+// RESULT_CACHE_MAX_ENTRIES
+#define RESULT_CACHE_MAX_ENTRIES  16
+
+// RESULT_CACHE_MODE_BOOT_INFO
+/// The mode GetBootInfo() results are stored with, distinct from all modes
+/// of GetBootFileEx().
+#define RESULT_CACHE_MODE_BOOT_INFO  MAX_UINT32
+
+// RESULT_CACHE_ENTRY
+/// A memoized result.  DevicePath is NULL for unused entries.  FilePath holds
+/// the result of GetBootFileEx(), BootPathName and ApfsVolumeHandle the ones
+/// of GetBootInfo().
+typedef struct {
+  EFI_DEVICE_PATH_PROTOCOL *DevicePath;
+  UINTN                    DevicePathSize;
+  UINT32                   Mode;
+  EFI_HANDLE               Device;
+  BOOLEAN                  HasMedia;
+  UINT32                   MediaId;
+  EFI_DEVICE_PATH_PROTOCOL *FilePath;
+  CHAR16                   *BootPathName;
+  EFI_HANDLE               ApfsVolumeHandle;
+} RESULT_CACHE_ENTRY;
+
+// mResultCache
+STATIC RESULT_CACHE_ENTRY mResultCache[RESULT_CACHE_MAX_ENTRIES];
+
+// mNextResultCacheEntry
+STATIC UINTN mNextResultCacheEntry = 0;
+
+// mResultCacheNotifyEvent
+STATIC EFI_EVENT mResultCacheNotifyEvent = NULL;
+
+// mResultCacheNotifyRegistration
+STATIC VOID *mResultCacheNotifyRegistration = NULL;
+
+// mResultCacheValid
+STATIC BOOLEAN mResultCacheValid = TRUE;
+
+// InternalFreeResultCacheEntry
+STATIC
+VOID
+InternalFreeResultCacheEntry (
+  IN OUT RESULT_CACHE_ENTRY  *Entry
+  )
+{
+  if (Entry->DevicePath != NULL) {
+    FreePool ((VOID *)Entry->DevicePath);
+  }
+
+  if (Entry->FilePath != NULL) {
+    FreePool ((VOID *)Entry->FilePath);
+  }
+
+  if (Entry->BootPathName != NULL) {
+    FreePool ((VOID *)Entry->BootPathName);
+  }
+
+  ZeroMem ((VOID *)Entry, sizeof (*Entry));
+}
+
+// InternalResultCacheNotifyFunction
+/** Invalidates all results as a file system has been installed or
+    reinstalled, which may change the boot files of any volume.  The entries
+    are not freed here as this may preempt a lookup copying one of them.
+**/
+STATIC
+VOID
+EFIAPI
+InternalResultCacheNotifyFunction (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  mResultCacheValid = FALSE;
+}
+
+// InternalValidateResultCache
+/** Frees all results if the cache has been invalidated.
+
+  @return  Returned is whether the cache had been valid.
+**/
+STATIC
+BOOLEAN
+InternalValidateResultCache (
+  VOID
+  )
+{
+  UINTN Index;
+
+  if (mResultCacheValid) {
+    return TRUE;
+  }
+
+  //
+  // Validate the cache before flushing so that notifications raised
+  // meanwhile invalidate it again.
+  //
+  mResultCacheValid = TRUE;
+
+  for (Index = 0; Index < RESULT_CACHE_MAX_ENTRIES; ++Index) {
+    InternalFreeResultCacheEntry (&mResultCache[Index]);
+  }
+
+  mNextResultCacheEntry = 0;
+
+  return FALSE;
+}
+
+// InternalGetMediaId
+/** Retrieves the media ID of the block device Device resides on.
+
+  @param[in]  Device   The handle of the file system.
+  @param[out] MediaId  Receives the media ID.
+
+  @return  Returned is whether a block device has been found.
+**/
+STATIC
+BOOLEAN
+InternalGetMediaId (
+  IN  EFI_HANDLE  Device,
+  OUT UINT32      *MediaId
+  )
+{
+  EFI_STATUS               Status;
+
+  EFI_DEVICE_PATH_PROTOCOL *DevicePath;
+  EFI_HANDLE               BlockIoHandle;
+  EFI_BLOCK_IO_PROTOCOL    *BlockIo;
+
+  DevicePath = DevicePathFromHandle (Device);
+
+  if (DevicePath == NULL) {
+    return FALSE;
+  }
+
+  //
+  // APFS volumes do not carry a block device themselves, the one of their
+  // container is located instead.
+  //
+  Status = gBS->LocateDevicePath (
+                  &gEfiBlockIoProtocolGuid,
+                  &DevicePath,
+                  &BlockIoHandle
+                  );
+
+  if (!EFI_ERROR (Status)) {
+    Status = gBS->HandleProtocol (
+                    BlockIoHandle,
+                    &gEfiBlockIoProtocolGuid,
+                    (VOID **)&BlockIo
+                    );
+
+    if (!EFI_ERROR (Status)) {
+      if (BlockIo->Media->MediaPresent) {
+        *MediaId = BlockIo->Media->MediaId;
+
+        return TRUE;
+      }
+    }
+  }
+
+  return FALSE;
+}
+
+// InternalFindResultCacheEntry
+/** Locates the valid result of Mode for DevicePath.  Results of removed file
+    systems or exchanged media are dropped.
+
+  @param[in] DevicePath  The device path the result has been queried for.
+  @param[in] Mode        The mode the result has been queried with.
+
+  @return  The matching entry or NULL.
+**/
+STATIC
+RESULT_CACHE_ENTRY *
+InternalFindResultCacheEntry (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN UINT32                          Mode
+  )
+{
+  EFI_STATUS         Status;
+
+  UINTN              DevicePathSize;
+  UINTN              Index;
+  RESULT_CACHE_ENTRY *Entry;
+  VOID               *Interface;
+  UINT32             MediaId;
+  BOOLEAN            HasMedia;
+
+  if (mResultCacheNotifyEvent == NULL) {
+    //
+    // Without the notification reinstalled file systems are not detected.
+    //
+    return NULL;
+  }
+
+  InternalValidateResultCache ();
+
+  DevicePathSize = GetDevicePathSize (DevicePath);
+
+  for (Index = 0; Index < RESULT_CACHE_MAX_ENTRIES; ++Index) {
+    Entry = &mResultCache[Index];
+
+    if ((Entry->DevicePath == NULL)
+     || (Entry->Mode != Mode)
+     || (Entry->DevicePathSize != DevicePathSize)
+     || (CompareMem (
+           (VOID *)Entry->DevicePath,
+           (VOID *)DevicePath,
+           DevicePathSize
+           ) != 0)) {
+      continue;
+    }
+
+    Status = gBS->HandleProtocol (
+                    Entry->Device,
+                    &gEfiSimpleFileSystemProtocolGuid,
+                    &Interface
+                    );
+
+    if (!EFI_ERROR (Status)) {
+      HasMedia = InternalGetMediaId (Entry->Device, &MediaId);
+
+      if ((HasMedia == Entry->HasMedia)
+       && (!HasMedia || (MediaId == Entry->MediaId))) {
+        return Entry;
+      }
+    }
+
+    InternalFreeResultCacheEntry (Entry);
+
+    break;
+  }
+
+  return NULL;
+}
+
+// InternalAllocateResultCacheEntry
+/** Returns an entry for a new result of Mode for DevicePath, replacing the
+    oldest one if all are used.  No entry is returned if the cache has been
+    invalidated since the last lookup.
+
+  @param[in] DevicePath  The device path the result has been queried for.
+  @param[in] Mode        The mode the result has been queried with.
+  @param[in] Device      The handle of the file system.
+
+  @return  The entry or NULL if it could not be allocated.
+**/
+STATIC
+RESULT_CACHE_ENTRY *
+InternalAllocateResultCacheEntry (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN UINT32                          Mode,
+  IN EFI_HANDLE                      Device
+  )
+{
+  RESULT_CACHE_ENTRY *Entry;
+
+  if (mResultCacheNotifyEvent == NULL) {
+    return NULL;
+  }
+
+  //
+  // A result computed while a file system has been installed may already be
+  // stale and is not stored.
+  //
+  if (!InternalValidateResultCache ()) {
+    return NULL;
+  }
+
+  Entry = &mResultCache[mNextResultCacheEntry];
+
+  mNextResultCacheEntry = ((mNextResultCacheEntry + 1) % RESULT_CACHE_MAX_ENTRIES);
+
+  InternalFreeResultCacheEntry (Entry);
+
+  Entry->DevicePathSize = GetDevicePathSize (DevicePath);
+  Entry->DevicePath     = AllocateCopyPool (
+                            Entry->DevicePathSize,
+                            (VOID *)DevicePath
+                            );
+
+  if (Entry->DevicePath == NULL) {
+    return NULL;
+  }
+
+  Entry->Mode     = Mode;
+  Entry->Device   = Device;
+  Entry->HasMedia = InternalGetMediaId (Device, &Entry->MediaId);
+
+  return Entry;
+}
+
+// BootPolicyCreateResultCache
+EFI_STATUS
+BootPolicyCreateResultCache (
+  VOID
+  )
+{
+  EFI_STATUS Status;
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  InternalResultCacheNotifyFunction,
+                  NULL,
+                  &mResultCacheNotifyEvent
+                  );
+
+  if (!EFI_ERROR (Status)) {
+    Status = gBS->RegisterProtocolNotify (
+                    &gEfiSimpleFileSystemProtocolGuid,
+                    mResultCacheNotifyEvent,
+                    &mResultCacheNotifyRegistration
+                    );
+
+    if (EFI_ERROR (Status)) {
+      gBS->CloseEvent (mResultCacheNotifyEvent);
+
+      mResultCacheNotifyEvent = NULL;
+    }
+  }
+
+  return Status;
+}
+
+// BootPolicyLookupBootFileResult
+EFI_STATUS
+BootPolicyLookupBootFileResult (
+  IN  EFI_HANDLE                Device,
+  IN  UINT32                    Mode,
+  OUT EFI_DEVICE_PATH_PROTOCOL  **FilePath
+  )
+{
+  EFI_DEVICE_PATH_PROTOCOL *DevicePath;
+  RESULT_CACHE_ENTRY       *Entry;
+
+  DevicePath = DevicePathFromHandle (Device);
+
+  if (DevicePath != NULL) {
+    Entry = InternalFindResultCacheEntry (DevicePath, Mode);
+
+    if ((Entry != NULL) && (Entry->Device == Device)) {
+      *FilePath = AllocateCopyPool (
+                    GetDevicePathSize (Entry->FilePath),
+                    (VOID *)Entry->FilePath
+                    );
+
+      if (*FilePath != NULL) {
+        return EFI_SUCCESS;
+      }
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+// BootPolicyStoreBootFileResult
+VOID
+BootPolicyStoreBootFileResult (
+  IN EFI_HANDLE                      Device,
+  IN UINT32                          Mode,
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *FilePath
+  )
+{
+  EFI_DEVICE_PATH_PROTOCOL *DevicePath;
+  RESULT_CACHE_ENTRY       *Entry;
+
+  DevicePath = DevicePathFromHandle (Device);
+
+  if (DevicePath != NULL) {
+    Entry = InternalAllocateResultCacheEntry (DevicePath, Mode, Device);
+
+    if (Entry != NULL) {
+      Entry->FilePath = AllocateCopyPool (
+                          GetDevicePathSize (FilePath),
+                          (VOID *)FilePath
+                          );
+
+      if (Entry->FilePath == NULL) {
+        InternalFreeResultCacheEntry (Entry);
+      }
+    }
+  }
+}
+
+// BootPolicyLookupBootInfoResult
+EFI_STATUS
+BootPolicyLookupBootInfoResult (
+  IN  CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  OUT CHAR16                          **BootPathName,
+  OUT EFI_HANDLE                      *Device,
+  OUT EFI_HANDLE                      *ApfsVolumeHandle
+  )
+{
+  EFI_STATUS         Status;
+
+  RESULT_CACHE_ENTRY *Entry;
+  VOID               *Interface;
+
+  Entry = InternalFindResultCacheEntry (
+            DevicePath,
+            RESULT_CACHE_MODE_BOOT_INFO
+            );
+
+  if ((Entry != NULL) && (Entry->ApfsVolumeHandle != NULL)) {
+    Status = gBS->HandleProtocol (
+                    Entry->ApfsVolumeHandle,
+                    &gEfiSimpleFileSystemProtocolGuid,
+                    &Interface
+                    );
+
+    if (EFI_ERROR (Status)) {
+      InternalFreeResultCacheEntry (Entry);
+
+      Entry = NULL;
+    }
+  }
+
+  if (Entry != NULL) {
+    *BootPathName = AllocateCopyPool (
+                      StrSize (Entry->BootPathName),
+                      (VOID *)Entry->BootPathName
+                      );
+
+    if (*BootPathName != NULL) {
+      *Device           = Entry->Device;
+      *ApfsVolumeHandle = Entry->ApfsVolumeHandle;
+
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+// BootPolicyStoreBootInfoResult
+VOID
+BootPolicyStoreBootInfoResult (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN CONST CHAR16                    *BootPathName,
+  IN EFI_HANDLE                      Device,
+  IN EFI_HANDLE                      ApfsVolumeHandle
+  )
+{
+  RESULT_CACHE_ENTRY *Entry;
+
+  Entry = InternalAllocateResultCacheEntry (
+            DevicePath,
+            RESULT_CACHE_MODE_BOOT_INFO,
+            Device
+            );
+
+  if (Entry != NULL) {
+    Entry->ApfsVolumeHandle = ApfsVolumeHandle;
+    Entry->BootPathName     = AllocateCopyPool (
+                                StrSize (BootPathName),
+                                (VOID *)BootPathName
+                                );
+
+    if (Entry->BootPathName == NULL) {
+      InternalFreeResultCacheEntry (Entry);
+    }
+  }
+}
@@ -0,0 +1,214 @@
+#include <AppleMacEfi.h>
+
+#include <Guid/AppleBootPolicyStatistics.h>
+
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "AppleBootPolicyInternal.h"
+
+// mStatistics
+STATIC APPLE_BOOT_POLICY_STATISTICS *mStatistics = NULL;
+
+// mActiveFunction
+STATIC APPLE_BOOT_POLICY_FUNCTION_STATISTICS *mActiveFunction = NULL;
+
+// mStatisticsReportEvent
+STATIC EFI_EVENT mStatisticsReportEvent = NULL;
+
+// mFunctionNames
+STATIC CONST CHAR8 *mFunctionNames[] = {
+  "GetBootFile",
+  "GetBootFileEx",
+  "GetBootInfo",
+  "GetPathNameOnApfsRecovery",
+  "GetApfsRecoveryVolumes",
+  "GetNextVolume",
+  "GetVolumesByRole"
+};
+
+// InternalStatisticsReportNotifyFunction
+/** Reports the statistics of all functions called to the debug log once boot
+    services are exited, so that a boot can be compared with others as the
+    number of volumes changes.
+**/
+STATIC
+VOID
+EFIAPI
+InternalStatisticsReportNotifyFunction (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  UINTN                                       Index;
+  UINTN                                       Bucket;
+  CONST CHAR8                                 *Name;
+  CONST APPLE_BOOT_POLICY_FUNCTION_STATISTICS *Function;
+
+  for (Index = 0; Index < ARRAY_SIZE (mFunctionNames); ++Index) {
+    Name     = mFunctionNames[Index];
+    Function = &mStatistics->Functions[Index];
+
+    if (Function->Calls == 0) {
+      continue;
+    }
+
+    DEBUG ((
+      EFI_D_INFO,
+      "BootPolicy: %a calls %Ld handles %Ld open %Ld getinfo %Ld time %Ld ns max %Ld ns\n",
+      Name,
+      Function->Calls,
+      Function->HandlesScanned,
+      Function->OpenCalls,
+      Function->GetInfoCalls,
+      Function->TotalTime,
+      Function->MaximumTime
+      ));
+
+    for (Bucket = 0; Bucket < APPLE_BOOT_POLICY_LATENCY_BUCKETS; ++Bucket) {
+      if (Function->LatencyHistogram[Bucket] > 0) {
+        DEBUG ((
+          EFI_D_INFO,
+          "BootPolicy: %a < %Ld us: %Ld\n",
+          Name,
+          LShiftU64 (1, Bucket),
+          Function->LatencyHistogram[Bucket]
+          ));
+      }
+    }
+  }
+}
+
+// BootPolicyCreateStatistics
+EFI_STATUS
+BootPolicyCreateStatistics (
+  VOID
+  )
+{
+  EFI_STATUS Status;
+
+  mStatistics = AllocateRuntimeZeroPool (sizeof (*mStatistics));
+
+  Status = EFI_OUT_OF_RESOURCES;
+
+  if (mStatistics != NULL) {
+    mStatistics->Revision          = APPLE_BOOT_POLICY_STATISTICS_REVISION;
+    mStatistics->NumberOfFunctions = AppleBootPolicyFunctionMaximum;
+
+    Status = gBS->InstallConfigurationTable (
+                    &gAppleBootPolicyStatisticsGuid,
+                    (VOID *)mStatistics
+                    );
+
+    if (!EFI_ERROR (Status)) {
+      gBS->CreateEvent (
+             EVT_SIGNAL_EXIT_BOOT_SERVICES,
+             TPL_NOTIFY,
+             InternalStatisticsReportNotifyFunction,
+             NULL,
+             &mStatisticsReportEvent
+             );
+    } else {
+      FreePool ((VOID *)mStatistics);
+
+      mStatistics = NULL;
+    }
+  }
+
+  return Status;
+}
+
+// BootPolicyStatisticsEnter
+VOID
+BootPolicyStatisticsEnter (
+  IN  APPLE_BOOT_POLICY_FUNCTION      Function,
+  OUT BOOT_POLICY_STATISTICS_CONTEXT  *Context
+  )
+{
+  Context->Caller   = mActiveFunction;
+  Context->Function = NULL;
+
+  if (mStatistics != NULL) {
+    Context->Function  = &mStatistics->Functions[Function];
+    Context->StartTime = GetPerformanceCounter ();
+
+    ++Context->Function->Calls;
+
+    mActiveFunction = Context->Function;
+  }
+}
+
+// BootPolicyStatisticsExit
+VOID
+BootPolicyStatisticsExit (
+  IN CONST BOOT_POLICY_STATISTICS_CONTEXT  *Context
+  )
+{
+  APPLE_BOOT_POLICY_FUNCTION_STATISTICS *Function;
+  UINT64                                Time;
+  UINT64                                MicroSeconds;
+  UINTN                                 Bucket;
+
+  Function = Context->Function;
+
+  if (Function != NULL) {
+    Time = GetTimeInNanoSecond (GetPerformanceCounter () - Context->StartTime);
+
+    Function->TotalTime += Time;
+
+    if (Time > Function->MaximumTime) {
+      Function->MaximumTime = Time;
+    }
+
+    MicroSeconds = DivU64x32 (Time, 1000);
+    Bucket       = 0;
+
+    if (MicroSeconds > 0) {
+      Bucket = (UINTN)(HighBitSet64 (MicroSeconds) + 1);
+
+      if (Bucket >= APPLE_BOOT_POLICY_LATENCY_BUCKETS) {
+        Bucket = (APPLE_BOOT_POLICY_LATENCY_BUCKETS - 1);
+      }
+    }
+
+    ++Function->LatencyHistogram[Bucket];
+  }
+
+  mActiveFunction = Context->Caller;
+}
+
+// BootPolicyCountHandlesScanned
+VOID
+BootPolicyCountHandlesScanned (
+  IN UINTN  NumberOfHandles
+  )
+{
+  if (mActiveFunction != NULL) {
+    mActiveFunction->HandlesScanned += NumberOfHandles;
+  }
+}
+
+// BootPolicyCountOpen
+VOID
+BootPolicyCountOpen (
+  VOID
+  )
+{
+  if (mActiveFunction != NULL) {
+    ++mActiveFunction->OpenCalls;
+  }
+}
+
+// BootPolicyCountGetInfo
+VOID
+BootPolicyCountGetInfo (
+  VOID
+  )
+{
+  if (mActiveFunction != NULL) {
+    ++mActiveFunction->GetInfoCalls;
+  }
+}
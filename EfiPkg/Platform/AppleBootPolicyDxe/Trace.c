@@ -0,0 +1,162 @@
+#include <AppleMacEfi.h>
+
+#include <Guid/AppleBootPolicyTrace.h>
+#include <Guid/AppleBootPolicyVariable.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+
+#include "AppleBootPolicyInternal.h"
+
+// TRACE_MAX_RECORDS
+/// The upper limit of records to reserve memory for.
+#define TRACE_MAX_RECORDS  0x10000
+
+// mTrace
+STATIC APPLE_BOOT_POLICY_TRACE *mTrace = NULL;
+
+// BootPolicyCreateTrace
+EFI_STATUS
+BootPolicyCreateTrace (
+  VOID
+  )
+{
+  EFI_STATUS                     Status;
+
+  APPLE_BOOT_POLICY_TRACE_CONFIG Config;
+  UINTN                          DataSize;
+
+  Config.Flags = 0;
+
+  DataSize = sizeof (Config);
+  Status   = gRT->GetVariable (
+                    APPLE_BOOT_POLICY_TRACE_VARIABLE_NAME,
+                    &gAppleBootPolicyVariableGuid,
+                    NULL,
+                    &DataSize,
+                    (VOID *)&Config
+                    );
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (((DataSize != sizeof (Config))
+    && (DataSize != sizeof (Config.MaximumNumberOfRecords)))
+   || (Config.MaximumNumberOfRecords == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Config.MaximumNumberOfRecords > TRACE_MAX_RECORDS) {
+    Config.MaximumNumberOfRecords = TRACE_MAX_RECORDS;
+  }
+
+  mTrace = AllocateRuntimeZeroPool (
+             OFFSET_OF (APPLE_BOOT_POLICY_TRACE, Records)
+               + (Config.MaximumNumberOfRecords * sizeof (*mTrace->Records))
+             );
+
+  Status = EFI_OUT_OF_RESOURCES;
+
+  if (mTrace != NULL) {
+    mTrace->Revision               = APPLE_BOOT_POLICY_TRACE_REVISION;
+    mTrace->MaximumNumberOfRecords = Config.MaximumNumberOfRecords;
+    mTrace->Flags                  = Config.Flags;
+
+    Status = gBS->InstallConfigurationTable (
+                    &gAppleBootPolicyTraceGuid,
+                    (VOID *)mTrace
+                    );
+
+    if (EFI_ERROR (Status)) {
+      FreePool ((VOID *)mTrace);
+
+      mTrace = NULL;
+    }
+  }
+
+  return Status;
+}
+
+// BootPolicyTraceBegin
+VOID
+BootPolicyTraceBegin (
+  OUT BOOT_POLICY_TRACE_CONTEXT  *Context
+  )
+{
+  Context->StartTime = 0;
+
+  if (mTrace != NULL) {
+    Context->StartTime = GetPerformanceCounter ();
+  }
+}
+
+// BootPolicyTraceEnd
+VOID
+BootPolicyTraceEnd (
+  IN CONST BOOT_POLICY_TRACE_CONTEXT   *Context,
+  IN APPLE_BOOT_POLICY_TRACE_OPERATION  Operation,
+  IN CONST VOID                         *Handle,
+  IN CONST VOID                         *NewHandle OPTIONAL,
+  IN CONST CHAR16                       *PathName OPTIONAL,
+  IN CONST EFI_GUID                     *InformationType OPTIONAL,
+  IN EFI_STATUS                         Status,
+  IN UINTN                              Size,
+  IN CONST VOID                         *Information OPTIONAL
+  )
+{
+  APPLE_BOOT_POLICY_TRACE_RECORD *Record;
+
+  if (mTrace == NULL) {
+    return;
+  }
+
+  if (mTrace->NumberOfRecords < mTrace->MaximumNumberOfRecords) {
+    Record = &mTrace->Records[mTrace->NumberOfRecords];
+
+    Record->Handle    = (UINT64)(UINTN)Handle;
+    Record->Status    = (UINT64)Status;
+    Record->Size      = (UINT64)Size;
+    Record->Operation = Operation;
+    Record->Latency   = GetTimeInNanoSecond (
+                          GetPerformanceCounter () - Context->StartTime
+                          );
+
+    if (!EFI_ERROR (Status)) {
+      Record->NewHandle = (UINT64)(UINTN)NewHandle;
+    }
+
+    if (InformationType != NULL) {
+      CopyGuid (&Record->InformationType, InformationType);
+    }
+
+    if (!EFI_ERROR (Status)
+     && (Information != NULL)
+     && ((mTrace->Flags & APPLE_BOOT_POLICY_TRACE_RECORD_INFORMATION) != 0)) {
+      Record->InformationSize = (UINT32)MIN (
+                                          Size,
+                                          sizeof (Record->Information)
+                                          );
+
+      CopyMem (
+        &Record->Information[0],
+        Information,
+        Record->InformationSize
+        );
+    }
+
+    if (PathName != NULL) {
+      StrnCpy (
+        &Record->PathName[0],
+        PathName,
+        (ARRAY_SIZE (Record->PathName) - 1)
+        );
+    }
+  }
+
+  ++mTrace->NumberOfRecords;
+}
@@ -0,0 +1,428 @@
+#include <AppleMacEfi.h>
+
+#include <Guid/AppleApfsInfo.h>
+
+#include <Protocol/SimpleFileSystem.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "AppleBootPolicyInternal.h"
+
+// mVolumeCacheNotifyEvent
+STATIC EFI_EVENT mVolumeCacheNotifyEvent = NULL;
+
+// mVolumeCacheNotifyRegistration
+STATIC VOID *mVolumeCacheNotifyRegistration = NULL;
+
+// mVolumeCacheValid
+STATIC BOOLEAN mVolumeCacheValid = FALSE;
+
+// mApfsVolumes
+STATIC APFS_VOLUME_INFO *mApfsVolumes = NULL;
+
+// mNumberOfApfsVolumes
+STATIC UINTN mNumberOfApfsVolumes = 0;
+
+// InternalVolumeCacheNotifyFunction
+STATIC
+VOID
+EFIAPI
+InternalVolumeCacheNotifyFunction (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  mVolumeCacheValid = FALSE;
+}
+
+// InternalProbeApfsVolume
+STATIC
+EFI_STATUS
+InternalProbeApfsVolume (
+  IN  EFI_HANDLE        Device,
+  OUT APFS_VOLUME_INFO  *VolumeInfo
+  )
+{
+  EFI_STATUS                      Status;
+
+  EFI_FILE_PROTOCOL               *Root;
+  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *FileSystem;
+  APPLE_APFS_CONTAINER_INFO       *ApfsContainerInfo;
+  APPLE_APFS_VOLUME_INFO          *ApfsVolumeInfo;
+  BOOT_POLICY_TRACE_CONTEXT       Trace;
+
+  Status = gBS->HandleProtocol (
+                  Device,
+                  &gEfiSimpleFileSystemProtocolGuid,
+                  (VOID **)&FileSystem
+                  );
+
+  if (!EFI_ERROR (Status)) {
+    BootPolicyCountOpen ();
+    BootPolicyTraceBegin (&Trace);
+
+    Status = FileSystem->OpenVolume (FileSystem, &Root);
+
+    BootPolicyTraceEnd (
+      &Trace,
+      AppleBootPolicyTraceOpenVolume,
+      Device,
+      Root,
+      NULL,
+      NULL,
+      Status,
+      0,
+      NULL
+      );
+
+    if (!EFI_ERROR (Status)) {
+      Status = EFI_NOT_FOUND;
+
+      ApfsContainerInfo = InternalGetFileInfo (
+                            Root,
+                            &gAppleApfsContainerInfoGuid
+                            );
+
+      if (ApfsContainerInfo != NULL) {
+        ApfsVolumeInfo = InternalGetFileInfo (Root, &gAppleApfsVolumeInfoGuid);
+
+        if (ApfsVolumeInfo != NULL) {
+          VolumeInfo->Handle     = Device;
+          VolumeInfo->VolumeRole = ApfsVolumeInfo->Role;
+
+          CopyGuid (&VolumeInfo->ContainerGuid, &ApfsContainerInfo->Uuid);
+          CopyGuid (&VolumeInfo->VolumeGuid, &ApfsVolumeInfo->Uuid);
+
+          FreePool ((VOID *)ApfsVolumeInfo);
+
+          Status = EFI_SUCCESS;
+        }
+
+        FreePool ((VOID *)ApfsContainerInfo);
+      }
+
+      Root->Close (Root);
+    }
+  }
+
+  return Status;
+}
+
+// InternalCompareContainerGuid
+STATIC
+INTN
+InternalCompareContainerGuid (
+  IN CONST APFS_VOLUME_INFO  *Volume,
+  IN CONST GUID              *ContainerGuid
+  )
+{
+  return CompareMem (
+           (VOID *)&Volume->ContainerGuid,
+           (VOID *)ContainerGuid,
+           sizeof (*ContainerGuid)
+           );
+}
+
+// InternalInsertApfsVolume
+/** Inserts Volume into the array keeping it sorted by container UUID.  The
+    order of volumes within a container is preserved.
+
+  @param[in, out] Volumes          The sorted array to insert into.  It must
+                                   have room for one additional entry.
+  @param[in]      NumberOfVolumes  The number of entries in Volumes.
+  @param[in]      Volume           The volume to insert.
+**/
+STATIC
+VOID
+InternalInsertApfsVolume (
+  IN OUT APFS_VOLUME_INFO        *Volumes,
+  IN     UINTN                   NumberOfVolumes,
+  IN     CONST APFS_VOLUME_INFO  *Volume
+  )
+{
+  UINTN Index;
+
+  Index = NumberOfVolumes;
+
+  while ((Index > 0)
+      && (InternalCompareContainerGuid (
+            &Volumes[Index - 1],
+            &Volume->ContainerGuid
+            ) > 0)) {
+    --Index;
+  }
+
+  CopyMem (
+    (VOID *)&Volumes[Index + 1],
+    (VOID *)&Volumes[Index],
+    ((NumberOfVolumes - Index) * sizeof (*Volumes))
+    );
+
+  CopyMem ((VOID *)&Volumes[Index], (VOID *)Volume, sizeof (*Volume));
+}
+
+// InternalIsVolumeCacheStale
+STATIC
+BOOLEAN
+InternalIsVolumeCacheStale (
+  VOID
+  )
+{
+  UINTN      Index;
+  EFI_STATUS Status;
+  VOID       *Interface;
+
+  if (!mVolumeCacheValid || (mVolumeCacheNotifyEvent == NULL)) {
+    return TRUE;
+  }
+
+  //
+  // The UEFI specification offers no notification for protocol removal.
+  // Verify the cached handles still carry a file system, which does not
+  // involve the file system driver.
+  //
+  for (Index = 0; Index < mNumberOfApfsVolumes; ++Index) {
+    Status = gBS->HandleProtocol (
+                    mApfsVolumes[Index].Handle,
+                    &gEfiSimpleFileSystemProtocolGuid,
+                    &Interface
+                    );
+
+    if (EFI_ERROR (Status)) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+// InternalRefreshVolumeCache
+STATIC
+EFI_STATUS
+InternalRefreshVolumeCache (
+  VOID
+  )
+{
+  EFI_STATUS       Status;
+
+  UINTN            NumberOfHandles;
+  EFI_HANDLE       *HandleBuffer;
+  APFS_VOLUME_INFO *Volumes;
+  UINTN            NumberOfVolumes;
+  UINTN            Index;
+  APFS_VOLUME_INFO Volume;
+
+  //
+  // Validate the cache before probing so that notifications raised while
+  // probing cause another refresh on the next query.
+  //
+  mVolumeCacheValid = TRUE;
+
+  if (mApfsVolumes != NULL) {
+    FreePool ((VOID *)mApfsVolumes);
+
+    mApfsVolumes = NULL;
+  }
+
+  mNumberOfApfsVolumes = 0;
+
+  Status = gBS->LocateHandleBuffer (
+                  ByProtocol,
+                  &gEfiSimpleFileSystemProtocolGuid,
+                  NULL,
+                  &NumberOfHandles,
+                  &HandleBuffer
+                  );
+
+  if (!EFI_ERROR (Status)) {
+    BootPolicyCountHandlesScanned (NumberOfHandles);
+
+    Volumes = AllocatePool (NumberOfHandles * sizeof (*Volumes));
+
+    Status = EFI_OUT_OF_RESOURCES;
+
+    if (Volumes != NULL) {
+      NumberOfVolumes = 0;
+
+      for (Index = 0; Index < NumberOfHandles; ++Index) {
+        Status = InternalProbeApfsVolume (HandleBuffer[Index], &Volume);
+
+        if (!EFI_ERROR (Status)) {
+          InternalInsertApfsVolume (Volumes, NumberOfVolumes, &Volume);
+
+          ++NumberOfVolumes;
+        }
+      }
+
+      Status = EFI_SUCCESS;
+
+      if (NumberOfVolumes > 0) {
+        mApfsVolumes         = Volumes;
+        mNumberOfApfsVolumes = NumberOfVolumes;
+      } else {
+        FreePool ((VOID *)Volumes);
+      }
+    }
+
+    FreePool ((VOID *)HandleBuffer);
+  }
+
+  if (EFI_ERROR (Status)) {
+    mVolumeCacheValid = FALSE;
+  }
+
+  return Status;
+}
+
+// BootPolicyCreateVolumeCache
+EFI_STATUS
+BootPolicyCreateVolumeCache (
+  VOID
+  )
+{
+  EFI_STATUS Status;
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  InternalVolumeCacheNotifyFunction,
+                  NULL,
+                  &mVolumeCacheNotifyEvent
+                  );
+
+  if (!EFI_ERROR (Status)) {
+    Status = gBS->RegisterProtocolNotify (
+                    &gEfiSimpleFileSystemProtocolGuid,
+                    mVolumeCacheNotifyEvent,
+                    &mVolumeCacheNotifyRegistration
+                    );
+
+    if (EFI_ERROR (Status)) {
+      gBS->CloseEvent (mVolumeCacheNotifyEvent);
+
+      mVolumeCacheNotifyEvent = NULL;
+    }
+  }
+
+  return Status;
+}
+
+// BootPolicyGetApfsVolumes
+EFI_STATUS
+BootPolicyGetApfsVolumes (
+  OUT CONST APFS_VOLUME_INFO  **Volumes,
+  OUT UINTN                   *NumberOfVolumes
+  )
+{
+  EFI_STATUS Status;
+
+  Status = EFI_SUCCESS;
+
+  if (InternalIsVolumeCacheStale ()) {
+    Status = InternalRefreshVolumeCache ();
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = EFI_NOT_FOUND;
+
+    if (mNumberOfApfsVolumes > 0) {
+      *Volumes         = mApfsVolumes;
+      *NumberOfVolumes = mNumberOfApfsVolumes;
+
+      Status = EFI_SUCCESS;
+    }
+  }
+
+  return Status;
+}
+
+// BootPolicyGetApfsVolumeInfo
+EFI_STATUS
+BootPolicyGetApfsVolumeInfo (
+  IN  EFI_HANDLE              Device,
+  OUT EFI_GUID                *ContainerGuid,
+  OUT EFI_GUID                *VolumeGuid,
+  OUT APPLE_APFS_VOLUME_ROLE  *VolumeRole
+  )
+{
+  EFI_STATUS             Status;
+
+  CONST APFS_VOLUME_INFO *Volumes;
+  UINTN                  NumberOfVolumes;
+  UINTN                  Index;
+
+  Status = BootPolicyGetApfsVolumes (&Volumes, &NumberOfVolumes);
+
+  if (!EFI_ERROR (Status)) {
+    Status = EFI_NOT_FOUND;
+
+    for (Index = 0; Index < NumberOfVolumes; ++Index) {
+      if (Volumes[Index].Handle == Device) {
+        CopyGuid (ContainerGuid, &Volumes[Index].ContainerGuid);
+        CopyGuid (VolumeGuid, &Volumes[Index].VolumeGuid);
+
+        *VolumeRole = Volumes[Index].VolumeRole;
+
+        Status = EFI_SUCCESS;
+
+        break;
+      }
+    }
+  }
+
+  return Status;
+}
+
+// BootPolicyGetApfsContainerVolumes
+EFI_STATUS
+BootPolicyGetApfsContainerVolumes (
+  IN  CONST GUID              *ContainerGuid,
+  OUT CONST APFS_VOLUME_INFO  **Volumes,
+  OUT UINTN                   *NumberOfVolumes
+  )
+{
+  EFI_STATUS             Status;
+
+  CONST APFS_VOLUME_INFO *AllVolumes;
+  UINTN                  NumberOfAllVolumes;
+  UINTN                  Lower;
+  UINTN                  Upper;
+  UINTN                  Middle;
+
+  Status = BootPolicyGetApfsVolumes (&AllVolumes, &NumberOfAllVolumes);
+
+  if (!EFI_ERROR (Status)) {
+    Lower = 0;
+    Upper = NumberOfAllVolumes;
+
+    while (Lower < Upper) {
+      Middle = (Lower + ((Upper - Lower) / 2));
+
+      if (InternalCompareContainerGuid (&AllVolumes[Middle], ContainerGuid) < 0) {
+        Lower = (Middle + 1);
+      } else {
+        Upper = Middle;
+      }
+    }
+
+    Upper = Lower;
+
+    while ((Upper < NumberOfAllVolumes)
+        && CompareGuid (&AllVolumes[Upper].ContainerGuid, ContainerGuid)) {
+      ++Upper;
+    }
+
+    Status = EFI_NOT_FOUND;
+
+    if (Upper > Lower) {
+      *Volumes         = &AllVolumes[Lower];
+      *NumberOfVolumes = (Upper - Lower);
+
+      Status = EFI_SUCCESS;
+    }
+  }
+
+  return Status;
+}
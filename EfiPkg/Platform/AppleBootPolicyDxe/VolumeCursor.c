@@ -0,0 +1,130 @@
+#include <AppleMacEfi.h>
+
+#include <Protocol/AppleBootPolicyEx.h>
+#include <Protocol/SimpleFileSystem.h>
+
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "AppleBootPolicyInternal.h"
+
+// VOLUME_CURSOR_SIGNATURE
+#define VOLUME_CURSOR_SIGNATURE  SIGNATURE_32 ('B', 'P', 'V', 'C')
+
+// APPLE_BOOT_POLICY_VOLUME_CURSOR
+struct APPLE_BOOT_POLICY_VOLUME_CURSOR {
+  UINT32     Signature;
+  UINT32     Mode;
+  UINTN      NumberOfHandles;
+  UINTN      Index;
+  EFI_HANDLE *HandleBuffer;
+};
+
+// BootPolicyOpenVolumeCursor
+EFI_STATUS
+EFIAPI
+BootPolicyOpenVolumeCursor (
+  IN  UINT32                           Mode,
+  OUT APPLE_BOOT_POLICY_VOLUME_CURSOR  **Cursor
+  )
+{
+  EFI_STATUS                      Status;
+
+  APPLE_BOOT_POLICY_VOLUME_CURSOR *NewCursor;
+
+  NewCursor = AllocateZeroPool (sizeof (*NewCursor));
+
+  Status = EFI_OUT_OF_RESOURCES;
+
+  if (NewCursor != NULL) {
+    Status = gBS->LocateHandleBuffer (
+                    ByProtocol,
+                    &gEfiSimpleFileSystemProtocolGuid,
+                    NULL,
+                    &NewCursor->NumberOfHandles,
+                    &NewCursor->HandleBuffer
+                    );
+
+    if (!EFI_ERROR (Status)) {
+      NewCursor->Signature = VOLUME_CURSOR_SIGNATURE;
+      NewCursor->Mode      = Mode;
+
+      *Cursor = NewCursor;
+    } else {
+      FreePool ((VOID *)NewCursor);
+    }
+  }
+
+  return Status;
+}
+
+// BootPolicyGetNextVolume
+EFI_STATUS
+EFIAPI
+BootPolicyGetNextVolume (
+  IN  APPLE_BOOT_POLICY_VOLUME_CURSOR  *Cursor,
+  OUT EFI_HANDLE                       *Device,
+  OUT EFI_DEVICE_PATH_PROTOCOL         **FilePath
+  )
+{
+  EFI_STATUS                     Status;
+
+  EFI_HANDLE                     Handle;
+
+  BOOT_POLICY_STATISTICS_CONTEXT StatisticsContext;
+
+  if ((Cursor == NULL) || (Cursor->Signature != VOLUME_CURSOR_SIGNATURE)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  BootPolicyStatisticsEnter (
+    AppleBootPolicyFunctionGetNextVolume,
+    &StatisticsContext
+    );
+
+  Status = EFI_NOT_FOUND;
+
+  //
+  // Advance the cursor before probing so that a volume which failed is not
+  // probed again when the caller resumes.  Handles uninstalled since the
+  // cursor has been opened fail HandleProtocol() and are skipped.
+  //
+  while (Cursor->Index < Cursor->NumberOfHandles) {
+    Handle = Cursor->HandleBuffer[Cursor->Index];
+
+    ++Cursor->Index;
+
+    BootPolicyCountHandlesScanned (1);
+
+    Status = BootPolicyGetBootFileEx (Handle, Cursor->Mode, FilePath);
+
+    if (!EFI_ERROR (Status)) {
+      *Device = Handle;
+
+      break;
+    }
+
+    if (Status != EFI_NOT_FOUND) {
+      break;
+    }
+  }
+
+  BootPolicyStatisticsExit (&StatisticsContext);
+
+  return Status;
+}
+
+// BootPolicyCloseVolumeCursor
+VOID
+EFIAPI
+BootPolicyCloseVolumeCursor (
+  IN APPLE_BOOT_POLICY_VOLUME_CURSOR  *Cursor
+  )
+{
+  if ((Cursor != NULL) && (Cursor->Signature == VOLUME_CURSOR_SIGNATURE)) {
+    Cursor->Signature = 0;
+
+    FreePool ((VOID *)Cursor->HandleBuffer);
+    FreePool ((VOID *)Cursor);
+  }
+}
@@ -0,0 +1,120 @@
+#include <AppleMacEfi.h>
+
+#include <Guid/AppleApfsInfo.h>
+
+#include <Protocol/AppleBootPolicyEx.h>
+#include <Protocol/SimpleFileSystem.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "AppleBootPolicyInternal.h"
+
+// InternalIsVolumeRoleMatch
+STATIC
+BOOLEAN
+InternalIsVolumeRoleMatch (
+  IN APPLE_APFS_VOLUME_ROLE  Role,
+  IN APPLE_APFS_VOLUME_ROLE  RoleMask
+  )
+{
+  return (BOOLEAN)(
+           (RoleMask == APPLE_BOOT_POLICY_VOLUME_ROLE_ANY)
+             || ((Role & RoleMask) != 0)
+           );
+}
+
+// BootPolicyGetVolumesByRole
+EFI_STATUS
+EFIAPI
+BootPolicyGetVolumesByRole (
+  IN  APPLE_APFS_VOLUME_ROLE         RoleMask,
+  OUT APPLE_BOOT_POLICY_VOLUME_LIST  **List
+  )
+{
+  EFI_STATUS                     Status;
+
+  CONST APFS_VOLUME_INFO         *Volumes;
+  UINTN                          NumberOfVolumes;
+  UINTN                          NumberOfMatches;
+  UINTN                          Index;
+  APPLE_BOOT_POLICY_VOLUME_LIST  *VolumeList;
+  APPLE_BOOT_POLICY_VOLUME_ENTRY *Entry;
+
+  BOOT_POLICY_STATISTICS_CONTEXT StatisticsContext;
+
+  BootPolicyStatisticsEnter (
+    AppleBootPolicyFunctionGetVolumesByRole,
+    &StatisticsContext
+    );
+
+  Status = BootPolicyGetApfsVolumes (&Volumes, &NumberOfVolumes);
+
+  if (!EFI_ERROR (Status)) {
+    NumberOfMatches = 0;
+
+    for (Index = 0; Index < NumberOfVolumes; ++Index) {
+      if (InternalIsVolumeRoleMatch (Volumes[Index].VolumeRole, RoleMask)) {
+        ++NumberOfMatches;
+      }
+    }
+
+    Status = EFI_NOT_FOUND;
+
+    if (NumberOfMatches > 0) {
+      //
+      // The entries, including their names, are stored in one allocation so
+      // that the caller can release the list without walking it.
+      //
+      VolumeList = AllocatePool (
+                     OFFSET_OF (APPLE_BOOT_POLICY_VOLUME_LIST, Volumes)
+                       + (NumberOfMatches * sizeof (*Entry))
+                     );
+
+      Status = EFI_OUT_OF_RESOURCES;
+
+      if (VolumeList != NULL) {
+        VolumeList->NumberOfVolumes = NumberOfMatches;
+
+        Entry = &VolumeList->Volumes[0];
+
+        for (Index = 0; Index < NumberOfVolumes; ++Index) {
+          if (!InternalIsVolumeRoleMatch (Volumes[Index].VolumeRole, RoleMask)) {
+            continue;
+          }
+
+          Entry->Handle = Volumes[Index].Handle;
+          Entry->Role   = Volumes[Index].VolumeRole;
+
+          CopyGuid (&Entry->ContainerGuid, &Volumes[Index].ContainerGuid);
+          CopyGuid (&Entry->VolumeGuid, &Volumes[Index].VolumeGuid);
+
+          BootPolicyGuidToStr (&Entry->VolumeGuid, &Entry->VolumeDirName[0]);
+
+          ++Entry;
+        }
+
+        *List = VolumeList;
+
+        Status = EFI_SUCCESS;
+      }
+    }
+  }
+
+  BootPolicyStatisticsExit (&StatisticsContext);
+
+  return Status;
+}
+
+// BootPolicyOpenVolumeRoot
+EFI_STATUS
+EFIAPI
+BootPolicyOpenVolumeRoot (
+  IN  CONST APPLE_BOOT_POLICY_VOLUME_ENTRY  *Volume,
+  OUT EFI_FILE_PROTOCOL                     **Root
+  )
+{
+  return BootPolicyOpenFileSystemRoot (Volume->Handle, Root);
+}
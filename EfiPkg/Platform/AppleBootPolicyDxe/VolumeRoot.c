@@ -0,0 +1,47 @@
+#include <AppleMacEfi.h>
+
+#include <Protocol/SimpleFileSystem.h>
+
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "AppleBootPolicyInternal.h"
+
+// BootPolicyOpenFileSystemRoot
+EFI_STATUS
+BootPolicyOpenFileSystemRoot (
+  IN  EFI_HANDLE         Handle,
+  OUT EFI_FILE_PROTOCOL  **Root
+  )
+{
+  EFI_STATUS                      Status;
+
+  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *FileSystem;
+  BOOT_POLICY_TRACE_CONTEXT       Trace;
+
+  Status = gBS->HandleProtocol (
+                  Handle,
+                  &gEfiSimpleFileSystemProtocolGuid,
+                  (VOID **)&FileSystem
+                  );
+
+  if (!EFI_ERROR (Status)) {
+    BootPolicyCountOpen ();
+    BootPolicyTraceBegin (&Trace);
+
+    Status = FileSystem->OpenVolume (FileSystem, Root);
+
+    BootPolicyTraceEnd (
+      &Trace,
+      AppleBootPolicyTraceOpenVolume,
+      Handle,
+      *Root,
+      NULL,
+      NULL,
+      Status,
+      0,
+      NULL
+      );
+  }
+
+  return Status;
+}
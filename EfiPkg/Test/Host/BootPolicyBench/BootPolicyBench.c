@@ -0,0 +1,592 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <AppleMacEfi.h>
+
+#include <Guid/AppleApfsInfo.h>
+#include <Guid/AppleBless.h>
+#include <Guid/AppleBootPolicyStatistics.h>
+#include <Guid/AppleBootPolicyTrace.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#include "../Common/BootPolicyWorkload.h"
+
+//
+// Sweeps AppleBootPolicyDxe over synthetic volume layouts.  Every point runs
+// in a child process, so that the static caches of the driver start empty.
+//
+// With -t, the cold pass of every point is traced and the trace is written
+// to the given file, so that the trace of the last point run is kept.  See
+// BootPolicyReplay.
+//
+// A layout consists of N APFS containers and one FAT ESP.  Each container
+// holds M system volumes, a preboot volume providing a boot file per system
+// volume and a recovery volume providing a directory per system volume.
+// Every system volume is blessed.
+//
+// Each point runs three passes of the same workload: a cold one, a warm one
+// and one after the file system of the first system volume has been
+// reinstalled, which invalidates the caches of the driver.
+//
+
+// BENCH_MAX_VOLUMES
+#define BENCH_MAX_VOLUMES  1024
+
+// BENCH_TRACE_RECORDS
+#define BENCH_TRACE_RECORDS  0x4000
+
+// BENCH_LAYOUT
+typedef struct {
+  UINTN       NumberOfContainers;
+  UINTN       VolumesPerContainer;
+  UINTN       NumberOfVolumes;
+  MOCK_VOLUME *Volumes[BENCH_MAX_VOLUMES];
+  MOCK_VOLUME *FirstSystemVolume;
+} BENCH_LAYOUT;
+
+// mPassNames
+STATIC CONST CHAR8 *mPassNames[] = { "cold", "warm", "reinstall" };
+
+// InternalMakeGuid
+/// Derives a GUID unique per container and volume index.
+STATIC
+VOID
+InternalMakeGuid (
+  OUT EFI_GUID  *Guid,
+  IN  UINT32    Container,
+  IN  UINT32    Volume
+  )
+{
+  Guid->Data1 = (0xA0000000U | (Container << 12) | Volume);
+  Guid->Data2 = 0x1234;
+  Guid->Data3 = (UINT16)(0x4000 | Volume);
+
+  Guid->Data4[0] = 0x80;
+  Guid->Data4[1] = (UINT8)Container;
+  Guid->Data4[2] = 0x00;
+  Guid->Data4[3] = 0x11;
+  Guid->Data4[4] = 0x22;
+  Guid->Data4[5] = 0x33;
+  Guid->Data4[6] = (UINT8)(Volume >> 8);
+  Guid->Data4[7] = (UINT8)Volume;
+}
+
+// InternalGuidToPathName
+/// Formats "\<Guid><Suffix>" as the driver names volume directories.
+STATIC
+VOID
+InternalGuidToPathName (
+  IN  CONST EFI_GUID  *Guid,
+  IN  CONST CHAR8     *Suffix,
+  OUT CHAR16          *PathName
+  )
+{
+  CHAR8 Buffer[MOCK_MAX_PATH_NAME_LENGTH];
+  UINTN Index;
+
+  snprintf (
+    Buffer,
+    sizeof (Buffer),
+    "\\%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X%s",
+    Guid->Data1,
+    Guid->Data2,
+    Guid->Data3,
+    Guid->Data4[0],
+    Guid->Data4[1],
+    Guid->Data4[2],
+    Guid->Data4[3],
+    Guid->Data4[4],
+    Guid->Data4[5],
+    Guid->Data4[6],
+    Guid->Data4[7],
+    Suffix
+    );
+
+  for (Index = 0; Buffer[Index] != '\0'; ++Index) {
+    PathName[Index] = (CHAR16)Buffer[Index];
+  }
+
+  PathName[Index] = L'\0';
+}
+
+// InternalAddVolume
+STATIC
+MOCK_VOLUME *
+InternalAddVolume (
+  IN OUT BENCH_LAYOUT  *Layout
+  )
+{
+  MOCK_VOLUME *Volume;
+
+  if (Layout->NumberOfVolumes == BENCH_MAX_VOLUMES) {
+    return NULL;
+  }
+
+  Volume = MockCreateVolume ();
+
+  if (Volume != NULL) {
+    Layout->Volumes[Layout->NumberOfVolumes++] = Volume;
+  }
+
+  return Volume;
+}
+
+// InternalCreateLayout
+STATIC
+EFI_STATUS
+InternalCreateLayout (
+  OUT BENCH_LAYOUT  *Layout,
+  IN  UINTN         NumberOfContainers,
+  IN  UINTN         VolumesPerContainer
+  )
+{
+  UINT32      Container;
+  UINT32      Index;
+  EFI_GUID    ContainerGuid;
+  EFI_GUID    VolumeGuid;
+  CHAR16      PathName[MOCK_MAX_PATH_NAME_LENGTH];
+  MOCK_VOLUME *Preboot;
+  MOCK_VOLUME *Recovery;
+  MOCK_VOLUME *System;
+
+  ZeroMem (Layout, sizeof (*Layout));
+
+  Layout->NumberOfContainers  = NumberOfContainers;
+  Layout->VolumesPerContainer = VolumesPerContainer;
+
+  if (((NumberOfContainers * (VolumesPerContainer + 2)) + 1)
+        > BENCH_MAX_VOLUMES) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Container = 0; Container < NumberOfContainers; ++Container) {
+    InternalMakeGuid (&ContainerGuid, Container, 0xFFF);
+
+    Preboot  = InternalAddVolume (Layout);
+    Recovery = InternalAddVolume (Layout);
+
+    if ((Preboot == NULL) || (Recovery == NULL)) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    InternalMakeGuid (&VolumeGuid, Container, 0xFFE);
+    MockSetApfsInfo (
+      Preboot,
+      &ContainerGuid,
+      &VolumeGuid,
+      APPLE_APFS_VOLUME_ROLE_PREBOOT
+      );
+
+    InternalMakeGuid (&VolumeGuid, Container, 0xFFD);
+    MockSetApfsInfo (
+      Recovery,
+      &ContainerGuid,
+      &VolumeGuid,
+      APPLE_APFS_VOLUME_ROLE_RECOVERY
+      );
+
+    for (Index = 0; Index < VolumesPerContainer; ++Index) {
+      System = InternalAddVolume (Layout);
+
+      if (System == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+
+      if (Layout->FirstSystemVolume == NULL) {
+        Layout->FirstSystemVolume = System;
+      }
+
+      InternalMakeGuid (&VolumeGuid, Container, Index);
+      MockSetApfsInfo (
+        System,
+        &ContainerGuid,
+        &VolumeGuid,
+        APPLE_APFS_VOLUME_ROLE_SYSTEM
+        );
+
+      MockAddFile (System, APPLE_BOOTER_DEFAULT_FILE_NAME);
+      MockBlessFile (System, APPLE_BOOTER_DEFAULT_FILE_NAME);
+
+      InternalGuidToPathName (
+        &VolumeGuid,
+        "\\System\\Library\\CoreServices\\boot.efi",
+        PathName
+        );
+
+      MockAddFile (Preboot, PathName);
+
+      InternalGuidToPathName (&VolumeGuid, "\\boot.efi", PathName);
+      MockAddFile (Recovery, PathName);
+    }
+  }
+
+  System = InternalAddVolume (Layout);
+
+  if (System == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  MockAddFile (System, EFI_REMOVABLE_MEDIA_FILE_NAME);
+
+  for (Index = 0; Index < Layout->NumberOfVolumes; ++Index) {
+    if (EFI_ERROR (MockInstallVolume (Layout->Volumes[Index]))) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+// InternalWriteTrace
+STATIC
+EFI_STATUS
+InternalWriteTrace (
+  IN CONST CHAR8  *FileName
+  )
+{
+  EFI_STATUS                    Status;
+
+  CONST APPLE_BOOT_POLICY_TRACE *Trace;
+  UINTN                         NumberOfRecords;
+  UINTN                         Size;
+  FILE                          *File;
+
+  Trace = MockGetConfigurationTable (&gAppleBootPolicyTraceGuid);
+
+  if (Trace == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  NumberOfRecords = (UINTN)MIN (
+                             Trace->NumberOfRecords,
+                             Trace->MaximumNumberOfRecords
+                             );
+
+  Size = (OFFSET_OF (APPLE_BOOT_POLICY_TRACE, Records)
+            + (NumberOfRecords * sizeof (*Trace->Records)));
+
+  Status = EFI_DEVICE_ERROR;
+  File   = fopen (FileName, "wb");
+
+  if (File != NULL) {
+    if (fwrite (Trace, Size, 1, File) == 1) {
+      Status = EFI_SUCCESS;
+    }
+
+    if (fclose (File) != 0) {
+      Status = EFI_DEVICE_ERROR;
+    }
+  }
+
+  return Status;
+}
+
+// InternalPrintStatistics
+STATIC
+VOID
+InternalPrintStatistics (
+  VOID
+  )
+{
+  STATIC CONST CHAR8 *FunctionNames[] = {
+    "GetBootFile",
+    "GetBootFileEx",
+    "GetBootInfo",
+    "GetPathNameOnApfsRecovery",
+    "GetApfsRecoveryVolumes",
+    "GetNextVolume",
+    "GetVolumesByRole"
+  };
+
+  APPLE_BOOT_POLICY_STATISTICS *Statistics;
+  UINTN                        Index;
+
+  Statistics = MockGetConfigurationTable (&gAppleBootPolicyStatisticsGuid);
+
+  if (Statistics == NULL) {
+    return;
+  }
+
+  for (Index = 0;
+       (Index < Statistics->NumberOfFunctions)
+    && (Index < ARRAY_SIZE (FunctionNames));
+       ++Index) {
+    if (Statistics->Functions[Index].Calls == 0) {
+      continue;
+    }
+
+    printf (
+      "    %-26s calls %6llu  open %7llu  getinfo %7llu  total %9.3f ms\n",
+      FunctionNames[Index],
+      (unsigned long long)Statistics->Functions[Index].Calls,
+      (unsigned long long)Statistics->Functions[Index].OpenCalls,
+      (unsigned long long)Statistics->Functions[Index].GetInfoCalls,
+      (double)Statistics->Functions[Index].TotalTime / 1000000.0
+      );
+  }
+}
+
+// InternalRunPoint
+STATIC
+int
+InternalRunPoint (
+  IN UINTN        NumberOfContainers,
+  IN UINTN        VolumesPerContainer,
+  IN UINT64       Latency,
+  IN BOOLEAN      Verbose,
+  IN CONST CHAR8  *TraceFileName OPTIONAL
+  )
+{
+  EFI_STATUS                  Status;
+
+  EFI_SYSTEM_TABLE            *SystemTable;
+  BENCH_LAYOUT                *Layout;
+  BOOT_POLICY_WORKLOAD_RESULT Result;
+  UINTN                       Pass;
+
+  SystemTable = MockInitialize ();
+  Layout      = AllocateZeroPool (sizeof (*Layout));
+
+  if (Layout == NULL) {
+    return 1;
+  }
+
+  Status = InternalCreateLayout (
+             Layout,
+             NumberOfContainers,
+             VolumesPerContainer
+             );
+
+  if (!EFI_ERROR (Status) && (TraceFileName != NULL)) {
+    Status = BootPolicyEnableTrace (BENCH_TRACE_RECORDS);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = BootPolicyStartDriver (SystemTable);
+  }
+
+  if (EFI_ERROR (Status)) {
+    fprintf (stderr, "Setup failed: 0x%llX\n", (unsigned long long)Status);
+
+    return 1;
+  }
+
+  MockSetLatency (Latency);
+
+  for (Pass = 0; Pass < ARRAY_SIZE (mPassNames); ++Pass) {
+    if (Pass == 2) {
+      MockReinstallVolume (Layout->FirstSystemVolume);
+    }
+
+    BootPolicyRunWorkload (
+      Layout->Volumes,
+      Layout->NumberOfVolumes,
+      &Result
+      );
+
+    if ((Pass == 0) && (TraceFileName != NULL)) {
+      Status = InternalWriteTrace (TraceFileName);
+
+      if (EFI_ERROR (Status)) {
+        fprintf (stderr, "Writing %s failed\n", TraceFileName);
+
+        return 1;
+      }
+    }
+
+    printf (
+      "%4u %4u %5u %7llu  %-9s %10.3f %5u %5u %7llu %7llu %7llu %7llu %6llu %6llu %6llu %5llu\n",
+      (unsigned)NumberOfContainers,
+      (unsigned)VolumesPerContainer,
+      (unsigned)Layout->NumberOfVolumes,
+      (unsigned long long)(Latency / 1000),
+      mPassNames[Pass],
+      (double)Result.WallTime / 1000000.0,
+      (unsigned)Result.BootableVolumes,
+      (unsigned)Result.Failures,
+      (unsigned long long)Result.FileSystem.OpenVolume,
+      (unsigned long long)Result.FileSystem.Open,
+      (unsigned long long)Result.FileSystem.OpenFailed,
+      (unsigned long long)Result.FileSystem.GetInfo,
+      (unsigned long long)Result.BootServices.HandleProtocol,
+      (unsigned long long)Result.BootServices.LocateHandleBuffer,
+      (unsigned long long)Result.BootServices.SetVariable,
+      (unsigned long long)Result.FileSystem.OpenFiles
+      );
+  }
+
+  if (Verbose) {
+    InternalPrintStatistics ();
+    fflush (stdout);
+
+    MockSignalExitBootServices ();
+  }
+
+  return ((Result.FileSystem.OpenFiles == 0) ? 0 : 2);
+}
+
+// InternalParseList
+STATIC
+UINTN
+InternalParseList (
+  IN  CONST CHAR8  *String,
+  OUT UINT64       *Values,
+  IN  UINTN        MaximumNumberOfValues
+  )
+{
+  UINTN NumberOfValues;
+  CHAR8 *End;
+
+  for (NumberOfValues = 0; NumberOfValues < MaximumNumberOfValues; ) {
+    Values[NumberOfValues++] = strtoull (String, &End, 10);
+
+    if (*End != ',') {
+      break;
+    }
+
+    String = (End + 1);
+  }
+
+  return NumberOfValues;
+}
+
+// InternalUsage
+STATIC
+int
+InternalUsage (
+  IN CONST CHAR8  *Name
+  )
+{
+  fprintf (
+    stderr,
+    "Usage: %s [-c containers,...] [-m volumes,...] [-l latency_us,...] [-v]\n"
+    "          [-t trace_file]\n"
+    "\n"
+    "  -c  APFS containers per layout              (default 1,2,4,8)\n"
+    "  -m  system volumes per container            (default 1,2,4,8)\n"
+    "  -l  latency injected per file system call   (default 0,20)\n"
+    "  -v  print the driver statistics of each point\n"
+    "  -t  write the trace of the cold pass of the last point to trace_file\n",
+    Name
+    );
+
+  return 1;
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  UINT64  Containers[16] = { 1, 2, 4, 8 };
+  UINT64  Volumes[16]    = { 1, 2, 4, 8 };
+  UINT64  Latencies[16]  = { 0, 20 };
+  UINTN   NumberOfContainers;
+  UINTN   NumberOfVolumes;
+  UINTN   NumberOfLatencies;
+  BOOLEAN Verbose;
+  CHAR8   *TraceFileName;
+  int     Option;
+  UINTN   Index;
+  UINTN   Index2;
+  UINTN   Index3;
+  pid_t   Child;
+  int     ChildStatus;
+  int     Result;
+
+  NumberOfContainers = 4;
+  NumberOfVolumes    = 4;
+  NumberOfLatencies  = 2;
+  Verbose            = FALSE;
+  TraceFileName      = NULL;
+
+  while ((Option = getopt (argc, argv, "c:m:l:vt:")) != -1) {
+    switch (Option) {
+      case 'c':
+        NumberOfContainers = InternalParseList (
+                               optarg,
+                               Containers,
+                               ARRAY_SIZE (Containers)
+                               );
+        break;
+
+      case 'm':
+        NumberOfVolumes = InternalParseList (
+                            optarg,
+                            Volumes,
+                            ARRAY_SIZE (Volumes)
+                            );
+        break;
+
+      case 'l':
+        NumberOfLatencies = InternalParseList (
+                              optarg,
+                              Latencies,
+                              ARRAY_SIZE (Latencies)
+                              );
+        break;
+
+      case 'v':
+        Verbose = TRUE;
+        break;
+
+      case 't':
+        TraceFileName = optarg;
+        break;
+
+      default:
+        return InternalUsage (argv[0]);
+    }
+  }
+
+  printf (
+    "   N    M  vols lat(us)  pass        wall(ms)  boot  fail  opnvol    open  openNF getinfo  hproto locbuf setvar leak\n"
+    );
+
+  Result = 0;
+
+  for (Index = 0; Index < NumberOfLatencies; ++Index) {
+    for (Index2 = 0; Index2 < NumberOfContainers; ++Index2) {
+      for (Index3 = 0; Index3 < NumberOfVolumes; ++Index3) {
+        fflush (stdout);
+
+        Child = fork ();
+
+        if (Child == 0) {
+          exit (
+            InternalRunPoint (
+              (UINTN)Containers[Index2],
+              (UINTN)Volumes[Index3],
+              Latencies[Index] * 1000,
+              Verbose,
+              TraceFileName
+              )
+            );
+        }
+
+        if ((Child < 0)
+         || (waitpid (Child, &ChildStatus, 0) != Child)
+         || !WIFEXITED (ChildStatus)
+         || (WEXITSTATUS (ChildStatus) != 0)) {
+          fprintf (
+            stderr,
+            "Point N=%u M=%u failed\n",
+            (unsigned)Containers[Index2],
+            (unsigned)Volumes[Index3]
+            );
+
+          Result = 1;
+        }
+      }
+    }
+  }
+
+  return Result;
+}
@@ -0,0 +1,836 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <AppleMacEfi.h>
+
+#include <Guid/AppleApfsInfo.h>
+#include <Guid/AppleBless.h>
+#include <Guid/AppleBootPolicyTrace.h>
+#include <Guid/FileInfo.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#include "../Common/BootPolicyWorkload.h"
+
+//
+// Replays an APPLE_BOOT_POLICY_TRACE against the current AppleBootPolicyDxe.
+//
+// The volumes are reconstructed from the trace: every device handle passed to
+// OpenVolume() becomes a mock volume, every path name opened successfully a
+// file or directory of it.  Whether a path name is a directory is taken from
+// the EFI_FILE_INFO recorded, or implied by path names opened below it.  APFS
+// container and volume information and the blessed system file are taken
+// from the GetInfo() buffers recorded, so the trace has to be enabled with
+// APPLE_BOOT_POLICY_TRACE_RECORD_INFORMATION.  Path names not found are not
+// recorded, hence they do not exist on the reconstructed volumes either.
+//
+// The reconstructed volumes are then run through the workload of
+// BootPolicyBench with the trace enabled, and the file system calls issued
+// are compared to the ones recorded.  The latency injected defaults to the
+// mean latency recorded.
+//
+
+// REPLAY_MAX_VOLUMES
+#define REPLAY_MAX_VOLUMES  256
+
+// REPLAY_MAX_HANDLES
+#define REPLAY_MAX_HANDLES  1024
+
+// REPLAY_TRACE_RECORDS
+#define REPLAY_TRACE_RECORDS  0x10000
+
+// REPLAY_ENTRY_KIND
+enum {
+  ReplayEntryUnknown,
+  ReplayEntryFile,
+  ReplayEntryDirectory
+};
+
+// REPLAY_ENTRY
+typedef struct {
+  CHAR16 PathName[MOCK_MAX_PATH_NAME_LENGTH];
+  UINT8  Kind;
+} REPLAY_ENTRY;
+
+// REPLAY_VOLUME
+typedef struct {
+  UINT64                 Device;
+  BOOLEAN                Apfs;
+  EFI_GUID               ContainerGuid;
+  EFI_GUID               VolumeGuid;
+  APPLE_APFS_VOLUME_ROLE Role;
+  CHAR16                 BlessedFile[MOCK_MAX_PATH_NAME_LENGTH];
+  UINTN                  NumberOfEntries;
+  REPLAY_ENTRY           Entries[MOCK_MAX_FILES];
+} REPLAY_VOLUME;
+
+// REPLAY_HANDLE
+/// A file opened in the trace.  Handles are looked up by value, which the
+/// file system may reuse once a file has been closed.  As Close() is not
+/// traced, a handle is remapped whenever it is returned again.
+typedef struct {
+  UINT64 Handle;
+  UINTN  Volume;
+  CHAR16 PathName[MOCK_MAX_PATH_NAME_LENGTH];
+} REPLAY_HANDLE;
+
+// REPLAY_STATISTICS
+typedef struct {
+  UINT64 Calls[AppleBootPolicyTraceGetInfo + 1];
+  UINT64 Failed[AppleBootPolicyTraceGetInfo + 1];
+  UINT64 Latency;
+} REPLAY_STATISTICS;
+
+// mOperationNames
+STATIC CONST CHAR8 *mOperationNames[] = {
+  "OpenVolume",
+  "Open",
+  "OpenEx",
+  "Read",
+  "GetInfo"
+};
+
+// mVolumes
+STATIC REPLAY_VOLUME mVolumes[REPLAY_MAX_VOLUMES];
+
+// mNumberOfVolumes
+STATIC UINTN mNumberOfVolumes = 0;
+
+// mHandles
+STATIC REPLAY_HANDLE mHandles[REPLAY_MAX_HANDLES];
+
+// mNumberOfHandles
+STATIC UINTN mNumberOfHandles = 0;
+
+// InternalReadTrace
+/** Reads a trace as written by BootPolicyBench -t, or dumped from the
+    configuration table of a machine.
+
+  @return  Returned is the trace, or NULL if it could not be read.
+**/
+STATIC
+APPLE_BOOT_POLICY_TRACE *
+InternalReadTrace (
+  IN  CONST CHAR8  *FileName,
+  OUT UINTN        *NumberOfRecords
+  )
+{
+  APPLE_BOOT_POLICY_TRACE *Trace;
+  FILE                    *File;
+  long                    Size;
+  UINTN                   HeaderSize;
+  UINTN                   MaximumNumberOfRecords;
+
+  HeaderSize = OFFSET_OF (APPLE_BOOT_POLICY_TRACE, Records);
+  Trace      = NULL;
+  File  = fopen (FileName, "rb");
+
+  if (File == NULL) {
+    return NULL;
+  }
+
+  if ((fseek (File, 0, SEEK_END) == 0)
+   && ((Size = ftell (File)) >= (long)HeaderSize)
+   && (fseek (File, 0, SEEK_SET) == 0)) {
+    Trace = AllocatePool ((UINTN)Size);
+
+    if ((Trace != NULL) && (fread (Trace, (size_t)Size, 1, File) != 1)) {
+      FreePool (Trace);
+
+      Trace = NULL;
+    }
+  }
+
+  fclose (File);
+
+  if (Trace == NULL) {
+    return NULL;
+  }
+
+  if (Trace->Revision != APPLE_BOOT_POLICY_TRACE_REVISION) {
+    FreePool (Trace);
+
+    return NULL;
+  }
+
+  MaximumNumberOfRecords = (((UINTN)Size - HeaderSize)
+                              / sizeof (*Trace->Records));
+
+  *NumberOfRecords = (UINTN)MIN (
+                              Trace->NumberOfRecords,
+                              Trace->MaximumNumberOfRecords
+                              );
+  *NumberOfRecords = MIN (*NumberOfRecords, MaximumNumberOfRecords);
+
+  return Trace;
+}
+
+// InternalJoinPathName
+/** Resolves FileName relative to BasePathName.  Path names are stored
+    without leading and trailing backslashes.
+**/
+STATIC
+VOID
+InternalJoinPathName (
+  IN  CONST CHAR16  *BasePathName,
+  IN  CONST CHAR16  *FileName,
+  OUT CHAR16        *PathName
+  )
+{
+  UINTN Length;
+
+  PathName[0] = L'\0';
+
+  if (FileName[0] != L'\\') {
+    StrnCpy (PathName, BasePathName, MOCK_MAX_PATH_NAME_LENGTH - 1);
+  }
+
+  while (FileName[0] == L'\\') {
+    ++FileName;
+  }
+
+  Length = StrLen (PathName);
+
+  if ((Length > 0) && (FileName[0] != L'\0')
+   && (Length < (MOCK_MAX_PATH_NAME_LENGTH - 1))) {
+    PathName[Length++] = L'\\';
+    PathName[Length]   = L'\0';
+  }
+
+  StrnCpy (
+    &PathName[Length],
+    FileName,
+    (MOCK_MAX_PATH_NAME_LENGTH - 1) - Length
+    );
+
+  PathName[MOCK_MAX_PATH_NAME_LENGTH - 1] = L'\0';
+
+  for (Length = StrLen (PathName);
+       (Length > 0) && (PathName[Length - 1] == L'\\');
+       --Length) {
+    PathName[Length - 1] = L'\0';
+  }
+}
+
+// InternalFindVolume
+STATIC
+UINTN
+InternalFindVolume (
+  IN UINT64  Device
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < mNumberOfVolumes; ++Index) {
+    if (mVolumes[Index].Device == Device) {
+      return Index;
+    }
+  }
+
+  if (mNumberOfVolumes == REPLAY_MAX_VOLUMES) {
+    return MAX_UINTN;
+  }
+
+  mVolumes[mNumberOfVolumes].Device = Device;
+
+  return mNumberOfVolumes++;
+}
+
+// InternalFindHandle
+STATIC
+REPLAY_HANDLE *
+InternalFindHandle (
+  IN UINT64  Handle
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < mNumberOfHandles; ++Index) {
+    if (mHandles[Index].Handle == Handle) {
+      return &mHandles[Index];
+    }
+  }
+
+  return NULL;
+}
+
+// InternalMapHandle
+STATIC
+VOID
+InternalMapHandle (
+  IN UINT64        Handle,
+  IN UINTN         Volume,
+  IN CONST CHAR16  *PathName
+  )
+{
+  REPLAY_HANDLE *File;
+
+  File = InternalFindHandle (Handle);
+
+  if (File == NULL) {
+    if (mNumberOfHandles == REPLAY_MAX_HANDLES) {
+      return;
+    }
+
+    File = &mHandles[mNumberOfHandles++];
+  }
+
+  File->Handle = Handle;
+  File->Volume = Volume;
+
+  StrCpy (File->PathName, PathName);
+}
+
+// InternalAddEntry
+STATIC
+VOID
+InternalAddEntry (
+  IN OUT REPLAY_VOLUME  *Volume,
+  IN     CONST CHAR16   *PathName,
+  IN     UINT8          Kind
+  )
+{
+  UINTN Index;
+
+  if (PathName[0] == L'\0') {
+    return;
+  }
+
+  for (Index = 0; Index < Volume->NumberOfEntries; ++Index) {
+    if (StrCmp (Volume->Entries[Index].PathName, PathName) == 0) {
+      break;
+    }
+  }
+
+  if (Index == Volume->NumberOfEntries) {
+    if (Index == ARRAY_SIZE (Volume->Entries)) {
+      return;
+    }
+
+    StrCpy (Volume->Entries[Index].PathName, PathName);
+
+    Volume->Entries[Index].Kind = ReplayEntryUnknown;
+    ++Volume->NumberOfEntries;
+  }
+
+  if (Kind != ReplayEntryUnknown) {
+    Volume->Entries[Index].Kind = Kind;
+  }
+}
+
+// InternalGetBlessedFile
+/** Retrieves the path name of the last file path node of a recorded device
+    path.  Nodes truncated by the record are ignored.
+**/
+STATIC
+BOOLEAN
+InternalGetBlessedFile (
+  IN  CONST UINT8  *Information,
+  IN  UINTN        InformationSize,
+  OUT CHAR16       *PathName
+  )
+{
+  CONST EFI_DEVICE_PATH_PROTOCOL *Node;
+  UINTN                          Offset;
+  UINTN                          Length;
+  CHAR16                         FileName[MOCK_MAX_PATH_NAME_LENGTH];
+  BOOLEAN                        Found;
+
+  Found = FALSE;
+
+  for (Offset = 0;
+       (Offset + END_DEVICE_PATH_LENGTH) <= InformationSize;
+       Offset += Length) {
+    Node   = (CONST EFI_DEVICE_PATH_PROTOCOL *)&Information[Offset];
+    Length = DevicePathNodeLength (Node);
+
+    if ((Length < END_DEVICE_PATH_LENGTH)
+     || ((Offset + Length) > InformationSize)
+     || IsDevicePathEndType (Node)) {
+      break;
+    }
+
+    if ((DevicePathType (Node) == MEDIA_DEVICE_PATH)
+     && (DevicePathSubType (Node) == MEDIA_FILEPATH_DP)) {
+      Length -= SIZE_OF_FILEPATH_DEVICE_PATH;
+      Length  = MIN (Length, sizeof (FileName) - sizeof (*FileName));
+
+      ZeroMem (FileName, sizeof (FileName));
+      CopyMem (
+        FileName,
+        &Information[Offset + SIZE_OF_FILEPATH_DEVICE_PATH],
+        Length
+        );
+
+      InternalJoinPathName (L"", FileName, PathName);
+
+      Found  = TRUE;
+      Length = DevicePathNodeLength (Node);
+    }
+  }
+
+  return Found;
+}
+
+// InternalRecordGetInfo
+STATIC
+VOID
+InternalRecordGetInfo (
+  IN CONST APPLE_BOOT_POLICY_TRACE_RECORD  *Record,
+  IN CONST REPLAY_HANDLE                   *File
+  )
+{
+  REPLAY_VOLUME             *Volume;
+  CONST EFI_GUID            *InformationType;
+  EFI_FILE_INFO             FileInfo;
+  APPLE_APFS_CONTAINER_INFO ContainerInfo;
+  APPLE_APFS_VOLUME_INFO    VolumeInfo;
+  UINTN                     Size;
+
+  Volume          = &mVolumes[File->Volume];
+  InformationType = &Record->InformationType;
+  Size            = Record->InformationSize;
+
+  if (CompareGuid (InformationType, &gEfiFileInfoGuid)) {
+    if (Size >= SIZE_OF_EFI_FILE_INFO) {
+      CopyMem (&FileInfo, Record->Information, SIZE_OF_EFI_FILE_INFO);
+
+      InternalAddEntry (
+        Volume,
+        File->PathName,
+        (((FileInfo.Attribute & EFI_FILE_DIRECTORY) != 0)
+          ? ReplayEntryDirectory
+          : ReplayEntryFile)
+        );
+    }
+  } else if (CompareGuid (InformationType, &gAppleApfsContainerInfoGuid)) {
+    if (Size >= sizeof (ContainerInfo)) {
+      CopyMem (&ContainerInfo, Record->Information, sizeof (ContainerInfo));
+      CopyGuid (&Volume->ContainerGuid, &ContainerInfo.Uuid);
+
+      Volume->Apfs = TRUE;
+    }
+  } else if (CompareGuid (InformationType, &gAppleApfsVolumeInfoGuid)) {
+    if (Size >= sizeof (VolumeInfo)) {
+      CopyMem (&VolumeInfo, Record->Information, sizeof (VolumeInfo));
+      CopyGuid (&Volume->VolumeGuid, &VolumeInfo.Uuid);
+
+      Volume->Apfs = TRUE;
+      Volume->Role = VolumeInfo.Role;
+    }
+  } else if (CompareGuid (InformationType, &gAppleBlessedSystemFileInfoGuid)) {
+    if (InternalGetBlessedFile (
+          Record->Information,
+          Size,
+          Volume->BlessedFile
+          )) {
+      InternalAddEntry (Volume, Volume->BlessedFile, ReplayEntryFile);
+    }
+  }
+}
+
+// InternalAccount
+STATIC
+VOID
+InternalAccount (
+  IN  CONST APPLE_BOOT_POLICY_TRACE_RECORD  *Records,
+  IN  UINTN                                 NumberOfRecords,
+  OUT REPLAY_STATISTICS                     *Statistics
+  )
+{
+  UINTN Index;
+
+  ZeroMem (Statistics, sizeof (*Statistics));
+
+  for (Index = 0; Index < NumberOfRecords; ++Index) {
+    if (Records[Index].Operation >= ARRAY_SIZE (Statistics->Calls)) {
+      continue;
+    }
+
+    ++Statistics->Calls[Records[Index].Operation];
+    Statistics->Latency += Records[Index].Latency;
+
+    if (EFI_ERROR ((EFI_STATUS)Records[Index].Status)) {
+      ++Statistics->Failed[Records[Index].Operation];
+    }
+  }
+}
+
+// InternalReconstruct
+/** Reconstructs the volumes from the records.
+**/
+STATIC
+VOID
+InternalReconstruct (
+  IN CONST APPLE_BOOT_POLICY_TRACE_RECORD  *Records,
+  IN UINTN                                 NumberOfRecords
+  )
+{
+  CONST APPLE_BOOT_POLICY_TRACE_RECORD *Record;
+  CONST REPLAY_HANDLE                  *File;
+  UINTN                                Volume;
+  UINTN                                Index;
+  CHAR16                               PathName[MOCK_MAX_PATH_NAME_LENGTH];
+
+  for (Index = 0; Index < NumberOfRecords; ++Index) {
+    Record = &Records[Index];
+
+    if (EFI_ERROR ((EFI_STATUS)Record->Status)) {
+      continue;
+    }
+
+    switch (Record->Operation) {
+      case AppleBootPolicyTraceOpenVolume:
+        Volume = InternalFindVolume (Record->Handle);
+
+        if ((Volume != MAX_UINTN) && (Record->NewHandle != 0)) {
+          InternalMapHandle (Record->NewHandle, Volume, L"");
+        }
+
+        break;
+
+      case AppleBootPolicyTraceOpen:
+      case AppleBootPolicyTraceOpenEx:
+        File = InternalFindHandle (Record->Handle);
+
+        if (File == NULL) {
+          break;
+        }
+
+        InternalJoinPathName (File->PathName, Record->PathName, PathName);
+        InternalAddEntry (
+          &mVolumes[File->Volume],
+          PathName,
+          ReplayEntryUnknown
+          );
+
+        if (Record->NewHandle != 0) {
+          InternalMapHandle (Record->NewHandle, File->Volume, PathName);
+        }
+
+        break;
+
+      case AppleBootPolicyTraceGetInfo:
+        File = InternalFindHandle (Record->Handle);
+
+        if ((File != NULL) && (Record->InformationSize > 0)) {
+          InternalRecordGetInfo (Record, File);
+        }
+
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+// InternalIsImplied
+/** Checks whether another entry of Volume lies below PathName.
+**/
+STATIC
+BOOLEAN
+InternalIsImplied (
+  IN CONST REPLAY_VOLUME  *Volume,
+  IN CONST CHAR16         *PathName
+  )
+{
+  UINTN Length;
+  UINTN Index;
+
+  Length = StrLen (PathName);
+
+  for (Index = 0; Index < Volume->NumberOfEntries; ++Index) {
+    if ((StrnCmp (Volume->Entries[Index].PathName, PathName, Length) == 0)
+     && (Volume->Entries[Index].PathName[Length] == L'\\')) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+// InternalInstallVolumes
+STATIC
+EFI_STATUS
+InternalInstallVolumes (
+  OUT MOCK_VOLUME  **Volumes,
+  OUT UINTN        *NumberOfEntries
+  )
+{
+  EFI_STATUS          Status;
+
+  UINTN               Index;
+  UINTN               Index2;
+  CONST REPLAY_VOLUME *Volume;
+  CONST REPLAY_ENTRY  *Entry;
+
+  *NumberOfEntries = 0;
+
+  for (Index = 0; Index < mNumberOfVolumes; ++Index) {
+    Volume         = &mVolumes[Index];
+    Volumes[Index] = MockCreateVolume ();
+
+    if (Volumes[Index] == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    if (Volume->Apfs) {
+      MockSetApfsInfo (
+        Volumes[Index],
+        &Volume->ContainerGuid,
+        &Volume->VolumeGuid,
+        Volume->Role
+        );
+    }
+
+    for (Index2 = 0; Index2 < Volume->NumberOfEntries; ++Index2) {
+      Entry  = &Volume->Entries[Index2];
+      Status = EFI_SUCCESS;
+
+      if (Entry->Kind == ReplayEntryDirectory) {
+        Status = MockAddDirectory (Volumes[Index], Entry->PathName);
+      } else if ((Entry->Kind == ReplayEntryFile)
+              || !InternalIsImplied (Volume, Entry->PathName)) {
+        Status = MockAddFile (Volumes[Index], Entry->PathName);
+      }
+
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      ++*NumberOfEntries;
+    }
+
+    if (Volume->BlessedFile[0] != L'\0') {
+      MockBlessFile (Volumes[Index], Volume->BlessedFile);
+    }
+
+    Status = MockInstallVolume (Volumes[Index]);
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+// InternalPrintComparison
+STATIC
+BOOLEAN
+InternalPrintComparison (
+  IN CONST REPLAY_STATISTICS  *Recorded,
+  IN CONST REPLAY_STATISTICS  *Replayed
+  )
+{
+  UINTN   Index;
+  BOOLEAN Equal;
+
+  Equal = TRUE;
+
+  printf ("  operation      recorded    failed  replayed    failed\n");
+
+  for (Index = 0; Index < ARRAY_SIZE (Recorded->Calls); ++Index) {
+    if ((Recorded->Calls[Index] == 0) && (Replayed->Calls[Index] == 0)) {
+      continue;
+    }
+
+    printf (
+      "  %-12s %10llu %9llu %9llu %9llu\n",
+      mOperationNames[Index],
+      (unsigned long long)Recorded->Calls[Index],
+      (unsigned long long)Recorded->Failed[Index],
+      (unsigned long long)Replayed->Calls[Index],
+      (unsigned long long)Replayed->Failed[Index]
+      );
+
+    if ((Recorded->Calls[Index] != Replayed->Calls[Index])
+     || (Recorded->Failed[Index] != Replayed->Failed[Index])) {
+      Equal = FALSE;
+    }
+  }
+
+  printf (
+    "  latency      %10.3f ms          %9.3f ms\n",
+    (double)Recorded->Latency / 1000000.0,
+    (double)Replayed->Latency / 1000000.0
+    );
+
+  return Equal;
+}
+
+// InternalUsage
+STATIC
+int
+InternalUsage (
+  IN CONST CHAR8  *Name
+  )
+{
+  fprintf (
+    stderr,
+    "Usage: %s [-l latency_ns] [-e] trace_file\n"
+    "\n"
+    "  -l  latency injected per file system call  (default: mean recorded)\n"
+    "  -e  fail unless the replayed calls equal the recorded ones\n",
+    Name
+    );
+
+  return 1;
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  EFI_STATUS                    Status;
+
+  APPLE_BOOT_POLICY_TRACE       *Trace;
+  CONST APPLE_BOOT_POLICY_TRACE *ReplayTrace;
+  UINTN                         NumberOfRecords;
+  REPLAY_STATISTICS             Recorded;
+  REPLAY_STATISTICS             Replayed;
+  EFI_SYSTEM_TABLE              *SystemTable;
+  MOCK_VOLUME                   *Volumes[REPLAY_MAX_VOLUMES];
+  UINTN                         NumberOfEntries;
+  BOOT_POLICY_WORKLOAD_RESULT   Result;
+  UINT64                        Latency;
+  UINT64                        NumberOfCalls;
+  BOOLEAN                       LatencySet;
+  BOOLEAN                       Exact;
+  BOOLEAN                       Equal;
+  int                           Option;
+
+  Latency    = 0;
+  LatencySet = FALSE;
+  Exact      = FALSE;
+
+  while ((Option = getopt (argc, argv, "l:e")) != -1) {
+    switch (Option) {
+      case 'l':
+        Latency    = strtoull (optarg, NULL, 10);
+        LatencySet = TRUE;
+        break;
+
+      case 'e':
+        Exact = TRUE;
+        break;
+
+      default:
+        return InternalUsage (argv[0]);
+    }
+  }
+
+  if (optind != (argc - 1)) {
+    return InternalUsage (argv[0]);
+  }
+
+  Trace = InternalReadTrace (argv[optind], &NumberOfRecords);
+
+  if (Trace == NULL) {
+    fprintf (
+      stderr,
+      "%s is not a revision %u trace\n",
+      argv[optind],
+      APPLE_BOOT_POLICY_TRACE_REVISION
+      );
+
+    return 1;
+  }
+
+  if ((Trace->Flags & APPLE_BOOT_POLICY_TRACE_RECORD_INFORMATION) == 0) {
+    fprintf (
+      stderr,
+      "Warning: GetInfo() buffers not recorded, APFS and blessed info lost\n"
+      );
+  }
+
+  if (Trace->NumberOfRecords > NumberOfRecords) {
+    fprintf (
+      stderr,
+      "Warning: %llu of %llu records dropped\n",
+      (unsigned long long)(Trace->NumberOfRecords - NumberOfRecords),
+      (unsigned long long)Trace->NumberOfRecords
+      );
+  }
+
+  InternalAccount (Trace->Records, NumberOfRecords, &Recorded);
+  InternalReconstruct (Trace->Records, NumberOfRecords);
+
+  if (!LatencySet && (NumberOfRecords > 0)) {
+    Latency = (Recorded.Latency / NumberOfRecords);
+  }
+
+  SystemTable = MockInitialize ();
+  Status      = InternalInstallVolumes (Volumes, &NumberOfEntries);
+
+  if (!EFI_ERROR (Status)) {
+    Status = BootPolicyEnableTrace (REPLAY_TRACE_RECORDS);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = BootPolicyStartDriver (SystemTable);
+  }
+
+  if (EFI_ERROR (Status)) {
+    fprintf (stderr, "Setup failed: 0x%llX\n", (unsigned long long)Status);
+
+    return 1;
+  }
+
+  MockSetLatency (Latency);
+
+  BootPolicyRunWorkload (Volumes, mNumberOfVolumes, &Result);
+
+  ReplayTrace = MockGetConfigurationTable (&gAppleBootPolicyTraceGuid);
+
+  if (ReplayTrace == NULL) {
+    return 1;
+  }
+
+  InternalAccount (
+    ReplayTrace->Records,
+    (UINTN)MIN (
+             ReplayTrace->NumberOfRecords,
+             ReplayTrace->MaximumNumberOfRecords
+             ),
+    &Replayed
+    );
+
+  NumberOfCalls = (Result.FileSystem.OpenVolume
+                     + Result.FileSystem.Open
+                     + Result.FileSystem.GetInfo);
+
+  printf (
+    "%s: %u records, %u volumes, %u entries reconstructed, %llu ns injected\n",
+    argv[optind],
+    (unsigned)NumberOfRecords,
+    (unsigned)mNumberOfVolumes,
+    (unsigned)NumberOfEntries,
+    (unsigned long long)Latency
+    );
+
+  Equal = InternalPrintComparison (&Recorded, &Replayed);
+
+  printf (
+    "  replay: %llu calls, %u bootable, %.3f ms wall, %llu files left open\n",
+    (unsigned long long)NumberOfCalls,
+    (unsigned)Result.BootableVolumes,
+    (double)Result.WallTime / 1000000.0,
+    (unsigned long long)Result.FileSystem.OpenFiles
+    );
+
+  FreePool (Trace);
+
+  if (Result.FileSystem.OpenFiles != 0) {
+    return 2;
+  }
+
+  return ((Exact && !Equal) ? 3 : 0);
+}
@@ -0,0 +1,257 @@
+#include <AppleMacEfi.h>
+
+#include <Guid/AppleApfsInfo.h>
+#include <Guid/AppleBootPolicyTrace.h>
+#include <Guid/AppleBootPolicyVariable.h>
+
+#include <Protocol/AppleBootPolicy.h>
+#include <Protocol/AppleBootPolicyEx.h>
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+
+#include "BootPolicyWorkload.h"
+
+// APFS_VOLUME_ROOT
+/// The entries returned by GetApfsRecoveryVolumes(), as defined by the
+/// driver.  Entries of one recovery volume share its root.
+typedef struct {
+  EFI_HANDLE        Handle;
+  CHAR16            *VolumeDirName;
+  EFI_FILE_PROTOCOL *Root;
+} APFS_VOLUME_ROOT;
+
+EFI_STATUS
+EFIAPI
+AppleBootPolicyMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  );
+
+// mBootPolicy
+STATIC APPLE_BOOT_POLICY_PROTOCOL *mBootPolicy = NULL;
+
+// mBootPolicyEx
+STATIC APPLE_BOOT_POLICY_EX_PROTOCOL *mBootPolicyEx = NULL;
+
+// BootPolicyStartDriver
+EFI_STATUS
+BootPolicyStartDriver (
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS Status;
+
+  Status = AppleBootPolicyMain (NULL, SystemTable);
+
+  if (!EFI_ERROR (Status)) {
+    Status = gBS->LocateProtocol (
+                    &gAppleBootPolicyProtocolGuid,
+                    NULL,
+                    (VOID **)&mBootPolicy
+                    );
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = gBS->LocateProtocol (
+                    &gAppleBootPolicyExProtocolGuid,
+                    NULL,
+                    (VOID **)&mBootPolicyEx
+                    );
+  }
+
+  return Status;
+}
+
+// BootPolicyEnableTrace
+EFI_STATUS
+BootPolicyEnableTrace (
+  IN UINT32  MaximumNumberOfRecords
+  )
+{
+  APPLE_BOOT_POLICY_TRACE_CONFIG Config;
+
+  Config.MaximumNumberOfRecords = MaximumNumberOfRecords;
+  Config.Flags                  = APPLE_BOOT_POLICY_TRACE_RECORD_INFORMATION;
+
+  return gRT->SetVariable (
+                APPLE_BOOT_POLICY_TRACE_VARIABLE_NAME,
+                &gAppleBootPolicyVariableGuid,
+                EFI_VARIABLE_BOOTSERVICE_ACCESS,
+                sizeof (Config),
+                (VOID *)&Config
+                );
+}
+
+// InternalFreeRecoveryVolumes
+STATIC
+VOID
+InternalFreeRecoveryVolumes (
+  IN APFS_VOLUME_ROOT  **Volumes,
+  IN UINTN             NumberOfEntries
+  )
+{
+  UINTN Index;
+  UINTN Index2;
+
+  for (Index = 0; Index < NumberOfEntries; ++Index) {
+    for (Index2 = 0; Index2 < Index; ++Index2) {
+      if (Volumes[Index2]->Root == Volumes[Index]->Root) {
+        break;
+      }
+    }
+
+    if (Index2 == Index) {
+      Volumes[Index]->Root->Close (Volumes[Index]->Root);
+    }
+  }
+
+  for (Index = 0; Index < NumberOfEntries; ++Index) {
+    FreePool (Volumes[Index]->VolumeDirName);
+    FreePool (Volumes[Index]);
+  }
+
+  FreePool (Volumes);
+}
+
+// BootPolicyRunWorkload
+VOID
+BootPolicyRunWorkload (
+  IN  MOCK_VOLUME                  **Volumes,
+  IN  UINTN                        NumberOfVolumes,
+  OUT BOOT_POLICY_WORKLOAD_RESULT  *Result
+  )
+{
+  EFI_STATUS                      Status;
+
+  UINT64                          StartTime;
+  APPLE_BOOT_POLICY_VOLUME_CURSOR *Cursor;
+  EFI_HANDLE                      Device;
+  EFI_DEVICE_PATH_PROTOCOL        *FilePath;
+  CHAR16                          *BootPathName;
+  EFI_HANDLE                      BootDevice;
+  EFI_HANDLE                      ApfsVolumeHandle;
+  CHAR16                          *FullPathName;
+  VOID                            *Reserved;
+  EFI_FILE_PROTOCOL               *Root;
+  EFI_HANDLE                      RecoveryHandle;
+  APPLE_BOOT_POLICY_VOLUME_LIST   *List;
+  VOID                            *RecoveryVolumes;
+  UINTN                           NumberOfEntries;
+  UINTN                           Index;
+
+  ZeroMem (Result, sizeof (*Result));
+
+  MockResetCounters ();
+
+  StartTime = GetPerformanceCounter ();
+
+  Status = mBootPolicyEx->OpenVolumeCursor (0, &Cursor);
+
+  if (!EFI_ERROR (Status)) {
+    while (TRUE) {
+      Status = mBootPolicyEx->GetNextVolume (Cursor, &Device, &FilePath);
+
+      if (Status == EFI_NOT_FOUND) {
+        break;
+      }
+
+      if (EFI_ERROR (Status)) {
+        ++Result->Failures;
+        continue;
+      }
+
+      ++Result->BootableVolumes;
+
+      BootPathName = NULL;
+
+      Status = mBootPolicy->GetBootInfo (
+                              FilePath,
+                              &BootPathName,
+                              &BootDevice,
+                              &ApfsVolumeHandle
+                              );
+
+      //
+      // GetBootInfo() returns EFI_OUT_OF_RESOURCES along with the path name
+      // for file path device paths, which is counted as a failure here.
+      //
+      if (EFI_ERROR (Status)) {
+        ++Result->Failures;
+      }
+
+      if (BootPathName != NULL) {
+        FreePool (BootPathName);
+      }
+
+      Status = mBootPolicy->GetPathNameOnApfsRecovery (
+                              FilePath,
+                              L"\\",
+                              &FullPathName,
+                              &Reserved,
+                              &Root,
+                              &RecoveryHandle
+                              );
+
+      if (!EFI_ERROR (Status)) {
+        FreePool (FullPathName);
+        Root->Close (Root);
+      }
+
+      FreePool (FilePath);
+    }
+
+    mBootPolicyEx->CloseVolumeCursor (Cursor);
+  } else {
+    ++Result->Failures;
+  }
+
+  Status = mBootPolicyEx->GetVolumesByRole (
+                            APPLE_APFS_VOLUME_ROLE_RECOVERY,
+                            &List
+                            );
+
+  if (!EFI_ERROR (Status)) {
+    FreePool (List);
+  }
+
+  for (Index = 0; Index < NumberOfVolumes; ++Index) {
+    if (Volumes[Index]->Role != APPLE_APFS_VOLUME_ROLE_PREBOOT) {
+      continue;
+    }
+
+    Status = mBootPolicy->GetApfsRecoveryVolumes (
+                            Volumes[Index]->Handle,
+                            &RecoveryVolumes,
+                            &NumberOfEntries
+                            );
+
+    if (!EFI_ERROR (Status)) {
+      InternalFreeRecoveryVolumes (RecoveryVolumes, NumberOfEntries);
+    } else {
+      ++Result->Failures;
+    }
+  }
+
+  for (Index = 0; Index < NumberOfVolumes; ++Index) {
+    if ((Volumes[Index]->Role == APPLE_APFS_VOLUME_ROLE_PREBOOT)
+     || (Volumes[Index]->Role == APPLE_APFS_VOLUME_ROLE_RECOVERY)) {
+      continue;
+    }
+
+    Status = mBootPolicy->GetBootFile (Volumes[Index]->Handle, &FilePath);
+
+    if (!EFI_ERROR (Status)) {
+      FreePool (FilePath);
+    } else {
+      ++Result->Failures;
+    }
+  }
+
+  Result->WallTime = GetTimeInNanoSecond (GetPerformanceCounter () - StartTime);
+
+  MockGetCounters (&Result->BootServices, &Result->FileSystem);
+}
@@ -0,0 +1,47 @@
+#ifndef BOOT_POLICY_WORKLOAD_H_
+#define BOOT_POLICY_WORKLOAD_H_
+
+#include "../Mock/MockUefi.h"
+
+// BOOT_POLICY_WORKLOAD_RESULT
+typedef struct {
+  UINT64                      WallTime;
+  UINTN                       BootableVolumes;
+  UINTN                       Failures;
+  MOCK_BOOT_SERVICES_COUNTERS BootServices;
+  MOCK_FILE_SYSTEM_COUNTERS   FileSystem;
+} BOOT_POLICY_WORKLOAD_RESULT;
+
+// BootPolicyEnableTrace
+/** Sets the variable enabling the file system trace of AppleBootPolicyDxe,
+    including the buffers returned by GetInfo().  To be called before
+    BootPolicyStartDriver().
+**/
+EFI_STATUS
+BootPolicyEnableTrace (
+  IN UINT32  MaximumNumberOfRecords
+  );
+
+// BootPolicyStartDriver
+/** Runs the entry point of AppleBootPolicyDxe and locates the protocols it
+    installs for BootPolicyRunWorkload().
+**/
+EFI_STATUS
+BootPolicyStartDriver (
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  );
+
+// BootPolicyRunWorkload
+/** Calls every protocol function the way a boot picker does: enumerates the
+    bootable volumes, resolves each boot file and its recovery directory,
+    queries the recovery volumes of each preboot volume and finally resolves
+    the boot file of every file system via the legacy GetBootFile().
+**/
+VOID
+BootPolicyRunWorkload (
+  IN  MOCK_VOLUME                  **Volumes,
+  IN  UINTN                        NumberOfVolumes,
+  OUT BOOT_POLICY_WORKLOAD_RESULT  *Result
+  );
+
+#endif // BOOT_POLICY_WORKLOAD_H_
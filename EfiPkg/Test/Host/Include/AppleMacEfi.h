@@ -0,0 +1,325 @@
+#ifndef APPLE_MAC_EFI_H_
+#define APPLE_MAC_EFI_H_
+
+//
+// Host stand-in for the firmware base headers.  Only the definitions used by
+// the drivers built in EfiPkg/Test/Host are provided, with the layouts of
+// the UEFI specification where the drivers depend on them.
+//
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t   UINT8;
+typedef uint16_t  UINT16;
+typedef uint32_t  UINT32;
+typedef uint64_t  UINT64;
+typedef int8_t    INT8;
+typedef int16_t   INT16;
+typedef int32_t   INT32;
+typedef int64_t   INT64;
+typedef uintptr_t UINTN;
+typedef intptr_t  INTN;
+typedef UINT8     BOOLEAN;
+typedef char      CHAR8;
+typedef UINT16    CHAR16;
+typedef void      VOID;
+
+typedef UINTN     EFI_STATUS;
+typedef VOID      *EFI_HANDLE;
+typedef VOID      *EFI_EVENT;
+typedef UINTN     EFI_TPL;
+typedef UINT64    EFI_PHYSICAL_ADDRESS;
+
+typedef struct {
+  UINT32 Data1;
+  UINT16 Data2;
+  UINT16 Data3;
+  UINT8  Data4[8];
+} GUID;
+
+typedef GUID EFI_GUID;
+
+typedef struct {
+  UINT16 Year;
+  UINT8  Month;
+  UINT8  Day;
+  UINT8  Hour;
+  UINT8  Minute;
+  UINT8  Second;
+  UINT8  Pad1;
+  UINT32 Nanosecond;
+  INT16  TimeZone;
+  UINT8  Daylight;
+  UINT8  Pad2;
+} EFI_TIME;
+
+#define IN
+#define OUT
+#define OPTIONAL
+#define CONST     const
+#define STATIC    static
+#define EFIAPI
+#define PACKED
+
+#define TRUE   ((BOOLEAN)(1 == 1))
+#define FALSE  ((BOOLEAN)(0 == 1))
+
+#undef NULL
+#define NULL  ((VOID *)0)
+
+#define VA_LIST            __builtin_va_list
+#define VA_START(M, P)     __builtin_va_start (M, P)
+#define VA_ARG(M, T)       __builtin_va_arg (M, T)
+#define VA_END(M)          __builtin_va_end (M)
+
+#define MAX_BIT       (((UINTN)1) << ((sizeof (UINTN) * 8) - 1))
+#define MAX_UINT8     ((UINT8)0xFF)
+#define MAX_UINT16    ((UINT16)0xFFFF)
+#define MAX_UINT32    ((UINT32)0xFFFFFFFF)
+#define MAX_UINT64    ((UINT64)0xFFFFFFFFFFFFFFFFULL)
+#define MAX_UINTN     ((UINTN)-1)
+
+#define SIZE_4KB      0x00001000
+
+#define ARRAY_SIZE(Array)          (sizeof (Array) / sizeof ((Array)[0]))
+#define OFFSET_OF(Type, Field)     offsetof (Type, Field)
+#define BASE_CR(Record, Type, Field)                                       \
+  ((Type *)((CHAR8 *)(Record) - OFFSET_OF (Type, Field)))
+#define CR(Record, Type, Field, Signature)  BASE_CR (Record, Type, Field)
+#define SIGNATURE_16(A, B)         ((A) | ((B) << 8))
+#define SIGNATURE_32(A, B, C, D)   (SIGNATURE_16 (A, B) | (SIGNATURE_16 (C, D) << 16))
+#define MIN(A, B)                  (((A) < (B)) ? (A) : (B))
+#define MAX(A, B)                  (((A) > (B)) ? (A) : (B))
+#define BIT0                       0x00000001
+#define ALIGN_VALUE(Value, Alignment)                                      \
+  ((Value) + (((Alignment) - (Value)) & ((Alignment) - 1)))
+
+#define ENCODE_ERROR(Code)  ((EFI_STATUS)(MAX_BIT | (Code)))
+#define EFI_ERROR(Status)   (((INTN)(EFI_STATUS)(Status)) < 0)
+
+#define EFI_SUCCESS               0
+#define EFI_LOAD_ERROR            ENCODE_ERROR (1)
+#define EFI_INVALID_PARAMETER     ENCODE_ERROR (2)
+#define EFI_UNSUPPORTED           ENCODE_ERROR (3)
+#define EFI_BUFFER_TOO_SMALL      ENCODE_ERROR (5)
+#define EFI_NOT_READY             ENCODE_ERROR (6)
+#define EFI_DEVICE_ERROR          ENCODE_ERROR (7)
+#define EFI_OUT_OF_RESOURCES      ENCODE_ERROR (9)
+#define EFI_NO_MEDIA              ENCODE_ERROR (12)
+#define EFI_MEDIA_CHANGED         ENCODE_ERROR (13)
+#define EFI_NOT_FOUND             ENCODE_ERROR (14)
+#define EFI_ACCESS_DENIED         ENCODE_ERROR (15)
+#define EFI_TIMEOUT               ENCODE_ERROR (18)
+#define EFI_NOT_STARTED           ENCODE_ERROR (19)
+#define EFI_ALREADY_STARTED       ENCODE_ERROR (20)
+#define EFI_ABORTED               ENCODE_ERROR (21)
+#define EFI_END_OF_FILE           ENCODE_ERROR (31)
+
+#define EFI_WARN_BUFFER_TOO_SMALL 4
+
+#define TPL_APPLICATION  4
+#define TPL_CALLBACK     8
+#define TPL_NOTIFY       16
+#define TPL_HIGH_LEVEL   31
+
+#define EVT_TIMER                      0x80000000
+#define EVT_NOTIFY_WAIT                0x00000100
+#define EVT_NOTIFY_SIGNAL              0x00000200
+#define EVT_SIGNAL_EXIT_BOOT_SERVICES  0x00000201
+
+#define EFI_VARIABLE_NON_VOLATILE        0x00000001
+#define EFI_VARIABLE_BOOTSERVICE_ACCESS  0x00000002
+#define EFI_VARIABLE_RUNTIME_ACCESS      0x00000004
+
+#define DEBUG_INFO   0x00000040
+#define DEBUG_ERROR  0x80000000
+#define EFI_D_INFO   DEBUG_INFO
+#define EFI_D_ERROR  DEBUG_ERROR
+
+#define ASSERT(Expression)
+#define ASSERT_EFI_ERROR(Status)
+#define DEBUG(Expression)
+
+#include <Protocol/DevicePath.h>
+
+typedef
+VOID
+(EFIAPI *EFI_EVENT_NOTIFY)(
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
+typedef enum {
+  AllHandles,
+  ByRegisterNotify,
+  ByProtocol
+} EFI_LOCATE_SEARCH_TYPE;
+
+typedef enum {
+  EFI_NATIVE_INTERFACE
+} EFI_INTERFACE_TYPE;
+
+typedef enum {
+  TimerCancel,
+  TimerPeriodic,
+  TimerRelative
+} EFI_TIMER_DELAY;
+
+typedef enum {
+  EfiReservedMemoryType,
+  EfiLoaderCode,
+  EfiLoaderData,
+  EfiBootServicesCode,
+  EfiBootServicesData,
+  EfiRuntimeServicesCode,
+  EfiRuntimeServicesData,
+  EfiConventionalMemory
+} EFI_MEMORY_TYPE;
+
+// EFI_BOOT_SERVICES
+/// Reduced to the services used by the drivers built on the host.
+typedef struct {
+  EFI_TPL
+  (EFIAPI *RaiseTPL)(
+    IN EFI_TPL  NewTpl
+    );
+
+  VOID
+  (EFIAPI *RestoreTPL)(
+    IN EFI_TPL  OldTpl
+    );
+
+  EFI_STATUS
+  (EFIAPI *CreateEvent)(
+    IN  UINT32            Type,
+    IN  EFI_TPL           NotifyTpl,
+    IN  EFI_EVENT_NOTIFY  NotifyFunction,
+    IN  VOID              *NotifyContext,
+    OUT EFI_EVENT         *Event
+    );
+
+  EFI_STATUS
+  (EFIAPI *SignalEvent)(
+    IN EFI_EVENT  Event
+    );
+
+  EFI_STATUS
+  (EFIAPI *CloseEvent)(
+    IN EFI_EVENT  Event
+    );
+
+  EFI_STATUS
+  (EFIAPI *InstallProtocolInterface)(
+    IN OUT EFI_HANDLE          *Handle,
+    IN     EFI_GUID            *Protocol,
+    IN     EFI_INTERFACE_TYPE  InterfaceType,
+    IN     VOID                *Interface
+    );
+
+  EFI_STATUS
+  (EFIAPI *ReinstallProtocolInterface)(
+    IN EFI_HANDLE  Handle,
+    IN EFI_GUID    *Protocol,
+    IN VOID        *OldInterface,
+    IN VOID        *NewInterface
+    );
+
+  EFI_STATUS
+  (EFIAPI *UninstallProtocolInterface)(
+    IN EFI_HANDLE  Handle,
+    IN EFI_GUID    *Protocol,
+    IN VOID        *Interface
+    );
+
+  EFI_STATUS
+  (EFIAPI *HandleProtocol)(
+    IN  EFI_HANDLE  Handle,
+    IN  EFI_GUID    *Protocol,
+    OUT VOID        **Interface
+    );
+
+  EFI_STATUS
+  (EFIAPI *RegisterProtocolNotify)(
+    IN  EFI_GUID   *Protocol,
+    IN  EFI_EVENT  Event,
+    OUT VOID       **Registration
+    );
+
+  EFI_STATUS
+  (EFIAPI *LocateDevicePath)(
+    IN     EFI_GUID                  *Protocol,
+    IN OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath,
+    OUT    EFI_HANDLE                *Device
+    );
+
+  EFI_STATUS
+  (EFIAPI *InstallConfigurationTable)(
+    IN EFI_GUID  *Guid,
+    IN VOID      *Table
+    );
+
+  EFI_STATUS
+  (EFIAPI *LocateHandleBuffer)(
+    IN     EFI_LOCATE_SEARCH_TYPE  SearchType,
+    IN     EFI_GUID                *Protocol OPTIONAL,
+    IN     VOID                    *SearchKey OPTIONAL,
+    IN OUT UINTN                   *NoHandles,
+    OUT    EFI_HANDLE              **Buffer
+    );
+
+  EFI_STATUS
+  (EFIAPI *LocateProtocol)(
+    IN  EFI_GUID  *Protocol,
+    IN  VOID      *Registration OPTIONAL,
+    OUT VOID      **Interface
+    );
+
+  EFI_STATUS
+  (EFIAPI *InstallMultipleProtocolInterfaces)(
+    IN OUT EFI_HANDLE  *Handle,
+    ...
+    );
+
+  EFI_STATUS
+  (EFIAPI *Stall)(
+    IN UINTN  Microseconds
+    );
+} EFI_BOOT_SERVICES;
+
+// EFI_RUNTIME_SERVICES
+/// Reduced to the variable services.
+typedef struct {
+  EFI_STATUS
+  (EFIAPI *GetVariable)(
+    IN     CHAR16    *VariableName,
+    IN     EFI_GUID  *VendorGuid,
+    OUT    UINT32    *Attributes OPTIONAL,
+    IN OUT UINTN     *DataSize,
+    OUT    VOID      *Data OPTIONAL
+    );
+
+  EFI_STATUS
+  (EFIAPI *SetVariable)(
+    IN CHAR16    *VariableName,
+    IN EFI_GUID  *VendorGuid,
+    IN UINT32    Attributes,
+    IN UINTN     DataSize,
+    IN VOID      *Data
+    );
+} EFI_RUNTIME_SERVICES;
+
+// EFI_SYSTEM_TABLE
+typedef struct {
+  EFI_BOOT_SERVICES    *BootServices;
+  EFI_RUNTIME_SERVICES *RuntimeServices;
+} EFI_SYSTEM_TABLE;
+
+// EFI_LOCK
+typedef struct {
+  EFI_TPL Tpl;
+  EFI_TPL OwnerTpl;
+  UINTN   Lock;
+} EFI_LOCK;
+
+#endif // APPLE_MAC_EFI_H_
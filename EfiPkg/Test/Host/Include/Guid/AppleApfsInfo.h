@@ -0,0 +1,35 @@
+#ifndef APPLE_APFS_INFO_H_
+#define APPLE_APFS_INFO_H_
+
+// APPLE_APFS_VOLUME_ROLE
+typedef UINT32 APPLE_APFS_VOLUME_ROLE;
+
+#define APPLE_APFS_VOLUME_ROLE_UNDEFINED  0x00
+#define APPLE_APFS_VOLUME_ROLE_SYSTEM     0x01
+#define APPLE_APFS_VOLUME_ROLE_USER       0x02
+#define APPLE_APFS_VOLUME_ROLE_RECOVERY   0x04
+#define APPLE_APFS_VOLUME_ROLE_VM         0x08
+#define APPLE_APFS_VOLUME_ROLE_PREBOOT    0x10
+#define APPLE_APFS_VOLUME_ROLE_INSTALLER  0x20
+#define APPLE_APFS_VOLUME_ROLE_DATA       0x40
+
+// APPLE_APFS_CONTAINER_INFO
+typedef struct {
+  UINT32   Always1;
+  EFI_GUID Uuid;
+} APPLE_APFS_CONTAINER_INFO;
+
+// APPLE_APFS_VOLUME_INFO
+typedef struct {
+  UINT32                 Always1;
+  EFI_GUID               Uuid;
+  APPLE_APFS_VOLUME_ROLE Role;
+} APPLE_APFS_VOLUME_INFO;
+
+// gAppleApfsContainerInfoGuid
+extern EFI_GUID gAppleApfsContainerInfoGuid;
+
+// gAppleApfsVolumeInfoGuid
+extern EFI_GUID gAppleApfsVolumeInfoGuid;
+
+#endif // APPLE_APFS_INFO_H_
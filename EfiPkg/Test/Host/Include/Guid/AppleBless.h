@@ -0,0 +1,17 @@
+#ifndef APPLE_BLESS_H_
+#define APPLE_BLESS_H_
+
+#define APPLE_BOOTER_DEFAULT_FILE_NAME   L"\\System\\Library\\CoreServices\\boot.efi"
+#define APPLE_REMOVABLE_MEDIA_FILE_NAME  L"\\EFI\\APPLE\\X64\\BOOT.EFI"
+#define EFI_REMOVABLE_MEDIA_FILE_NAME    L"\\EFI\\BOOT\\BOOTX64.EFI"
+#define APPLE_BOOTER_ROOT_FILE_NAME      L"\\boot.efi"
+
+// gAppleBlessedSystemFileInfoGuid
+/// Information type returning the device path of the blessed system file.
+extern EFI_GUID gAppleBlessedSystemFileInfoGuid;
+
+// gAppleBlessedSystemFolderInfoGuid
+/// Information type returning the device path of the blessed system folder.
+extern EFI_GUID gAppleBlessedSystemFolderInfoGuid;
+
+#endif // APPLE_BLESS_H_
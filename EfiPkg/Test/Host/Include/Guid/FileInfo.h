@@ -0,0 +1,21 @@
+#ifndef FILE_INFO_H_
+#define FILE_INFO_H_
+
+// EFI_FILE_INFO
+typedef struct {
+  UINT64   Size;
+  UINT64   FileSize;
+  UINT64   PhysicalSize;
+  EFI_TIME CreateTime;
+  EFI_TIME LastAccessTime;
+  EFI_TIME ModificationTime;
+  UINT64   Attribute;
+  CHAR16   FileName[1];
+} EFI_FILE_INFO;
+
+#define SIZE_OF_EFI_FILE_INFO  OFFSET_OF (EFI_FILE_INFO, FileName)
+
+// gEfiFileInfoGuid
+extern EFI_GUID gEfiFileInfoGuid;
+
+#endif // FILE_INFO_H_
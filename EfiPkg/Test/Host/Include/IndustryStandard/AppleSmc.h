@@ -0,0 +1,81 @@
+#ifndef APPLE_SMC_H_
+#define APPLE_SMC_H_
+
+// SMC types
+typedef UINT32 SMC_KEY;
+typedef UINT32 SMC_KEY_TYPE;
+typedef UINT8  SMC_KEY_ATTRIBUTES;
+typedef UINT32 SMC_KEY_INDEX;
+typedef UINT8  SMC_DATA;
+typedef UINT8  SMC_DATA_SIZE;
+typedef UINT8  SMC_STATUS;
+typedef UINT8  SMC_RESULT;
+typedef UINT8  SMC_COMMAND;
+typedef UINT32 SMC_ADDRESS;
+typedef UINT16 SMC_FLASH_SIZE;
+typedef UINT8  SMC_FLASH_TYPE;
+
+// SMC_MAKE_KEY
+#define SMC_MAKE_KEY(A, B, C, D)  \
+  ((SMC_KEY)(((A) << 24) | ((B) << 16) | ((C) << 8) | (D)))
+
+#define SMC_KEY_LDKN  SMC_MAKE_KEY ('L', 'D', 'K', 'N')
+
+#define SMC_MAX_DATA_SIZE   32
+#define SMC_FLASH_SIZE_MAX  0x0800
+
+// MMIO register offsets
+#define SMC_MMIO_BASE_ADDRESS          0xFEF00000
+#define SMC_MMIO_DATA_VARIABLE         0x00
+#define SMC_MMIO_DATA_FIXED            0x78
+#define SMC_MMIO_READ_KEY              0x78
+#define SMC_MMIO_READ_KEY_TYPE         0x7C
+#define SMC_MMIO_READ_DATA_SIZE        0x7D
+#define SMC_MMIO_WRITE_DATA_SIZE       0x7D
+#define SMC_MMIO_READ_KEY_ATTRIBUTES   0x7E
+#define SMC_MMIO_WRITE_KEY_ATTRIBUTES  0x7E
+#define SMC_MMIO_WRITE_COMMAND         0x7F
+#define SMC_MMIO_READ_RESULT           0x4004
+#define SMC_MMIO_READ_KEY_STATUS       0x4005
+
+// Status flags
+#define SMC_STATUS_AWAITING_DATA  BIT0
+#define SMC_STATUS_IB_CLOSED      0x02
+#define SMC_STATUS_BUSY           0x04
+#define SMC_STATUS_KEY_DONE       0x10
+#define SMC_STATUS_UKN_0x16       0x16
+#define SMC_STATUS_READY          0x20
+#define SMC_STATUS_UKN_0x80       0x80
+
+// Commands
+enum {
+  SmcCmdReadValue          = 0x10,
+  SmcCmdWriteValue         = 0x11,
+  SmcCmdGetKeyFromIndex    = 0x12,
+  SmcCmdGetKeyInfo         = 0x13,
+  SmcCmdReset              = 0x14,
+  SmcCmdFlashWrite         = 0x15,
+  SmcCmdFlashAuth          = 0x16,
+  SmcCmdFlashType          = 0x17,
+  SmcCmdFlashWriteMoreData = 0x18,
+  SmcCmdFlashAuthMoreData  = 0x19,
+  SmcCmdUnknown1           = 0x77
+};
+
+// Results
+enum {
+  SmcSuccess      = 0x00,
+  SmcNotFound     = 0x84,
+  SmcTimeoutError = 0xB7,
+  SmcInvalidSize  = 0xB8
+};
+
+#define SMC_ERROR(Result)  ((Result) != SmcSuccess)
+
+#define EFI_STATUS_FROM_SMC_RESULT(Result)                                  \
+  (SMC_ERROR (Result) ? ENCODE_ERROR ((UINTN)(Result)) : EFI_SUCCESS)
+
+#define EFI_SMC_TIMEOUT_ERROR  EFI_STATUS_FROM_SMC_RESULT (SmcTimeoutError)
+#define EFI_SMC_INVALID_SIZE   EFI_STATUS_FROM_SMC_RESULT (SmcInvalidSize)
+
+#endif // APPLE_SMC_H_
@@ -0,0 +1,151 @@
+#ifndef BASE_LIB_H_
+#define BASE_LIB_H_
+
+UINTN
+EFIAPI
+StrLen (
+  IN CONST CHAR16  *String
+  );
+
+UINTN
+EFIAPI
+StrSize (
+  IN CONST CHAR16  *String
+  );
+
+INTN
+EFIAPI
+StrCmp (
+  IN CONST CHAR16  *FirstString,
+  IN CONST CHAR16  *SecondString
+  );
+
+INTN
+EFIAPI
+StrnCmp (
+  IN CONST CHAR16  *FirstString,
+  IN CONST CHAR16  *SecondString,
+  IN UINTN         Length
+  );
+
+CHAR16 *
+EFIAPI
+StrCpy (
+  OUT CHAR16        *Destination,
+  IN  CONST CHAR16  *Source
+  );
+
+CHAR16 *
+EFIAPI
+StrnCpy (
+  OUT CHAR16        *Destination,
+  IN  CONST CHAR16  *Source,
+  IN  UINTN         Length
+  );
+
+CHAR16 *
+EFIAPI
+StrCat (
+  IN OUT CHAR16        *Destination,
+  IN     CONST CHAR16  *Source
+  );
+
+CHAR16 *
+EFIAPI
+StrStr (
+  IN CONST CHAR16  *String,
+  IN CONST CHAR16  *SearchString
+  );
+
+UINTN
+EFIAPI
+AsciiStrLen (
+  IN CONST CHAR8  *String
+  );
+
+UINT16
+EFIAPI
+SwapBytes16 (
+  IN UINT16  Value
+  );
+
+UINT32
+EFIAPI
+SwapBytes32 (
+  IN UINT32  Value
+  );
+
+UINT64
+EFIAPI
+LShiftU64 (
+  IN UINT64  Operand,
+  IN UINTN   Count
+  );
+
+UINT64
+EFIAPI
+RShiftU64 (
+  IN UINT64  Operand,
+  IN UINTN   Count
+  );
+
+UINT64
+EFIAPI
+MultU64x32 (
+  IN UINT64  Multiplicand,
+  IN UINT32  Multiplier
+  );
+
+UINT64
+EFIAPI
+DivU64x32 (
+  IN UINT64  Dividend,
+  IN UINT32  Divisor
+  );
+
+UINT64
+EFIAPI
+DivU64x64Remainder (
+  IN  UINT64  Dividend,
+  IN  UINT64  Divisor,
+  OUT UINT64  *Remainder OPTIONAL
+  );
+
+INTN
+EFIAPI
+HighBitSet32 (
+  IN UINT32  Operand
+  );
+
+INTN
+EFIAPI
+HighBitSet64 (
+  IN UINT64  Operand
+  );
+
+UINT32
+EFIAPI
+ReadUnaligned32 (
+  IN CONST UINT32  *Buffer
+  );
+
+UINT32
+EFIAPI
+WriteUnaligned32 (
+  OUT UINT32  *Buffer,
+  IN  UINT32  Value
+  );
+
+VOID
+EFIAPI
+CpuPause (
+  VOID
+  );
+
+VOID
+EFIAPI
+CpuDeadLoop (
+  VOID
+  );
+
+#endif // BASE_LIB_H_
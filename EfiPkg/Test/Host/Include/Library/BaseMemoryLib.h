@@ -0,0 +1,55 @@
+#ifndef BASE_MEMORY_LIB_H_
+#define BASE_MEMORY_LIB_H_
+
+VOID *
+EFIAPI
+CopyMem (
+  OUT VOID       *DestinationBuffer,
+  IN  CONST VOID *SourceBuffer,
+  IN  UINTN      Length
+  );
+
+VOID *
+EFIAPI
+SetMem (
+  OUT VOID   *Buffer,
+  IN  UINTN  Length,
+  IN  UINT8  Value
+  );
+
+VOID *
+EFIAPI
+ZeroMem (
+  OUT VOID   *Buffer,
+  IN  UINTN  Length
+  );
+
+INTN
+EFIAPI
+CompareMem (
+  IN CONST VOID  *DestinationBuffer,
+  IN CONST VOID  *SourceBuffer,
+  IN UINTN       Length
+  );
+
+BOOLEAN
+EFIAPI
+CompareGuid (
+  IN CONST GUID  *Guid1,
+  IN CONST GUID  *Guid2
+  );
+
+GUID *
+EFIAPI
+CopyGuid (
+  OUT GUID        *DestinationGuid,
+  IN  CONST GUID  *SourceGuid
+  );
+
+BOOLEAN
+EFIAPI
+IsZeroGuid (
+  IN CONST GUID  *Guid
+  );
+
+#endif // BASE_MEMORY_LIB_H_
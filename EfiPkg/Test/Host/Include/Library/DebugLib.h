@@ -0,0 +1,15 @@
+#ifndef DEBUG_LIB_H_
+#define DEBUG_LIB_H_
+
+VOID
+EFIAPI
+DebugPrint (
+  IN UINTN        ErrorLevel,
+  IN CONST CHAR8  *Format,
+  ...
+  );
+
+#undef DEBUG
+#define DEBUG(Expression)  DebugPrint Expression
+
+#endif // DEBUG_LIB_H_
@@ -0,0 +1,105 @@
+#ifndef DEVICE_PATH_LIB_H_
+#define DEVICE_PATH_LIB_H_
+
+UINT8
+EFIAPI
+DevicePathType (
+  IN CONST VOID  *Node
+  );
+
+UINT8
+EFIAPI
+DevicePathSubType (
+  IN CONST VOID  *Node
+  );
+
+UINTN
+EFIAPI
+DevicePathNodeLength (
+  IN CONST VOID  *Node
+  );
+
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+NextDevicePathNode (
+  IN CONST VOID  *Node
+  );
+
+BOOLEAN
+EFIAPI
+IsDevicePathEndType (
+  IN CONST VOID  *Node
+  );
+
+BOOLEAN
+EFIAPI
+IsDevicePathEnd (
+  IN CONST VOID  *Node
+  );
+
+BOOLEAN
+EFIAPI
+IsDevicePathEndInstance (
+  IN CONST VOID  *Node
+  );
+
+UINT16
+EFIAPI
+SetDevicePathNodeLength (
+  IN OUT VOID   *Node,
+  IN     UINTN  Length
+  );
+
+VOID
+EFIAPI
+SetDevicePathEndNode (
+  OUT VOID  *Node
+  );
+
+UINTN
+EFIAPI
+GetDevicePathSize (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  );
+
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+DuplicateDevicePath (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  );
+
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+AppendDevicePath (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *FirstDevicePath OPTIONAL,
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *SecondDevicePath OPTIONAL
+  );
+
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+AppendDevicePathInstance (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath OPTIONAL,
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePathInstance OPTIONAL
+  );
+
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+GetNextDevicePathInstance (
+  IN OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath,
+  OUT    UINTN                     *Size
+  );
+
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+DevicePathFromHandle (
+  IN EFI_HANDLE  Handle
+  );
+
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+FileDevicePath (
+  IN EFI_HANDLE    Device OPTIONAL,
+  IN CONST CHAR16  *FileName
+  );
+
+#endif // DEVICE_PATH_LIB_H_
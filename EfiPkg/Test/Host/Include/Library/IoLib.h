@@ -0,0 +1,43 @@
+#ifndef IO_LIB_H_
+#define IO_LIB_H_
+
+UINT8
+EFIAPI
+MmioRead8 (
+  IN UINTN  Address
+  );
+
+UINT16
+EFIAPI
+MmioRead16 (
+  IN UINTN  Address
+  );
+
+UINT32
+EFIAPI
+MmioRead32 (
+  IN UINTN  Address
+  );
+
+UINT8
+EFIAPI
+MmioWrite8 (
+  IN UINTN  Address,
+  IN UINT8  Value
+  );
+
+UINT16
+EFIAPI
+MmioWrite16 (
+  IN UINTN   Address,
+  IN UINT16  Value
+  );
+
+UINT32
+EFIAPI
+MmioWrite32 (
+  IN UINTN   Address,
+  IN UINT32  Value
+  );
+
+#endif // IO_LIB_H_
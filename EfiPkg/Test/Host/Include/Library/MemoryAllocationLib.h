@@ -0,0 +1,49 @@
+#ifndef MEMORY_ALLOCATION_LIB_H_
+#define MEMORY_ALLOCATION_LIB_H_
+
+VOID *
+EFIAPI
+AllocatePool (
+  IN UINTN  AllocationSize
+  );
+
+VOID *
+EFIAPI
+AllocateZeroPool (
+  IN UINTN  AllocationSize
+  );
+
+VOID *
+EFIAPI
+AllocateCopyPool (
+  IN UINTN       AllocationSize,
+  IN CONST VOID  *Buffer
+  );
+
+VOID *
+EFIAPI
+ReallocatePool (
+  IN UINTN  OldSize,
+  IN UINTN  NewSize,
+  IN VOID   *OldBuffer OPTIONAL
+  );
+
+VOID *
+EFIAPI
+AllocateRuntimePool (
+  IN UINTN  AllocationSize
+  );
+
+VOID *
+EFIAPI
+AllocateRuntimeZeroPool (
+  IN UINTN  AllocationSize
+  );
+
+VOID
+EFIAPI
+FreePool (
+  IN VOID  *Buffer
+  );
+
+#endif // MEMORY_ALLOCATION_LIB_H_
@@ -0,0 +1,35 @@
+#ifndef TIMER_LIB_H_
+#define TIMER_LIB_H_
+
+UINTN
+EFIAPI
+MicroSecondDelay (
+  IN UINTN  MicroSeconds
+  );
+
+UINTN
+EFIAPI
+NanoSecondDelay (
+  IN UINTN  NanoSeconds
+  );
+
+UINT64
+EFIAPI
+GetPerformanceCounter (
+  VOID
+  );
+
+UINT64
+EFIAPI
+GetPerformanceCounterProperties (
+  OUT UINT64  *StartValue OPTIONAL,
+  OUT UINT64  *EndValue OPTIONAL
+  );
+
+UINT64
+EFIAPI
+GetTimeInNanoSecond (
+  IN UINT64  Ticks
+  );
+
+#endif // TIMER_LIB_H_
@@ -0,0 +1,8 @@
+#ifndef UEFI_BOOT_SERVICES_TABLE_LIB_H_
+#define UEFI_BOOT_SERVICES_TABLE_LIB_H_
+
+extern EFI_HANDLE        gImageHandle;
+extern EFI_SYSTEM_TABLE  *gST;
+extern EFI_BOOT_SERVICES *gBS;
+
+#endif // UEFI_BOOT_SERVICES_TABLE_LIB_H_
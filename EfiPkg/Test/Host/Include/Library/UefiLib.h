@@ -0,0 +1,8 @@
+#ifndef UEFI_LIB_H_
+#define UEFI_LIB_H_
+
+//
+// The lock and event helpers are not used by the host builds.
+//
+
+#endif // UEFI_LIB_H_
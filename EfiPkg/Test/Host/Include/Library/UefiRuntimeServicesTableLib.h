@@ -0,0 +1,6 @@
+#ifndef UEFI_RUNTIME_SERVICES_TABLE_LIB_H_
+#define UEFI_RUNTIME_SERVICES_TABLE_LIB_H_
+
+extern EFI_RUNTIME_SERVICES *gRT;
+
+#endif // UEFI_RUNTIME_SERVICES_TABLE_LIB_H_
@@ -0,0 +1,55 @@
+#ifndef APPLE_BOOT_POLICY_H_
+#define APPLE_BOOT_POLICY_H_
+
+#include <Protocol/SimpleFileSystem.h>
+
+// APPLE_BOOT_POLICY_PROTOCOL_REVISION
+#define APPLE_BOOT_POLICY_PROTOCOL_REVISION  0x00000001
+
+// APPLE_BOOT_POLICY_PROTOCOL
+typedef struct {
+  UINTN Revision;
+
+  EFI_STATUS
+  (EFIAPI *GetBootFile)(
+    IN     EFI_HANDLE                Device,
+    IN OUT EFI_DEVICE_PATH_PROTOCOL  **FilePath
+    );
+
+  EFI_STATUS
+  (EFIAPI *GetBootFileEx)(
+    IN  EFI_HANDLE                Device,
+    IN  UINT32                    Mode,
+    OUT EFI_DEVICE_PATH_PROTOCOL  **FilePath
+    );
+
+  EFI_STATUS
+  (EFIAPI *GetBootInfo)(
+    IN  EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+    OUT CHAR16                    **BootPathName,
+    OUT EFI_HANDLE                *Device,
+    OUT EFI_HANDLE                *ApfsVolumeHandle
+    );
+
+  EFI_STATUS
+  (EFIAPI *GetPathNameOnApfsRecovery)(
+    IN  EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+    IN  CONST CHAR16              *PathName,
+    OUT CHAR16                    **FullPathName,
+    OUT VOID                      **Reserved,
+    OUT EFI_FILE_PROTOCOL         **Root,
+    OUT EFI_HANDLE                *DeviceHandle
+    );
+
+  EFI_STATUS
+  (EFIAPI *GetApfsRecoveryVolumes)(
+    IN  EFI_HANDLE  Handle,
+    OUT VOID        **Volumes,
+    OUT UINTN       *NumberOfEntries
+    );
+} APPLE_BOOT_POLICY_PROTOCOL;
+
+// gAppleBootPolicyProtocolGuid
+extern EFI_GUID gAppleBootPolicyProtocolGuid;
+
+#endif // APPLE_BOOT_POLICY_H_
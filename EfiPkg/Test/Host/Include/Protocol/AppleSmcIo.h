@@ -0,0 +1,29 @@
+#ifndef APPLE_SMC_IO_H_
+#define APPLE_SMC_IO_H_
+
+#include <IndustryStandard/AppleSmc.h>
+
+// APPLE_SMC_IO_PROTOCOL
+/// The SMC I/O services are not used on the host.
+typedef struct {
+  UINT64  Revision;
+  VOID    *SmcReadValue;
+  VOID    *SmcWriteValue;
+  VOID    *SmcGetKeyCount;
+  VOID    *SmcMakeKey;
+  VOID    *SmcGetKeyFromIndex;
+  VOID    *SmcGetKeyInfo;
+  VOID    *SmcReset;
+  VOID    *SmcFlashType;
+  VOID    *SmcUnsupported;
+  VOID    *SmcFlashWrite;
+  VOID    *SmcFlashAuth;
+  UINT32  Index;
+  UINT32  Address;
+  BOOLEAN Mmio;
+} APPLE_SMC_IO_PROTOCOL;
+
+// gAppleSmcIoProtocolGuid
+extern EFI_GUID gAppleSmcIoProtocolGuid;
+
+#endif // APPLE_SMC_IO_H_
@@ -0,0 +1,31 @@
+#ifndef BLOCK_IO_H_
+#define BLOCK_IO_H_
+
+// EFI_BLOCK_IO_MEDIA
+typedef struct {
+  UINT32  MediaId;
+  BOOLEAN RemovableMedia;
+  BOOLEAN MediaPresent;
+  BOOLEAN LogicalPartition;
+  BOOLEAN ReadOnly;
+  BOOLEAN WriteCaching;
+  UINT32  BlockSize;
+  UINT32  IoAlign;
+  UINT64  LastBlock;
+} EFI_BLOCK_IO_MEDIA;
+
+// EFI_BLOCK_IO_PROTOCOL
+/// The block services are not used on the host.
+typedef struct {
+  UINT64             Revision;
+  EFI_BLOCK_IO_MEDIA *Media;
+  VOID               *Reset;
+  VOID               *ReadBlocks;
+  VOID               *WriteBlocks;
+  VOID               *FlushBlocks;
+} EFI_BLOCK_IO_PROTOCOL;
+
+// gEfiBlockIoProtocolGuid
+extern EFI_GUID gEfiBlockIoProtocolGuid;
+
+#endif // BLOCK_IO_H_
@@ -0,0 +1,50 @@
+#ifndef DEVICE_PATH_H_
+#define DEVICE_PATH_H_
+
+// EFI_DEVICE_PATH_PROTOCOL
+typedef struct {
+  UINT8 Type;
+  UINT8 SubType;
+  UINT8 Length[2];
+} EFI_DEVICE_PATH_PROTOCOL;
+
+#define MEDIA_DEVICE_PATH                 0x04
+#define MEDIA_HARDDRIVE_DP                0x01
+#define MEDIA_VENDOR_DP                   0x03
+#define MEDIA_FILEPATH_DP                 0x04
+
+#define END_DEVICE_PATH_TYPE              0x7F
+#define END_ENTIRE_DEVICE_PATH_SUBTYPE    0xFF
+#define END_INSTANCE_DEVICE_PATH_SUBTYPE  0x01
+#define END_DEVICE_PATH_LENGTH            (sizeof (EFI_DEVICE_PATH_PROTOCOL))
+
+#define MBR_TYPE_EFI_PARTITION_TABLE_HEADER  0x02
+#define SIGNATURE_TYPE_GUID                  0x02
+
+#pragma pack(1)
+
+// HARDDRIVE_DEVICE_PATH
+typedef struct {
+  EFI_DEVICE_PATH_PROTOCOL Header;
+  UINT32                   PartitionNumber;
+  UINT64                   PartitionStart;
+  UINT64                   PartitionSize;
+  UINT8                    Signature[16];
+  UINT8                    MBRType;
+  UINT8                    SignatureType;
+} HARDDRIVE_DEVICE_PATH;
+
+// FILEPATH_DEVICE_PATH
+typedef struct {
+  EFI_DEVICE_PATH_PROTOCOL Header;
+  CHAR16                   PathName[1];
+} FILEPATH_DEVICE_PATH;
+
+#pragma pack()
+
+#define SIZE_OF_FILEPATH_DEVICE_PATH  OFFSET_OF (FILEPATH_DEVICE_PATH, PathName)
+
+// gEfiDevicePathProtocolGuid
+extern EFI_GUID gEfiDevicePathProtocolGuid;
+
+#endif // DEVICE_PATH_H_
@@ -0,0 +1,141 @@
+#ifndef SIMPLE_FILE_SYSTEM_H_
+#define SIMPLE_FILE_SYSTEM_H_
+
+typedef struct _EFI_FILE_PROTOCOL EFI_FILE_PROTOCOL;
+typedef EFI_FILE_PROTOCOL         *EFI_FILE_HANDLE;
+
+typedef struct _EFI_SIMPLE_FILE_SYSTEM_PROTOCOL EFI_SIMPLE_FILE_SYSTEM_PROTOCOL;
+
+#define EFI_SIMPLE_FILE_SYSTEM_PROTOCOL_REVISION  0x00010000
+#define EFI_FILE_PROTOCOL_REVISION                0x00010000
+#define EFI_FILE_PROTOCOL_REVISION2               0x00020000
+
+#define EFI_FILE_MODE_READ    0x0000000000000001ULL
+#define EFI_FILE_MODE_WRITE   0x0000000000000002ULL
+#define EFI_FILE_MODE_CREATE  0x8000000000000000ULL
+
+#define EFI_FILE_READ_ONLY  0x0000000000000001ULL
+#define EFI_FILE_DIRECTORY  0x0000000000000010ULL
+
+// EFI_FILE_IO_TOKEN
+typedef struct {
+  EFI_EVENT  Event;
+  EFI_STATUS Status;
+  UINTN      BufferSize;
+  VOID       *Buffer;
+} EFI_FILE_IO_TOKEN;
+
+// EFI_FILE_PROTOCOL
+struct _EFI_FILE_PROTOCOL {
+  UINT64 Revision;
+
+  EFI_STATUS
+  (EFIAPI *Open)(
+    IN  EFI_FILE_PROTOCOL  *This,
+    OUT EFI_FILE_PROTOCOL  **NewHandle,
+    IN  CHAR16             *FileName,
+    IN  UINT64             OpenMode,
+    IN  UINT64             Attributes
+    );
+
+  EFI_STATUS
+  (EFIAPI *Close)(
+    IN EFI_FILE_PROTOCOL  *This
+    );
+
+  EFI_STATUS
+  (EFIAPI *Delete)(
+    IN EFI_FILE_PROTOCOL  *This
+    );
+
+  EFI_STATUS
+  (EFIAPI *Read)(
+    IN     EFI_FILE_PROTOCOL  *This,
+    IN OUT UINTN              *BufferSize,
+    OUT    VOID               *Buffer
+    );
+
+  EFI_STATUS
+  (EFIAPI *Write)(
+    IN     EFI_FILE_PROTOCOL  *This,
+    IN OUT UINTN              *BufferSize,
+    IN     VOID               *Buffer
+    );
+
+  EFI_STATUS
+  (EFIAPI *GetPosition)(
+    IN  EFI_FILE_PROTOCOL  *This,
+    OUT UINT64             *Position
+    );
+
+  EFI_STATUS
+  (EFIAPI *SetPosition)(
+    IN EFI_FILE_PROTOCOL  *This,
+    IN UINT64             Position
+    );
+
+  EFI_STATUS
+  (EFIAPI *GetInfo)(
+    IN     EFI_FILE_PROTOCOL  *This,
+    IN     EFI_GUID           *InformationType,
+    IN OUT UINTN              *BufferSize,
+    OUT    VOID               *Buffer
+    );
+
+  EFI_STATUS
+  (EFIAPI *SetInfo)(
+    IN EFI_FILE_PROTOCOL  *This,
+    IN EFI_GUID           *InformationType,
+    IN UINTN              BufferSize,
+    IN VOID               *Buffer
+    );
+
+  EFI_STATUS
+  (EFIAPI *Flush)(
+    IN EFI_FILE_PROTOCOL  *This
+    );
+
+  EFI_STATUS
+  (EFIAPI *OpenEx)(
+    IN     EFI_FILE_PROTOCOL  *This,
+    OUT    EFI_FILE_PROTOCOL  **NewHandle,
+    IN     CHAR16             *FileName,
+    IN     UINT64             OpenMode,
+    IN     UINT64             Attributes,
+    IN OUT EFI_FILE_IO_TOKEN  *Token
+    );
+
+  EFI_STATUS
+  (EFIAPI *ReadEx)(
+    IN     EFI_FILE_PROTOCOL  *This,
+    IN OUT EFI_FILE_IO_TOKEN  *Token
+    );
+
+  EFI_STATUS
+  (EFIAPI *WriteEx)(
+    IN     EFI_FILE_PROTOCOL  *This,
+    IN OUT EFI_FILE_IO_TOKEN  *Token
+    );
+
+  EFI_STATUS
+  (EFIAPI *FlushEx)(
+    IN     EFI_FILE_PROTOCOL  *This,
+    IN OUT EFI_FILE_IO_TOKEN  *Token
+    );
+};
+
+// EFI_SIMPLE_FILE_SYSTEM_PROTOCOL
+struct _EFI_SIMPLE_FILE_SYSTEM_PROTOCOL {
+  UINT64 Revision;
+
+  EFI_STATUS
+  (EFIAPI *OpenVolume)(
+    IN  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL  *This,
+    OUT EFI_FILE_PROTOCOL                **Root
+    );
+};
+
+// gEfiSimpleFileSystemProtocolGuid
+extern EFI_GUID gEfiSimpleFileSystemProtocolGuid;
+
+#endif // SIMPLE_FILE_SYSTEM_H_
@@ -0,0 +1,316 @@
+#include <AppleMacEfi.h>
+
+#include <Library/BaseLib.h>
+
+// StrLen
+UINTN
+EFIAPI
+StrLen (
+  IN CONST CHAR16  *String
+  )
+{
+  UINTN Length;
+
+  for (Length = 0; String[Length] != L'\0'; ++Length) {
+    ;
+  }
+
+  return Length;
+}
+
+// StrSize
+UINTN
+EFIAPI
+StrSize (
+  IN CONST CHAR16  *String
+  )
+{
+  return ((StrLen (String) + 1) * sizeof (*String));
+}
+
+// StrCmp
+INTN
+EFIAPI
+StrCmp (
+  IN CONST CHAR16  *FirstString,
+  IN CONST CHAR16  *SecondString
+  )
+{
+  while ((*FirstString != L'\0') && (*FirstString == *SecondString)) {
+    ++FirstString;
+    ++SecondString;
+  }
+
+  return (*FirstString - *SecondString);
+}
+
+// StrnCmp
+INTN
+EFIAPI
+StrnCmp (
+  IN CONST CHAR16  *FirstString,
+  IN CONST CHAR16  *SecondString,
+  IN UINTN         Length
+  )
+{
+  if (Length == 0) {
+    return 0;
+  }
+
+  while ((*FirstString != L'\0')
+      && (*FirstString == *SecondString)
+      && (Length > 1)) {
+    ++FirstString;
+    ++SecondString;
+    --Length;
+  }
+
+  return (*FirstString - *SecondString);
+}
+
+// StrCpy
+CHAR16 *
+EFIAPI
+StrCpy (
+  OUT CHAR16        *Destination,
+  IN  CONST CHAR16  *Source
+  )
+{
+  CHAR16 *Result;
+
+  Result = Destination;
+
+  while (*Source != L'\0') {
+    *(Destination++) = *(Source++);
+  }
+
+  *Destination = L'\0';
+
+  return Result;
+}
+
+// StrnCpy
+/// Copies at most Length characters and always terminates the destination,
+/// as done by the MdePkg implementation.
+CHAR16 *
+EFIAPI
+StrnCpy (
+  OUT CHAR16        *Destination,
+  IN  CONST CHAR16  *Source,
+  IN  UINTN         Length
+  )
+{
+  CHAR16 *Result;
+
+  Result = Destination;
+
+  while ((Length > 0) && (*Source != L'\0')) {
+    *(Destination++) = *(Source++);
+    --Length;
+  }
+
+  *Destination = L'\0';
+
+  return Result;
+}
+
+// StrCat
+CHAR16 *
+EFIAPI
+StrCat (
+  IN OUT CHAR16        *Destination,
+  IN     CONST CHAR16  *Source
+  )
+{
+  StrCpy (&Destination[StrLen (Destination)], Source);
+
+  return Destination;
+}
+
+// StrStr
+CHAR16 *
+EFIAPI
+StrStr (
+  IN CONST CHAR16  *String,
+  IN CONST CHAR16  *SearchString
+  )
+{
+  UINTN SearchLength;
+
+  SearchLength = StrLen (SearchString);
+
+  if (SearchLength == 0) {
+    return (CHAR16 *)String;
+  }
+
+  for (; *String != L'\0'; ++String) {
+    if (StrnCmp (String, SearchString, SearchLength) == 0) {
+      return (CHAR16 *)String;
+    }
+  }
+
+  return NULL;
+}
+
+// AsciiStrLen
+UINTN
+EFIAPI
+AsciiStrLen (
+  IN CONST CHAR8  *String
+  )
+{
+  UINTN Length;
+
+  for (Length = 0; String[Length] != '\0'; ++Length) {
+    ;
+  }
+
+  return Length;
+}
+
+// SwapBytes16
+UINT16
+EFIAPI
+SwapBytes16 (
+  IN UINT16  Value
+  )
+{
+  return __builtin_bswap16 (Value);
+}
+
+// SwapBytes32
+UINT32
+EFIAPI
+SwapBytes32 (
+  IN UINT32  Value
+  )
+{
+  return __builtin_bswap32 (Value);
+}
+
+// LShiftU64
+UINT64
+EFIAPI
+LShiftU64 (
+  IN UINT64  Operand,
+  IN UINTN   Count
+  )
+{
+  return (Operand << Count);
+}
+
+// RShiftU64
+UINT64
+EFIAPI
+RShiftU64 (
+  IN UINT64  Operand,
+  IN UINTN   Count
+  )
+{
+  return (Operand >> Count);
+}
+
+// MultU64x32
+UINT64
+EFIAPI
+MultU64x32 (
+  IN UINT64  Multiplicand,
+  IN UINT32  Multiplier
+  )
+{
+  return (Multiplicand * Multiplier);
+}
+
+// DivU64x32
+UINT64
+EFIAPI
+DivU64x32 (
+  IN UINT64  Dividend,
+  IN UINT32  Divisor
+  )
+{
+  return (Dividend / Divisor);
+}
+
+// DivU64x64Remainder
+UINT64
+EFIAPI
+DivU64x64Remainder (
+  IN  UINT64  Dividend,
+  IN  UINT64  Divisor,
+  OUT UINT64  *Remainder OPTIONAL
+  )
+{
+  if (Remainder != NULL) {
+    *Remainder = (Dividend % Divisor);
+  }
+
+  return (Dividend / Divisor);
+}
+
+// HighBitSet32
+INTN
+EFIAPI
+HighBitSet32 (
+  IN UINT32  Operand
+  )
+{
+  return ((Operand == 0) ? -1 : (31 - __builtin_clz (Operand)));
+}
+
+// HighBitSet64
+INTN
+EFIAPI
+HighBitSet64 (
+  IN UINT64  Operand
+  )
+{
+  return ((Operand == 0) ? -1 : (63 - __builtin_clzll (Operand)));
+}
+
+// ReadUnaligned32
+UINT32
+EFIAPI
+ReadUnaligned32 (
+  IN CONST UINT32  *Buffer
+  )
+{
+  UINT32 Value;
+
+  __builtin_memcpy (&Value, Buffer, sizeof (Value));
+
+  return Value;
+}
+
+// WriteUnaligned32
+UINT32
+EFIAPI
+WriteUnaligned32 (
+  OUT UINT32  *Buffer,
+  IN  UINT32  Value
+  )
+{
+  __builtin_memcpy (Buffer, &Value, sizeof (Value));
+
+  return Value;
+}
+
+// CpuPause
+VOID
+EFIAPI
+CpuPause (
+  VOID
+  )
+{
+}
+
+// CpuDeadLoop
+/// Traps instead of spinning, so that a stuck host run fails visibly.
+VOID
+EFIAPI
+CpuDeadLoop (
+  VOID
+  )
+{
+  __builtin_trap ();
+}
@@ -0,0 +1,86 @@
+#include <string.h>
+
+#include <AppleMacEfi.h>
+
+#include <Library/BaseMemoryLib.h>
+
+// CopyMem
+VOID *
+EFIAPI
+CopyMem (
+  OUT VOID       *DestinationBuffer,
+  IN  CONST VOID *SourceBuffer,
+  IN  UINTN      Length
+  )
+{
+  return memmove (DestinationBuffer, SourceBuffer, Length);
+}
+
+// SetMem
+VOID *
+EFIAPI
+SetMem (
+  OUT VOID   *Buffer,
+  IN  UINTN  Length,
+  IN  UINT8  Value
+  )
+{
+  return memset (Buffer, Value, Length);
+}
+
+// ZeroMem
+VOID *
+EFIAPI
+ZeroMem (
+  OUT VOID   *Buffer,
+  IN  UINTN  Length
+  )
+{
+  return memset (Buffer, 0, Length);
+}
+
+// CompareMem
+INTN
+EFIAPI
+CompareMem (
+  IN CONST VOID  *DestinationBuffer,
+  IN CONST VOID  *SourceBuffer,
+  IN UINTN       Length
+  )
+{
+  return memcmp (DestinationBuffer, SourceBuffer, Length);
+}
+
+// CompareGuid
+BOOLEAN
+EFIAPI
+CompareGuid (
+  IN CONST GUID  *Guid1,
+  IN CONST GUID  *Guid2
+  )
+{
+  return (BOOLEAN)(memcmp (Guid1, Guid2, sizeof (*Guid1)) == 0);
+}
+
+// CopyGuid
+GUID *
+EFIAPI
+CopyGuid (
+  OUT GUID        *DestinationGuid,
+  IN  CONST GUID  *SourceGuid
+  )
+{
+  return memcpy (DestinationGuid, SourceGuid, sizeof (*DestinationGuid));
+}
+
+// IsZeroGuid
+BOOLEAN
+EFIAPI
+IsZeroGuid (
+  IN CONST GUID  *Guid
+  )
+{
+  STATIC CONST GUID ZeroGuid;
+
+  return CompareGuid (Guid, &ZeroGuid);
+}
@@ -0,0 +1,131 @@
+#include <stdio.h>
+
+#include <AppleMacEfi.h>
+
+#include <Library/DebugLib.h>
+
+// DebugPrint
+/** Prints to stderr.  The EDK II conversions used by the drivers are
+    translated: %a for ASCII strings, %s for UCS-2 strings, %g for GUIDs, %r
+    for status codes and the l prefix for 64-bit integers.  Precision is not
+    supported.
+**/
+VOID
+EFIAPI
+DebugPrint (
+  IN UINTN        ErrorLevel,
+  IN CONST CHAR8  *Format,
+  ...
+  )
+{
+  VA_LIST      Marker;
+  CHAR8        Spec[16];
+  UINTN        SpecLength;
+  BOOLEAN      Long;
+  CONST CHAR16 *String;
+  CONST GUID   *Guid;
+  UINT64       Value;
+
+  VA_START (Marker, Format);
+
+  for (; *Format != '\0'; ++Format) {
+    if (*Format != '%') {
+      fputc (*Format, stderr);
+      continue;
+    }
+
+    ++Format;
+
+    Spec[0]    = '%';
+    SpecLength = 1;
+
+    while (((*Format == '-') || (*Format == '0')
+         || ((*Format >= '1') && (*Format <= '9')))
+        && (SpecLength < (sizeof (Spec) - 4))) {
+      Spec[SpecLength++] = *(Format++);
+    }
+
+    Long = FALSE;
+
+    if ((*Format == 'l') || (*Format == 'L')) {
+      Long = TRUE;
+      ++Format;
+    }
+
+    switch (*Format) {
+      case 'a':
+        Spec[SpecLength++] = 's';
+        Spec[SpecLength]   = '\0';
+        fprintf (stderr, Spec, VA_ARG (Marker, CONST CHAR8 *));
+        break;
+
+      case 's':
+        for (String = VA_ARG (Marker, CONST CHAR16 *); *String != 0; ++String) {
+          fputc ((*String < 0x80) ? (int)*String : '?', stderr);
+        }
+
+        break;
+
+      case 'g':
+        Guid = VA_ARG (Marker, CONST GUID *);
+        fprintf (
+          stderr,
+          "%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X",
+          Guid->Data1,
+          Guid->Data2,
+          Guid->Data3,
+          Guid->Data4[0],
+          Guid->Data4[1],
+          Guid->Data4[2],
+          Guid->Data4[3],
+          Guid->Data4[4],
+          Guid->Data4[5],
+          Guid->Data4[6],
+          Guid->Data4[7]
+          );
+        break;
+
+      case 'r':
+        fprintf (stderr, "Status 0x%llX", (unsigned long long)VA_ARG (Marker, EFI_STATUS));
+        break;
+
+      case 'p':
+        fprintf (stderr, "%p", VA_ARG (Marker, VOID *));
+        break;
+
+      case 'c':
+        fputc (VA_ARG (Marker, int), stderr);
+        break;
+
+      case 'd':
+      case 'u':
+      case 'x':
+      case 'X':
+        Spec[SpecLength++] = 'l';
+        Spec[SpecLength++] = 'l';
+        Spec[SpecLength++] = ((*Format == 'u') ? 'u' : *Format);
+        Spec[SpecLength]   = '\0';
+
+        if (*Format == 'd') {
+          Value = (Long ? (UINT64)VA_ARG (Marker, INT64)
+                        : (UINT64)(INT64)VA_ARG (Marker, INT32));
+        } else {
+          Value = (Long ? VA_ARG (Marker, UINT64)
+                        : (UINT64)VA_ARG (Marker, UINT32));
+        }
+
+        fprintf (stderr, Spec, Value);
+        break;
+
+      case '%':
+        fputc ('%', stderr);
+        break;
+
+      default:
+        --Format;
+        break;
+    }
+  }
+
+  VA_END (Marker);
+}
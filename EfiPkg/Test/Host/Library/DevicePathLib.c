@@ -0,0 +1,330 @@
+#include <AppleMacEfi.h>
+
+#include <Protocol/DevicePath.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+// DevicePathType
+UINT8
+EFIAPI
+DevicePathType (
+  IN CONST VOID  *Node
+  )
+{
+  return ((CONST EFI_DEVICE_PATH_PROTOCOL *)Node)->Type;
+}
+
+// DevicePathSubType
+UINT8
+EFIAPI
+DevicePathSubType (
+  IN CONST VOID  *Node
+  )
+{
+  return ((CONST EFI_DEVICE_PATH_PROTOCOL *)Node)->SubType;
+}
+
+// DevicePathNodeLength
+UINTN
+EFIAPI
+DevicePathNodeLength (
+  IN CONST VOID  *Node
+  )
+{
+  CONST EFI_DEVICE_PATH_PROTOCOL *DevicePath;
+
+  DevicePath = (CONST EFI_DEVICE_PATH_PROTOCOL *)Node;
+
+  return (DevicePath->Length[0] | ((UINTN)DevicePath->Length[1] << 8));
+}
+
+// NextDevicePathNode
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+NextDevicePathNode (
+  IN CONST VOID  *Node
+  )
+{
+  return (EFI_DEVICE_PATH_PROTOCOL *)(
+           (UINT8 *)Node + DevicePathNodeLength (Node)
+           );
+}
+
+// IsDevicePathEndType
+BOOLEAN
+EFIAPI
+IsDevicePathEndType (
+  IN CONST VOID  *Node
+  )
+{
+  return (BOOLEAN)(DevicePathType (Node) == END_DEVICE_PATH_TYPE);
+}
+
+// IsDevicePathEnd
+BOOLEAN
+EFIAPI
+IsDevicePathEnd (
+  IN CONST VOID  *Node
+  )
+{
+  return (BOOLEAN)(IsDevicePathEndType (Node)
+                && (DevicePathSubType (Node) == END_ENTIRE_DEVICE_PATH_SUBTYPE));
+}
+
+// IsDevicePathEndInstance
+BOOLEAN
+EFIAPI
+IsDevicePathEndInstance (
+  IN CONST VOID  *Node
+  )
+{
+  return (BOOLEAN)(IsDevicePathEndType (Node)
+                && (DevicePathSubType (Node) == END_INSTANCE_DEVICE_PATH_SUBTYPE));
+}
+
+// SetDevicePathNodeLength
+UINT16
+EFIAPI
+SetDevicePathNodeLength (
+  IN OUT VOID   *Node,
+  IN     UINTN  Length
+  )
+{
+  EFI_DEVICE_PATH_PROTOCOL *DevicePath;
+
+  DevicePath = (EFI_DEVICE_PATH_PROTOCOL *)Node;
+
+  DevicePath->Length[0] = (UINT8)Length;
+  DevicePath->Length[1] = (UINT8)(Length >> 8);
+
+  return (UINT16)Length;
+}
+
+// SetDevicePathEndNode
+VOID
+EFIAPI
+SetDevicePathEndNode (
+  OUT VOID  *Node
+  )
+{
+  EFI_DEVICE_PATH_PROTOCOL *DevicePath;
+
+  DevicePath = (EFI_DEVICE_PATH_PROTOCOL *)Node;
+
+  DevicePath->Type    = END_DEVICE_PATH_TYPE;
+  DevicePath->SubType = END_ENTIRE_DEVICE_PATH_SUBTYPE;
+
+  SetDevicePathNodeLength (DevicePath, END_DEVICE_PATH_LENGTH);
+}
+
+// GetDevicePathSize
+UINTN
+EFIAPI
+GetDevicePathSize (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  )
+{
+  CONST EFI_DEVICE_PATH_PROTOCOL *Node;
+
+  if (DevicePath == NULL) {
+    return 0;
+  }
+
+  for (Node = DevicePath; !IsDevicePathEnd (Node); ) {
+    Node = NextDevicePathNode (Node);
+  }
+
+  return (((UINTN)Node - (UINTN)DevicePath) + DevicePathNodeLength (Node));
+}
+
+// DuplicateDevicePath
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+DuplicateDevicePath (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  )
+{
+  if (DevicePath == NULL) {
+    return NULL;
+  }
+
+  return AllocateCopyPool (GetDevicePathSize (DevicePath), DevicePath);
+}
+
+// AppendDevicePath
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+AppendDevicePath (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *FirstDevicePath OPTIONAL,
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *SecondDevicePath OPTIONAL
+  )
+{
+  UINTN                    Size1;
+  UINTN                    Size2;
+  EFI_DEVICE_PATH_PROTOCOL *NewDevicePath;
+
+  if (FirstDevicePath == NULL) {
+    return DuplicateDevicePath (SecondDevicePath);
+  }
+
+  if (SecondDevicePath == NULL) {
+    return DuplicateDevicePath (FirstDevicePath);
+  }
+
+  Size1 = (GetDevicePathSize (FirstDevicePath) - END_DEVICE_PATH_LENGTH);
+  Size2 = GetDevicePathSize (SecondDevicePath);
+
+  NewDevicePath = AllocatePool (Size1 + Size2);
+
+  if (NewDevicePath != NULL) {
+    CopyMem (NewDevicePath, FirstDevicePath, Size1);
+    CopyMem ((UINT8 *)NewDevicePath + Size1, SecondDevicePath, Size2);
+  }
+
+  return NewDevicePath;
+}
+
+// AppendDevicePathInstance
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+AppendDevicePathInstance (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath OPTIONAL,
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePathInstance OPTIONAL
+  )
+{
+  UINTN                    Size1;
+  UINTN                    Size2;
+  EFI_DEVICE_PATH_PROTOCOL *NewDevicePath;
+  EFI_DEVICE_PATH_PROTOCOL *End;
+
+  if (DevicePath == NULL) {
+    return DuplicateDevicePath (DevicePathInstance);
+  }
+
+  if (DevicePathInstance == NULL) {
+    return NULL;
+  }
+
+  Size1 = GetDevicePathSize (DevicePath);
+  Size2 = GetDevicePathSize (DevicePathInstance);
+
+  NewDevicePath = AllocatePool (Size1 + Size2);
+
+  if (NewDevicePath != NULL) {
+    CopyMem (NewDevicePath, DevicePath, Size1);
+
+    End          = (EFI_DEVICE_PATH_PROTOCOL *)(
+                     (UINT8 *)NewDevicePath + Size1 - END_DEVICE_PATH_LENGTH
+                     );
+    End->SubType = END_INSTANCE_DEVICE_PATH_SUBTYPE;
+
+    CopyMem ((UINT8 *)NewDevicePath + Size1, DevicePathInstance, Size2);
+  }
+
+  return NewDevicePath;
+}
+
+// GetNextDevicePathInstance
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+GetNextDevicePathInstance (
+  IN OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath,
+  OUT    UINTN                     *Size
+  )
+{
+  EFI_DEVICE_PATH_PROTOCOL *Node;
+  EFI_DEVICE_PATH_PROTOCOL *Instance;
+  UINT8                    SubType;
+
+  if (*DevicePath == NULL) {
+    *Size = 0;
+
+    return NULL;
+  }
+
+  for (Node = *DevicePath; !IsDevicePathEndType (Node); ) {
+    Node = NextDevicePathNode (Node);
+  }
+
+  *Size = (((UINTN)Node - (UINTN)*DevicePath) + END_DEVICE_PATH_LENGTH);
+
+  Instance = AllocateCopyPool (*Size, *DevicePath);
+
+  if (Instance != NULL) {
+    SetDevicePathEndNode ((UINT8 *)Instance + *Size - END_DEVICE_PATH_LENGTH);
+  }
+
+  SubType = DevicePathSubType (Node);
+
+  *DevicePath = ((SubType == END_ENTIRE_DEVICE_PATH_SUBTYPE)
+                   ? NULL
+                   : NextDevicePathNode (Node));
+
+  return Instance;
+}
+
+// DevicePathFromHandle
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+DevicePathFromHandle (
+  IN EFI_HANDLE  Handle
+  )
+{
+  EFI_STATUS               Status;
+  EFI_DEVICE_PATH_PROTOCOL *DevicePath;
+
+  Status = gBS->HandleProtocol (
+                  Handle,
+                  &gEfiDevicePathProtocolGuid,
+                  (VOID **)&DevicePath
+                  );
+
+  return (EFI_ERROR (Status) ? NULL : DevicePath);
+}
+
+// FileDevicePath
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+FileDevicePath (
+  IN EFI_HANDLE    Device OPTIONAL,
+  IN CONST CHAR16  *FileName
+  )
+{
+  UINTN                    Size;
+  FILEPATH_DEVICE_PATH     *FilePath;
+  EFI_DEVICE_PATH_PROTOCOL *DevicePath;
+
+  Size     = StrSize (FileName);
+  FilePath = AllocateZeroPool (
+               SIZE_OF_FILEPATH_DEVICE_PATH + Size + END_DEVICE_PATH_LENGTH
+               );
+
+  if (FilePath == NULL) {
+    return NULL;
+  }
+
+  FilePath->Header.Type    = MEDIA_DEVICE_PATH;
+  FilePath->Header.SubType = MEDIA_FILEPATH_DP;
+
+  SetDevicePathNodeLength (
+    &FilePath->Header,
+    SIZE_OF_FILEPATH_DEVICE_PATH + Size
+    );
+
+  CopyMem (&FilePath->PathName[0], FileName, Size);
+  SetDevicePathEndNode (NextDevicePathNode (&FilePath->Header));
+
+  DevicePath = &FilePath->Header;
+
+  if (Device != NULL) {
+    DevicePath = AppendDevicePath (DevicePathFromHandle (Device), DevicePath);
+
+    FreePool (FilePath);
+  }
+
+  return DevicePath;
+}
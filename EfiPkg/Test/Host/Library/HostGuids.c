@@ -0,0 +1,72 @@
+#include <AppleMacEfi.h>
+
+#include <Guid/AppleApfsInfo.h>
+#include <Guid/AppleBless.h>
+#include <Guid/AppleBootPolicyStatistics.h>
+#include <Guid/AppleBootPolicyTrace.h>
+#include <Guid/AppleBootPolicyVariable.h>
+#include <Guid/AppleSmcStatistics.h>
+#include <Guid/FileInfo.h>
+
+#include <Protocol/AppleBootPolicy.h>
+#include <Protocol/AppleBootPolicyEx.h>
+#include <Protocol/BlockIo.h>
+#include <Protocol/DevicePath.h>
+#include <Protocol/SimpleFileSystem.h>
+
+//
+// The GUID definitions the build tools generate from the package
+// declarations.  The Apple GUIDs not declared by the headers of this tree
+// only need to be distinct on the host.
+//
+
+EFI_GUID gEfiBlockIoProtocolGuid = {
+  0x964E5B21, 0x6459, 0x11D2,
+  { 0x8E, 0x39, 0x00, 0xA0, 0xC9, 0x69, 0x72, 0x3B }
+};
+
+EFI_GUID gEfiDevicePathProtocolGuid = {
+  0x09576E91, 0x6D3F, 0x11D2,
+  { 0x8E, 0x39, 0x00, 0xA0, 0xC9, 0x69, 0x72, 0x3B }
+};
+
+EFI_GUID gEfiFileInfoGuid = {
+  0x09576E92, 0x6D3F, 0x11D2,
+  { 0x8E, 0x39, 0x00, 0xA0, 0xC9, 0x69, 0x72, 0x3B }
+};
+
+EFI_GUID gEfiSimpleFileSystemProtocolGuid = {
+  0x964E5B22, 0x6459, 0x11D2,
+  { 0x8E, 0x39, 0x00, 0xA0, 0xC9, 0x69, 0x72, 0x3B }
+};
+
+EFI_GUID gAppleApfsContainerInfoGuid = {
+  0x3533CF0D, 0x685F, 0x5EBF,
+  { 0x8D, 0xC6, 0x73, 0x93, 0x48, 0x5B, 0xAF, 0xA2 }
+};
+
+EFI_GUID gAppleApfsVolumeInfoGuid = {
+  0x900C7693, 0x8C14, 0x58BA,
+  { 0xB4, 0x4E, 0x97, 0x45, 0x15, 0xD2, 0x7C, 0x78 }
+};
+
+EFI_GUID gAppleBlessedSystemFileInfoGuid = {
+  0xBBA0DB1F, 0x2AF8, 0x4A4B,
+  { 0x80, 0x3A, 0x53, 0x0C, 0x3A, 0x4D, 0x6B, 0x2E }
+};
+
+EFI_GUID gAppleBlessedSystemFolderInfoGuid = {
+  0xBBA0DB20, 0x2AF8, 0x4A4B,
+  { 0x80, 0x3A, 0x53, 0x0C, 0x3A, 0x4D, 0x6B, 0x2E }
+};
+
+EFI_GUID gAppleBootPolicyProtocolGuid = {
+  0x62257758, 0x350C, 0x4D0A,
+  { 0xB0, 0xBD, 0xF6, 0xBE, 0x2E, 0x1E, 0x27, 0x2C }
+};
+
+EFI_GUID gAppleBootPolicyExProtocolGuid = APPLE_BOOT_POLICY_EX_PROTOCOL_GUID;
+EFI_GUID gAppleBootPolicyStatisticsGuid = APPLE_BOOT_POLICY_STATISTICS_GUID;
+EFI_GUID gAppleBootPolicyTraceGuid      = APPLE_BOOT_POLICY_TRACE_GUID;
+EFI_GUID gAppleBootPolicyVariableGuid   = APPLE_BOOT_POLICY_VARIABLE_GUID;
+EFI_GUID gAppleSmcStatisticsGuid        = APPLE_SMC_STATISTICS_GUID;
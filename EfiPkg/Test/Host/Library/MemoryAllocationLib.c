@@ -0,0 +1,96 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <AppleMacEfi.h>
+
+#include <Library/MemoryAllocationLib.h>
+
+// AllocatePool
+VOID *
+EFIAPI
+AllocatePool (
+  IN UINTN  AllocationSize
+  )
+{
+  return malloc (AllocationSize);
+}
+
+// AllocateZeroPool
+VOID *
+EFIAPI
+AllocateZeroPool (
+  IN UINTN  AllocationSize
+  )
+{
+  return calloc (1, AllocationSize);
+}
+
+// AllocateCopyPool
+VOID *
+EFIAPI
+AllocateCopyPool (
+  IN UINTN       AllocationSize,
+  IN CONST VOID  *Buffer
+  )
+{
+  VOID *Memory;
+
+  Memory = malloc (AllocationSize);
+
+  if (Memory != NULL) {
+    memcpy (Memory, Buffer, AllocationSize);
+  }
+
+  return Memory;
+}
+
+// ReallocatePool
+VOID *
+EFIAPI
+ReallocatePool (
+  IN UINTN  OldSize,
+  IN UINTN  NewSize,
+  IN VOID   *OldBuffer OPTIONAL
+  )
+{
+  VOID *NewBuffer;
+
+  NewBuffer = calloc (1, NewSize);
+
+  if ((NewBuffer != NULL) && (OldBuffer != NULL)) {
+    memcpy (NewBuffer, OldBuffer, MIN (OldSize, NewSize));
+    free (OldBuffer);
+  }
+
+  return NewBuffer;
+}
+
+// AllocateRuntimePool
+VOID *
+EFIAPI
+AllocateRuntimePool (
+  IN UINTN  AllocationSize
+  )
+{
+  return malloc (AllocationSize);
+}
+
+// AllocateRuntimeZeroPool
+VOID *
+EFIAPI
+AllocateRuntimeZeroPool (
+  IN UINTN  AllocationSize
+  )
+{
+  return calloc (1, AllocationSize);
+}
+
+// FreePool
+VOID
+EFIAPI
+FreePool (
+  IN VOID  *Buffer
+  )
+{
+  free (Buffer);
+}
@@ -0,0 +1,84 @@
+#include <time.h>
+
+#include <AppleMacEfi.h>
+
+#include <Library/TimerLib.h>
+
+//
+// The performance counter counts nanoseconds of CLOCK_MONOTONIC.
+//
+
+// MicroSecondDelay
+UINTN
+EFIAPI
+MicroSecondDelay (
+  IN UINTN  MicroSeconds
+  )
+{
+  NanoSecondDelay (MicroSeconds * 1000);
+
+  return MicroSeconds;
+}
+
+// NanoSecondDelay
+/// Spins rather than sleeps, so that short delays are not rounded up to the
+/// scheduler granularity.
+UINTN
+EFIAPI
+NanoSecondDelay (
+  IN UINTN  NanoSeconds
+  )
+{
+  UINT64 End;
+
+  End = (GetPerformanceCounter () + NanoSeconds);
+
+  while (GetPerformanceCounter () < End) {
+    ;
+  }
+
+  return NanoSeconds;
+}
+
+// GetPerformanceCounter
+UINT64
+EFIAPI
+GetPerformanceCounter (
+  VOID
+  )
+{
+  struct timespec Time;
+
+  clock_gettime (CLOCK_MONOTONIC, &Time);
+
+  return (((UINT64)Time.tv_sec * 1000000000ULL) + (UINT64)Time.tv_nsec);
+}
+
+// GetPerformanceCounterProperties
+UINT64
+EFIAPI
+GetPerformanceCounterProperties (
+  OUT UINT64  *StartValue OPTIONAL,
+  OUT UINT64  *EndValue OPTIONAL
+  )
+{
+  if (StartValue != NULL) {
+    *StartValue = 0;
+  }
+
+  if (EndValue != NULL) {
+    *EndValue = MAX_UINT64;
+  }
+
+  return 1000000000ULL;
+}
+
+// GetTimeInNanoSecond
+UINT64
+EFIAPI
+GetTimeInNanoSecond (
+  IN UINT64  Ticks
+  )
+{
+  return Ticks;
+}
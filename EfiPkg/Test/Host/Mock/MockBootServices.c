@@ -0,0 +1,848 @@
+#include <AppleMacEfi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+
+#include "MockUefi.h"
+
+// MOCK_MAX_HANDLES
+#define MOCK_MAX_HANDLES  1024
+
+// MOCK_MAX_PROTOCOLS
+/// The number of protocols a handle carries.
+#define MOCK_MAX_PROTOCOLS  8
+
+// MOCK_MAX_EVENTS
+#define MOCK_MAX_EVENTS  64
+
+// MOCK_MAX_TABLES
+#define MOCK_MAX_TABLES  16
+
+// MOCK_MAX_VARIABLES
+#define MOCK_MAX_VARIABLES  32
+
+// MOCK_PROTOCOL_INTERFACE
+typedef struct {
+  EFI_GUID Protocol;
+  VOID     *Interface;
+} MOCK_PROTOCOL_INTERFACE;
+
+// MOCK_HANDLE
+/// Handles are never freed, so that stale handles held by a driver are
+/// rejected rather than dereferenced.
+typedef struct {
+  UINTN                   NumberOfProtocols;
+  MOCK_PROTOCOL_INTERFACE Protocols[MOCK_MAX_PROTOCOLS];
+} MOCK_HANDLE;
+
+// MOCK_EVENT
+typedef struct {
+  BOOLEAN          Used;
+  UINT32           Type;
+  EFI_EVENT_NOTIFY NotifyFunction;
+  VOID             *NotifyContext;
+  BOOLEAN          Registered;
+  EFI_GUID         Protocol;
+} MOCK_EVENT;
+
+// MOCK_CONFIGURATION_TABLE
+typedef struct {
+  EFI_GUID Guid;
+  VOID     *Table;
+} MOCK_CONFIGURATION_TABLE;
+
+// MOCK_VARIABLE
+typedef struct {
+  CHAR16   *Name;
+  EFI_GUID VendorGuid;
+  UINT32   Attributes;
+  UINTN    DataSize;
+  VOID     *Data;
+} MOCK_VARIABLE;
+
+EFI_HANDLE           gImageHandle = NULL;
+EFI_SYSTEM_TABLE     *gST         = NULL;
+EFI_BOOT_SERVICES    *gBS         = NULL;
+EFI_RUNTIME_SERVICES *gRT         = NULL;
+
+// mHandles
+STATIC MOCK_HANDLE mHandles[MOCK_MAX_HANDLES];
+
+// mNumberOfHandles
+STATIC UINTN mNumberOfHandles = 0;
+
+// mEvents
+STATIC MOCK_EVENT mEvents[MOCK_MAX_EVENTS];
+
+// mTables
+STATIC MOCK_CONFIGURATION_TABLE mTables[MOCK_MAX_TABLES];
+
+// mVariables
+STATIC MOCK_VARIABLE mVariables[MOCK_MAX_VARIABLES];
+
+// mCurrentTpl
+STATIC EFI_TPL mCurrentTpl = TPL_APPLICATION;
+
+// mCounters
+STATIC MOCK_BOOT_SERVICES_COUNTERS mCounters;
+
+// InternalIsValidHandle
+STATIC
+BOOLEAN
+InternalIsValidHandle (
+  IN EFI_HANDLE  Handle
+  )
+{
+  return (BOOLEAN)(((MOCK_HANDLE *)Handle >= &mHandles[0])
+                && ((MOCK_HANDLE *)Handle < &mHandles[mNumberOfHandles])
+                && (((MOCK_HANDLE *)Handle)->NumberOfProtocols > 0));
+}
+
+// InternalFindProtocol
+STATIC
+MOCK_PROTOCOL_INTERFACE *
+InternalFindProtocol (
+  IN EFI_HANDLE      Handle,
+  IN CONST EFI_GUID  *Protocol
+  )
+{
+  MOCK_HANDLE *MockHandle;
+  UINTN       Index;
+
+  if (!InternalIsValidHandle (Handle)) {
+    return NULL;
+  }
+
+  MockHandle = (MOCK_HANDLE *)Handle;
+
+  for (Index = 0; Index < MockHandle->NumberOfProtocols; ++Index) {
+    if (CompareGuid (&MockHandle->Protocols[Index].Protocol, Protocol)) {
+      return &MockHandle->Protocols[Index];
+    }
+  }
+
+  return NULL;
+}
+
+// InternalNotifyProtocol
+/// Registered notifications are dispatched right away rather than at their
+/// TPL.
+STATIC
+VOID
+InternalNotifyProtocol (
+  IN CONST EFI_GUID  *Protocol
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < MOCK_MAX_EVENTS; ++Index) {
+    if (mEvents[Index].Used
+     && mEvents[Index].Registered
+     && CompareGuid (&mEvents[Index].Protocol, Protocol)
+     && (mEvents[Index].NotifyFunction != NULL)) {
+      mEvents[Index].NotifyFunction (
+                       (EFI_EVENT)&mEvents[Index],
+                       mEvents[Index].NotifyContext
+                       );
+    }
+  }
+}
+
+// MockRaiseTpl
+STATIC
+EFI_TPL
+EFIAPI
+MockRaiseTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  EFI_TPL OldTpl;
+
+  OldTpl      = mCurrentTpl;
+  mCurrentTpl = NewTpl;
+
+  return OldTpl;
+}
+
+// MockRestoreTpl
+STATIC
+VOID
+EFIAPI
+MockRestoreTpl (
+  IN EFI_TPL  OldTpl
+  )
+{
+  mCurrentTpl = OldTpl;
+}
+
+// MockCreateEvent
+STATIC
+EFI_STATUS
+EFIAPI
+MockCreateEvent (
+  IN  UINT32            Type,
+  IN  EFI_TPL           NotifyTpl,
+  IN  EFI_EVENT_NOTIFY  NotifyFunction,
+  IN  VOID              *NotifyContext,
+  OUT EFI_EVENT         *Event
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < MOCK_MAX_EVENTS; ++Index) {
+    if (!mEvents[Index].Used) {
+      ZeroMem (&mEvents[Index], sizeof (mEvents[Index]));
+
+      mEvents[Index].Used           = TRUE;
+      mEvents[Index].Type           = Type;
+      mEvents[Index].NotifyFunction = NotifyFunction;
+      mEvents[Index].NotifyContext  = NotifyContext;
+
+      *Event = (EFI_EVENT)&mEvents[Index];
+
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_OUT_OF_RESOURCES;
+}
+
+// MockSignalEvent
+STATIC
+EFI_STATUS
+EFIAPI
+MockSignalEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  MOCK_EVENT *MockEvent;
+
+  MockEvent = (MOCK_EVENT *)Event;
+
+  if (MockEvent->NotifyFunction != NULL) {
+    MockEvent->NotifyFunction (Event, MockEvent->NotifyContext);
+  }
+
+  return EFI_SUCCESS;
+}
+
+// MockCloseEvent
+STATIC
+EFI_STATUS
+EFIAPI
+MockCloseEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  ((MOCK_EVENT *)Event)->Used = FALSE;
+
+  return EFI_SUCCESS;
+}
+
+// MockInstallProtocolInterface
+STATIC
+EFI_STATUS
+EFIAPI
+MockInstallProtocolInterface (
+  IN OUT EFI_HANDLE          *Handle,
+  IN     EFI_GUID            *Protocol,
+  IN     EFI_INTERFACE_TYPE  InterfaceType,
+  IN     VOID                *Interface
+  )
+{
+  MOCK_HANDLE *MockHandle;
+
+  if (*Handle == NULL) {
+    if (mNumberOfHandles == MOCK_MAX_HANDLES) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    *Handle = (EFI_HANDLE)&mHandles[mNumberOfHandles++];
+  } else if (!InternalIsValidHandle (*Handle)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (InternalFindProtocol (*Handle, Protocol) != NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  MockHandle = (MOCK_HANDLE *)*Handle;
+
+  if (MockHandle->NumberOfProtocols == MOCK_MAX_PROTOCOLS) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CopyGuid (
+    &MockHandle->Protocols[MockHandle->NumberOfProtocols].Protocol,
+    Protocol
+    );
+
+  MockHandle->Protocols[MockHandle->NumberOfProtocols].Interface = Interface;
+  ++MockHandle->NumberOfProtocols;
+
+  InternalNotifyProtocol (Protocol);
+
+  return EFI_SUCCESS;
+}
+
+// MockReinstallProtocolInterface
+STATIC
+EFI_STATUS
+EFIAPI
+MockReinstallProtocolInterface (
+  IN EFI_HANDLE  Handle,
+  IN EFI_GUID    *Protocol,
+  IN VOID        *OldInterface,
+  IN VOID        *NewInterface
+  )
+{
+  MOCK_PROTOCOL_INTERFACE *Entry;
+
+  Entry = InternalFindProtocol (Handle, Protocol);
+
+  if ((Entry == NULL) || (Entry->Interface != OldInterface)) {
+    return EFI_NOT_FOUND;
+  }
+
+  Entry->Interface = NewInterface;
+
+  InternalNotifyProtocol (Protocol);
+
+  return EFI_SUCCESS;
+}
+
+// MockUninstallProtocolInterface
+STATIC
+EFI_STATUS
+EFIAPI
+MockUninstallProtocolInterface (
+  IN EFI_HANDLE  Handle,
+  IN EFI_GUID    *Protocol,
+  IN VOID        *Interface
+  )
+{
+  MOCK_HANDLE             *MockHandle;
+  MOCK_PROTOCOL_INTERFACE *Entry;
+  MOCK_PROTOCOL_INTERFACE *Last;
+
+  Entry = InternalFindProtocol (Handle, Protocol);
+
+  if ((Entry == NULL) || (Entry->Interface != Interface)) {
+    return EFI_NOT_FOUND;
+  }
+
+  MockHandle = (MOCK_HANDLE *)Handle;
+  Last       = &MockHandle->Protocols[MockHandle->NumberOfProtocols - 1];
+
+  CopyMem (Entry, Last, sizeof (*Entry));
+  --MockHandle->NumberOfProtocols;
+
+  return EFI_SUCCESS;
+}
+
+// MockHandleProtocol
+STATIC
+EFI_STATUS
+EFIAPI
+MockHandleProtocol (
+  IN  EFI_HANDLE  Handle,
+  IN  EFI_GUID    *Protocol,
+  OUT VOID        **Interface
+  )
+{
+  MOCK_PROTOCOL_INTERFACE *Entry;
+
+  ++mCounters.HandleProtocol;
+
+  if (!InternalIsValidHandle (Handle)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Entry = InternalFindProtocol (Handle, Protocol);
+
+  if (Entry == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  *Interface = Entry->Interface;
+
+  return EFI_SUCCESS;
+}
+
+// MockRegisterProtocolNotify
+STATIC
+EFI_STATUS
+EFIAPI
+MockRegisterProtocolNotify (
+  IN  EFI_GUID   *Protocol,
+  IN  EFI_EVENT  Event,
+  OUT VOID       **Registration
+  )
+{
+  MOCK_EVENT *MockEvent;
+
+  MockEvent = (MOCK_EVENT *)Event;
+
+  MockEvent->Registered = TRUE;
+  CopyGuid (&MockEvent->Protocol, Protocol);
+
+  *Registration = (VOID *)MockEvent;
+
+  return EFI_SUCCESS;
+}
+
+// MockLocateDevicePath
+/// Returns the handle carrying Protocol whose device path is the longest
+/// prefix of DevicePath.
+STATIC
+EFI_STATUS
+EFIAPI
+MockLocateDevicePath (
+  IN     EFI_GUID                  *Protocol,
+  IN OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath,
+  OUT    EFI_HANDLE                *Device
+  )
+{
+  UINTN                    Index;
+  MOCK_PROTOCOL_INTERFACE  *Entry;
+  EFI_DEVICE_PATH_PROTOCOL *HandlePath;
+  UINTN                    Size;
+  UINTN                    BestSize;
+
+  ++mCounters.LocateDevicePath;
+
+  *Device  = NULL;
+  BestSize = 0;
+
+  for (Index = 0; Index < mNumberOfHandles; ++Index) {
+    if (InternalFindProtocol (&mHandles[Index], Protocol) == NULL) {
+      continue;
+    }
+
+    Entry = InternalFindProtocol (&mHandles[Index], &gEfiDevicePathProtocolGuid);
+
+    if (Entry == NULL) {
+      continue;
+    }
+
+    HandlePath = (EFI_DEVICE_PATH_PROTOCOL *)Entry->Interface;
+    Size       = (GetDevicePathSize (HandlePath) - END_DEVICE_PATH_LENGTH);
+
+    if ((Size >= BestSize)
+     && (Size <= GetDevicePathSize (*DevicePath))
+     && (CompareMem (HandlePath, *DevicePath, Size) == 0)) {
+      *Device  = &mHandles[Index];
+      BestSize = Size;
+    }
+  }
+
+  if (*Device == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  *DevicePath = (EFI_DEVICE_PATH_PROTOCOL *)((UINT8 *)*DevicePath + BestSize);
+
+  return EFI_SUCCESS;
+}
+
+// MockInstallConfigurationTable
+STATIC
+EFI_STATUS
+EFIAPI
+MockInstallConfigurationTable (
+  IN EFI_GUID  *Guid,
+  IN VOID      *Table
+  )
+{
+  UINTN Index;
+  UINTN Free;
+
+  Free = MOCK_MAX_TABLES;
+
+  for (Index = 0; Index < MOCK_MAX_TABLES; ++Index) {
+    if (mTables[Index].Table == NULL) {
+      Free = MIN (Free, Index);
+    } else if (CompareGuid (&mTables[Index].Guid, Guid)) {
+      mTables[Index].Table = Table;
+
+      return EFI_SUCCESS;
+    }
+  }
+
+  if (Table == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (Free == MOCK_MAX_TABLES) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CopyGuid (&mTables[Free].Guid, Guid);
+  mTables[Free].Table = Table;
+
+  return EFI_SUCCESS;
+}
+
+// MockLocateHandleBuffer
+STATIC
+EFI_STATUS
+EFIAPI
+MockLocateHandleBuffer (
+  IN     EFI_LOCATE_SEARCH_TYPE  SearchType,
+  IN     EFI_GUID                *Protocol OPTIONAL,
+  IN     VOID                    *SearchKey OPTIONAL,
+  IN OUT UINTN                   *NoHandles,
+  OUT    EFI_HANDLE              **Buffer
+  )
+{
+  UINTN Index;
+
+  ++mCounters.LocateHandleBuffer;
+
+  if (SearchType == ByRegisterNotify) {
+    return EFI_UNSUPPORTED;
+  }
+
+  *NoHandles = 0;
+  *Buffer    = AllocatePool (mNumberOfHandles * sizeof (**Buffer));
+
+  if (*Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < mNumberOfHandles; ++Index) {
+    if ((mHandles[Index].NumberOfProtocols > 0)
+     && ((SearchType == AllHandles)
+      || (InternalFindProtocol (&mHandles[Index], Protocol) != NULL))) {
+      (*Buffer)[(*NoHandles)++] = &mHandles[Index];
+    }
+  }
+
+  if (*NoHandles == 0) {
+    FreePool (*Buffer);
+
+    *Buffer = NULL;
+
+    return EFI_NOT_FOUND;
+  }
+
+  return EFI_SUCCESS;
+}
+
+// MockLocateProtocol
+STATIC
+EFI_STATUS
+EFIAPI
+MockLocateProtocol (
+  IN  EFI_GUID  *Protocol,
+  IN  VOID      *Registration OPTIONAL,
+  OUT VOID      **Interface
+  )
+{
+  UINTN                   Index;
+  MOCK_PROTOCOL_INTERFACE *Entry;
+
+  ++mCounters.LocateProtocol;
+
+  for (Index = 0; Index < mNumberOfHandles; ++Index) {
+    Entry = InternalFindProtocol (&mHandles[Index], Protocol);
+
+    if (Entry != NULL) {
+      *Interface = Entry->Interface;
+
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+// MockInstallMultipleProtocolInterfaces
+/// Interfaces installed before a failing one are not removed again.
+STATIC
+EFI_STATUS
+EFIAPI
+MockInstallMultipleProtocolInterfaces (
+  IN OUT EFI_HANDLE  *Handle,
+  ...
+  )
+{
+  EFI_STATUS Status;
+  VA_LIST    Marker;
+  EFI_GUID   *Protocol;
+  VOID       *Interface;
+
+  Status = EFI_SUCCESS;
+
+  VA_START (Marker, Handle);
+
+  for (Protocol = VA_ARG (Marker, EFI_GUID *);
+       Protocol != NULL;
+       Protocol = VA_ARG (Marker, EFI_GUID *)) {
+    Interface = VA_ARG (Marker, VOID *);
+
+    Status = MockInstallProtocolInterface (
+               Handle,
+               Protocol,
+               EFI_NATIVE_INTERFACE,
+               Interface
+               );
+
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  VA_END (Marker);
+
+  return Status;
+}
+
+// MockStall
+STATIC
+EFI_STATUS
+EFIAPI
+MockStall (
+  IN UINTN  Microseconds
+  )
+{
+  MicroSecondDelay (Microseconds);
+
+  return EFI_SUCCESS;
+}
+
+// InternalFindVariable
+STATIC
+MOCK_VARIABLE *
+InternalFindVariable (
+  IN CONST CHAR16    *VariableName,
+  IN CONST EFI_GUID  *VendorGuid
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < MOCK_MAX_VARIABLES; ++Index) {
+    if ((mVariables[Index].Name != NULL)
+     && (StrCmp (mVariables[Index].Name, VariableName) == 0)
+     && CompareGuid (&mVariables[Index].VendorGuid, VendorGuid)) {
+      return &mVariables[Index];
+    }
+  }
+
+  return NULL;
+}
+
+// MockGetVariable
+STATIC
+EFI_STATUS
+EFIAPI
+MockGetVariable (
+  IN     CHAR16    *VariableName,
+  IN     EFI_GUID  *VendorGuid,
+  OUT    UINT32    *Attributes OPTIONAL,
+  IN OUT UINTN     *DataSize,
+  OUT    VOID      *Data OPTIONAL
+  )
+{
+  MOCK_VARIABLE *Variable;
+  UINTN         BufferSize;
+
+  ++mCounters.GetVariable;
+
+  Variable = InternalFindVariable (VariableName, VendorGuid);
+
+  if (Variable == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  BufferSize = *DataSize;
+  *DataSize  = Variable->DataSize;
+
+  if (Attributes != NULL) {
+    *Attributes = Variable->Attributes;
+  }
+
+  if ((BufferSize < Variable->DataSize) || (Data == NULL)) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  CopyMem (Data, Variable->Data, Variable->DataSize);
+
+  return EFI_SUCCESS;
+}
+
+// MockSetVariable
+STATIC
+EFI_STATUS
+EFIAPI
+MockSetVariable (
+  IN CHAR16    *VariableName,
+  IN EFI_GUID  *VendorGuid,
+  IN UINT32    Attributes,
+  IN UINTN     DataSize,
+  IN VOID      *Data
+  )
+{
+  MOCK_VARIABLE *Variable;
+  VOID          *NewData;
+  UINTN         Index;
+
+  ++mCounters.SetVariable;
+
+  Variable = InternalFindVariable (VariableName, VendorGuid);
+
+  if ((DataSize == 0) || (Attributes == 0)) {
+    if (Variable == NULL) {
+      return EFI_NOT_FOUND;
+    }
+
+    FreePool (Variable->Name);
+    FreePool (Variable->Data);
+    ZeroMem (Variable, sizeof (*Variable));
+
+    return EFI_SUCCESS;
+  }
+
+  NewData = AllocateCopyPool (DataSize, Data);
+
+  if (NewData == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (Variable == NULL) {
+    for (Index = 0; Index < MOCK_MAX_VARIABLES; ++Index) {
+      if (mVariables[Index].Name == NULL) {
+        Variable       = &mVariables[Index];
+        Variable->Name = AllocateCopyPool (StrSize (VariableName), VariableName);
+
+        CopyGuid (&Variable->VendorGuid, VendorGuid);
+
+        break;
+      }
+    }
+
+    if ((Variable == NULL) || (Variable->Name == NULL)) {
+      FreePool (NewData);
+
+      return EFI_OUT_OF_RESOURCES;
+    }
+  } else {
+    FreePool (Variable->Data);
+  }
+
+  Variable->Attributes = Attributes;
+  Variable->DataSize   = DataSize;
+  Variable->Data       = NewData;
+
+  return EFI_SUCCESS;
+}
+
+// mBootServices
+STATIC EFI_BOOT_SERVICES mBootServices = {
+  MockRaiseTpl,
+  MockRestoreTpl,
+  MockCreateEvent,
+  MockSignalEvent,
+  MockCloseEvent,
+  MockInstallProtocolInterface,
+  MockReinstallProtocolInterface,
+  MockUninstallProtocolInterface,
+  MockHandleProtocol,
+  MockRegisterProtocolNotify,
+  MockLocateDevicePath,
+  MockInstallConfigurationTable,
+  MockLocateHandleBuffer,
+  MockLocateProtocol,
+  MockInstallMultipleProtocolInterfaces,
+  MockStall
+};
+
+// mRuntimeServices
+STATIC EFI_RUNTIME_SERVICES mRuntimeServices = {
+  MockGetVariable,
+  MockSetVariable
+};
+
+// mSystemTable
+STATIC EFI_SYSTEM_TABLE mSystemTable = {
+  &mBootServices,
+  &mRuntimeServices
+};
+
+// MockInitialize
+EFI_SYSTEM_TABLE *
+MockInitialize (
+  VOID
+  )
+{
+  gST = &mSystemTable;
+  gBS = &mBootServices;
+  gRT = &mRuntimeServices;
+
+  return &mSystemTable;
+}
+
+// MockResetCounters
+VOID
+MockResetCounters (
+  VOID
+  )
+{
+  ZeroMem (&mCounters, sizeof (mCounters));
+  MockResetFileSystemCounters ();
+}
+
+// MockGetCounters
+VOID
+MockGetCounters (
+  OUT MOCK_BOOT_SERVICES_COUNTERS  *BootServices OPTIONAL,
+  OUT MOCK_FILE_SYSTEM_COUNTERS    *FileSystem OPTIONAL
+  )
+{
+  if (BootServices != NULL) {
+    CopyMem (BootServices, &mCounters, sizeof (*BootServices));
+  }
+
+  if (FileSystem != NULL) {
+    MockGetFileSystemCounters (FileSystem);
+  }
+}
+
+// MockGetConfigurationTable
+VOID *
+MockGetConfigurationTable (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < MOCK_MAX_TABLES; ++Index) {
+    if ((mTables[Index].Table != NULL)
+     && CompareGuid (&mTables[Index].Guid, Guid)) {
+      return mTables[Index].Table;
+    }
+  }
+
+  return NULL;
+}
+
+// MockSignalExitBootServices
+VOID
+MockSignalExitBootServices (
+  VOID
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < MOCK_MAX_EVENTS; ++Index) {
+    if (mEvents[Index].Used
+     && (mEvents[Index].Type == EVT_SIGNAL_EXIT_BOOT_SERVICES)) {
+      MockSignalEvent ((EFI_EVENT)&mEvents[Index]);
+    }
+  }
+}
@@ -0,0 +1,790 @@
+#include <AppleMacEfi.h>
+
+#include <Guid/AppleApfsInfo.h>
+#include <Guid/AppleBless.h>
+#include <Guid/FileInfo.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "MockUefi.h"
+
+// MOCK_FILE
+/// An open file or directory.  The path name is relative to the root of the
+/// volume and empty for the root itself.
+typedef struct {
+  EFI_FILE_PROTOCOL File;
+  MOCK_VOLUME       *Volume;
+  BOOLEAN           Directory;
+  CHAR16            PathName[MOCK_MAX_PATH_NAME_LENGTH];
+} MOCK_FILE;
+
+// mNumberOfVolumes
+STATIC UINT32 mNumberOfVolumes = 0;
+
+// mLatency
+STATIC UINT64 mLatency = 0;
+
+// mCounters
+STATIC MOCK_FILE_SYSTEM_COUNTERS mCounters;
+
+// InternalInjectLatency
+STATIC
+VOID
+InternalInjectLatency (
+  VOID
+  )
+{
+  if (mLatency > 0) {
+    NanoSecondDelay ((UINTN)mLatency);
+  }
+}
+
+// InternalToUpper
+STATIC
+CHAR16
+InternalToUpper (
+  IN CHAR16  Char
+  )
+{
+  return (((Char >= L'a') && (Char <= L'z')) ? (Char - (L'a' - L'A')) : Char);
+}
+
+// InternalPathNameEqual
+/// Compares the first Length characters of two path names case-insensitively.
+STATIC
+BOOLEAN
+InternalPathNameEqual (
+  IN CONST CHAR16  *PathName1,
+  IN CONST CHAR16  *PathName2,
+  IN UINTN         Length
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < Length; ++Index) {
+    if (InternalToUpper (PathName1[Index]) != InternalToUpper (PathName2[Index])) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+// InternalResolvePathName
+/** Resolves FileName relative to the directory BasePathName.  Empty and "."
+    components are dropped, ".." removes the preceding component.
+
+  @retval EFI_SUCCESS    The path name has been resolved.
+  @retval EFI_NOT_FOUND  The path name is too long or leaves the root.
+**/
+STATIC
+EFI_STATUS
+InternalResolvePathName (
+  IN  CONST CHAR16  *BasePathName,
+  IN  CONST CHAR16  *FileName,
+  OUT CHAR16        *PathName
+  )
+{
+  UINTN        Length;
+  UINTN        ComponentLength;
+  CONST CHAR16 *Component;
+
+  Length = 0;
+
+  if (FileName[0] != L'\\') {
+    Length = StrLen (BasePathName);
+
+    CopyMem (PathName, BasePathName, Length * sizeof (*PathName));
+  }
+
+  Component = FileName;
+
+  while (*Component != L'\0') {
+    while (*Component == L'\\') {
+      ++Component;
+    }
+
+    for (ComponentLength = 0;
+         (Component[ComponentLength] != L'\0')
+      && (Component[ComponentLength] != L'\\');
+         ++ComponentLength) {
+      ;
+    }
+
+    if ((ComponentLength == 0)
+     || ((ComponentLength == 1) && (Component[0] == L'.'))) {
+      ;
+    } else if ((ComponentLength == 2)
+            && (Component[0] == L'.')
+            && (Component[1] == L'.')) {
+      if (Length == 0) {
+        return EFI_NOT_FOUND;
+      }
+
+      while ((Length > 0) && (PathName[Length - 1] != L'\\')) {
+        --Length;
+      }
+
+      if (Length > 0) {
+        --Length;
+      }
+    } else {
+      if ((Length + ComponentLength + 2) > MOCK_MAX_PATH_NAME_LENGTH) {
+        return EFI_NOT_FOUND;
+      }
+
+      if (Length > 0) {
+        PathName[Length++] = L'\\';
+      }
+
+      CopyMem (
+        &PathName[Length],
+        Component,
+        ComponentLength * sizeof (*PathName)
+        );
+
+      Length += ComponentLength;
+    }
+
+    Component += ComponentLength;
+  }
+
+  PathName[Length] = L'\0';
+
+  return EFI_SUCCESS;
+}
+
+// InternalLookupPathName
+/** Checks whether PathName names a file or an implied directory of Volume.
+
+  @retval EFI_SUCCESS    The path name exists, Directory has been set.
+  @retval EFI_NOT_FOUND  The path name does not exist.
+**/
+STATIC
+EFI_STATUS
+InternalLookupPathName (
+  IN  CONST MOCK_VOLUME  *Volume,
+  IN  CONST CHAR16       *PathName,
+  OUT BOOLEAN            *Directory
+  )
+{
+  UINTN Length;
+  UINTN Index;
+
+  Length = StrLen (PathName);
+
+  if (Length == 0) {
+    *Directory = TRUE;
+
+    return EFI_SUCCESS;
+  }
+
+  for (Index = 0; Index < Volume->NumberOfFiles; ++Index) {
+    if (!InternalPathNameEqual (Volume->Files[Index], PathName, Length)) {
+      continue;
+    }
+
+    if (Volume->Files[Index][Length] == L'\0') {
+      *Directory = FALSE;
+
+      return EFI_SUCCESS;
+    }
+
+    if (Volume->Files[Index][Length] == L'\\') {
+      *Directory = TRUE;
+
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+// InternalReturnInfo
+STATIC
+EFI_STATUS
+InternalReturnInfo (
+  IN     CONST VOID  *Info,
+  IN     UINTN       InfoSize,
+  IN OUT UINTN       *BufferSize,
+  OUT    VOID        *Buffer
+  )
+{
+  UINTN Size;
+
+  Size        = *BufferSize;
+  *BufferSize = InfoSize;
+
+  if ((Size < InfoSize) || (Buffer == NULL)) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  CopyMem (Buffer, Info, InfoSize);
+
+  return EFI_SUCCESS;
+}
+
+// InternalGetBlessedInfo
+/** Returns the device path of the blessed system file, or of the directory
+    containing it if Folder is TRUE.  The path is built in place rather than
+    by FileDevicePath(), so that no boot service is called.
+**/
+STATIC
+EFI_STATUS
+InternalGetBlessedInfo (
+  IN     CONST MOCK_VOLUME  *Volume,
+  IN     BOOLEAN            Folder,
+  IN OUT UINTN              *BufferSize,
+  OUT    VOID               *Buffer
+  )
+{
+  EFI_STATUS           Status;
+
+  UINTN                Length;
+  UINTN                Size;
+  UINT8                *DevicePath;
+  FILEPATH_DEVICE_PATH *FilePath;
+
+  if (Volume->BlessedFile == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  Length = StrLen (Volume->BlessedFile);
+
+  if (Folder) {
+    while ((Length > 1) && (Volume->BlessedFile[Length - 1] != L'\\')) {
+      --Length;
+    }
+
+    if (Length > 1) {
+      --Length;
+    }
+  }
+
+  Size = (sizeof (Volume->DevicePath.HardDrive)
+            + SIZE_OF_FILEPATH_DEVICE_PATH
+            + ((Length + 1) * sizeof (CHAR16))
+            + END_DEVICE_PATH_LENGTH);
+
+  DevicePath = AllocateZeroPool (Size);
+
+  if (DevicePath == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CopyMem (
+    DevicePath,
+    &Volume->DevicePath.HardDrive,
+    sizeof (Volume->DevicePath.HardDrive)
+    );
+
+  FilePath = (FILEPATH_DEVICE_PATH *)(
+               DevicePath + sizeof (Volume->DevicePath.HardDrive)
+               );
+
+  FilePath->Header.Type    = MEDIA_DEVICE_PATH;
+  FilePath->Header.SubType = MEDIA_FILEPATH_DP;
+
+  SetDevicePathNodeLength (
+    &FilePath->Header,
+    SIZE_OF_FILEPATH_DEVICE_PATH + ((Length + 1) * sizeof (CHAR16))
+    );
+
+  CopyMem (
+    &FilePath->PathName[0],
+    Volume->BlessedFile,
+    Length * sizeof (CHAR16)
+    );
+
+  SetDevicePathEndNode (NextDevicePathNode (&FilePath->Header));
+
+  Status = InternalReturnInfo (DevicePath, Size, BufferSize, Buffer);
+
+  FreePool (DevicePath);
+
+  return Status;
+}
+
+// MockFileOpen
+STATIC
+EFI_STATUS
+EFIAPI
+MockFileOpen (
+  IN  EFI_FILE_PROTOCOL  *This,
+  OUT EFI_FILE_PROTOCOL  **NewHandle,
+  IN  CHAR16             *FileName,
+  IN  UINT64             OpenMode,
+  IN  UINT64             Attributes
+  );
+
+// MockFileClose
+STATIC
+EFI_STATUS
+EFIAPI
+MockFileClose (
+  IN EFI_FILE_PROTOCOL  *This
+  )
+{
+  ++mCounters.Close;
+  --mCounters.OpenFiles;
+
+  FreePool (This);
+
+  return EFI_SUCCESS;
+}
+
+// MockFileRead
+/// Files are empty and directory listings are not supported.
+STATIC
+EFI_STATUS
+EFIAPI
+MockFileRead (
+  IN     EFI_FILE_PROTOCOL  *This,
+  IN OUT UINTN              *BufferSize,
+  OUT    VOID               *Buffer
+  )
+{
+  ++mCounters.Read;
+
+  InternalInjectLatency ();
+
+  if (((MOCK_FILE *)This)->Directory) {
+    return EFI_UNSUPPORTED;
+  }
+
+  *BufferSize = 0;
+
+  return EFI_SUCCESS;
+}
+
+// MockFileGetInfo
+STATIC
+EFI_STATUS
+EFIAPI
+MockFileGetInfo (
+  IN     EFI_FILE_PROTOCOL  *This,
+  IN     EFI_GUID           *InformationType,
+  IN OUT UINTN              *BufferSize,
+  OUT    VOID               *Buffer
+  )
+{
+  EFI_STATUS                Status;
+
+  MOCK_FILE                 *File;
+  CONST CHAR16              *FileName;
+  UINTN                     Size;
+  EFI_FILE_INFO             *FileInfo;
+  APPLE_APFS_CONTAINER_INFO ContainerInfo;
+  APPLE_APFS_VOLUME_INFO    VolumeInfo;
+
+  ++mCounters.GetInfo;
+
+  InternalInjectLatency ();
+
+  File = (MOCK_FILE *)This;
+
+  if (CompareGuid (InformationType, &gEfiFileInfoGuid)) {
+    for (FileName = &File->PathName[StrLen (File->PathName)];
+         (FileName > &File->PathName[0]) && (FileName[-1] != L'\\');
+         --FileName) {
+      ;
+    }
+
+    Size     = (SIZE_OF_EFI_FILE_INFO + StrSize (FileName));
+    FileInfo = AllocateZeroPool (Size);
+
+    if (FileInfo == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    FileInfo->Size      = Size;
+    FileInfo->Attribute = (EFI_FILE_READ_ONLY
+                            | (File->Directory ? EFI_FILE_DIRECTORY : 0));
+
+    StrCpy (&FileInfo->FileName[0], FileName);
+
+    Status = InternalReturnInfo (FileInfo, Size, BufferSize, Buffer);
+
+    FreePool (FileInfo);
+
+    return Status;
+  }
+
+  if (File->Volume->Apfs) {
+    if (CompareGuid (InformationType, &gAppleApfsContainerInfoGuid)) {
+      ContainerInfo.Always1 = 1;
+      CopyGuid (&ContainerInfo.Uuid, &File->Volume->ContainerGuid);
+
+      return InternalReturnInfo (
+               &ContainerInfo,
+               sizeof (ContainerInfo),
+               BufferSize,
+               Buffer
+               );
+    }
+
+    if (CompareGuid (InformationType, &gAppleApfsVolumeInfoGuid)) {
+      VolumeInfo.Always1 = 1;
+      VolumeInfo.Role    = File->Volume->Role;
+      CopyGuid (&VolumeInfo.Uuid, &File->Volume->VolumeGuid);
+
+      return InternalReturnInfo (
+               &VolumeInfo,
+               sizeof (VolumeInfo),
+               BufferSize,
+               Buffer
+               );
+    }
+  }
+
+  if (CompareGuid (InformationType, &gAppleBlessedSystemFileInfoGuid)) {
+    return InternalGetBlessedInfo (File->Volume, FALSE, BufferSize, Buffer);
+  }
+
+  if (CompareGuid (InformationType, &gAppleBlessedSystemFolderInfoGuid)) {
+    return InternalGetBlessedInfo (File->Volume, TRUE, BufferSize, Buffer);
+  }
+
+  return EFI_UNSUPPORTED;
+}
+
+// InternalCreateFile
+STATIC
+MOCK_FILE *
+InternalCreateFile (
+  IN MOCK_VOLUME   *Volume,
+  IN CONST CHAR16  *PathName,
+  IN BOOLEAN       Directory
+  )
+{
+  MOCK_FILE *File;
+
+  File = AllocateZeroPool (sizeof (*File));
+
+  if (File != NULL) {
+    File->File.Revision = EFI_FILE_PROTOCOL_REVISION;
+    File->File.Open     = MockFileOpen;
+    File->File.Close    = MockFileClose;
+    File->File.Read     = MockFileRead;
+    File->File.GetInfo  = MockFileGetInfo;
+    File->Volume        = Volume;
+    File->Directory     = Directory;
+
+    StrCpy (&File->PathName[0], PathName);
+
+    ++mCounters.OpenFiles;
+  }
+
+  return File;
+}
+
+// MockFileOpen
+STATIC
+EFI_STATUS
+EFIAPI
+MockFileOpen (
+  IN  EFI_FILE_PROTOCOL  *This,
+  OUT EFI_FILE_PROTOCOL  **NewHandle,
+  IN  CHAR16             *FileName,
+  IN  UINT64             OpenMode,
+  IN  UINT64             Attributes
+  )
+{
+  EFI_STATUS Status;
+
+  MOCK_FILE  *File;
+  MOCK_FILE  *NewFile;
+  CHAR16     PathName[MOCK_MAX_PATH_NAME_LENGTH];
+  BOOLEAN    Directory;
+
+  ++mCounters.Open;
+
+  InternalInjectLatency ();
+
+  File   = (MOCK_FILE *)This;
+  Status = EFI_ACCESS_DENIED;
+
+  if (OpenMode == EFI_FILE_MODE_READ) {
+    Status = InternalResolvePathName (File->PathName, FileName, PathName);
+
+    if (!EFI_ERROR (Status)) {
+      Status = InternalLookupPathName (File->Volume, PathName, &Directory);
+    }
+
+    if (!EFI_ERROR (Status)) {
+      NewFile = InternalCreateFile (File->Volume, PathName, Directory);
+      Status  = EFI_OUT_OF_RESOURCES;
+
+      if (NewFile != NULL) {
+        *NewHandle = &NewFile->File;
+        Status     = EFI_SUCCESS;
+      }
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    ++mCounters.OpenFailed;
+  }
+
+  return Status;
+}
+
+// MockOpenVolume
+STATIC
+EFI_STATUS
+EFIAPI
+MockOpenVolume (
+  IN  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL  *This,
+  OUT EFI_FILE_PROTOCOL                **Root
+  )
+{
+  MOCK_FILE *File;
+
+  ++mCounters.OpenVolume;
+
+  InternalInjectLatency ();
+
+  File = InternalCreateFile (
+           BASE_CR (This, MOCK_VOLUME, FileSystem),
+           L"",
+           TRUE
+           );
+
+  if (File == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  *Root = &File->File;
+
+  return EFI_SUCCESS;
+}
+
+// MockSetLatency
+VOID
+MockSetLatency (
+  IN UINT64  Nanoseconds
+  )
+{
+  mLatency = Nanoseconds;
+}
+
+// MockCreateVolume
+MOCK_VOLUME *
+MockCreateVolume (
+  VOID
+  )
+{
+  MOCK_VOLUME           *Volume;
+  HARDDRIVE_DEVICE_PATH *HardDrive;
+
+  Volume = AllocateZeroPool (sizeof (*Volume));
+
+  if (Volume != NULL) {
+    ++mNumberOfVolumes;
+
+    Volume->FileSystem.Revision   = EFI_SIMPLE_FILE_SYSTEM_PROTOCOL_REVISION;
+    Volume->FileSystem.OpenVolume = MockOpenVolume;
+
+    Volume->Media.MediaId      = 1;
+    Volume->Media.MediaPresent = TRUE;
+    Volume->Media.BlockSize    = 512;
+    Volume->BlockIo.Media      = &Volume->Media;
+
+    HardDrive = &Volume->DevicePath.HardDrive;
+
+    HardDrive->Header.Type     = MEDIA_DEVICE_PATH;
+    HardDrive->Header.SubType  = MEDIA_HARDDRIVE_DP;
+    HardDrive->PartitionNumber = mNumberOfVolumes;
+    HardDrive->MBRType         = MBR_TYPE_EFI_PARTITION_TABLE_HEADER;
+    HardDrive->SignatureType   = SIGNATURE_TYPE_GUID;
+
+    CopyMem (
+      &HardDrive->Signature[0],
+      &mNumberOfVolumes,
+      sizeof (mNumberOfVolumes)
+      );
+
+    SetDevicePathNodeLength (&HardDrive->Header, sizeof (*HardDrive));
+
+    SetDevicePathEndNode (&Volume->DevicePath.End);
+  }
+
+  return Volume;
+}
+
+// MockSetApfsInfo
+VOID
+MockSetApfsInfo (
+  IN OUT MOCK_VOLUME             *Volume,
+  IN     CONST EFI_GUID          *ContainerGuid,
+  IN     CONST EFI_GUID          *VolumeGuid,
+  IN     APPLE_APFS_VOLUME_ROLE  Role
+  )
+{
+  Volume->Apfs = TRUE;
+  Volume->Role = Role;
+
+  CopyGuid (&Volume->ContainerGuid, ContainerGuid);
+  CopyGuid (&Volume->VolumeGuid, VolumeGuid);
+}
+
+// MockAddFile
+EFI_STATUS
+MockAddFile (
+  IN OUT MOCK_VOLUME   *Volume,
+  IN     CONST CHAR16  *PathName
+  )
+{
+  EFI_STATUS Status;
+
+  CHAR16     ResolvedPathName[MOCK_MAX_PATH_NAME_LENGTH];
+
+  if (Volume->NumberOfFiles == MOCK_MAX_FILES) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = InternalResolvePathName (L"", PathName, ResolvedPathName);
+
+  if (!EFI_ERROR (Status)) {
+    Volume->Files[Volume->NumberOfFiles] = AllocateCopyPool (
+                                             StrSize (ResolvedPathName),
+                                             ResolvedPathName
+                                             );
+
+    Status = EFI_OUT_OF_RESOURCES;
+
+    if (Volume->Files[Volume->NumberOfFiles] != NULL) {
+      ++Volume->NumberOfFiles;
+
+      Status = EFI_SUCCESS;
+    }
+  }
+
+  return Status;
+}
+
+// MockAddDirectory
+EFI_STATUS
+MockAddDirectory (
+  IN OUT MOCK_VOLUME   *Volume,
+  IN     CONST CHAR16  *PathName
+  )
+{
+  EFI_STATUS Status;
+
+  CHAR16     ResolvedPathName[MOCK_MAX_PATH_NAME_LENGTH];
+  UINTN      Length;
+
+  if (Volume->NumberOfFiles == MOCK_MAX_FILES) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = InternalResolvePathName (L"", PathName, ResolvedPathName);
+
+  if (!EFI_ERROR (Status)) {
+    Length = StrLen (ResolvedPathName);
+    Status = EFI_NOT_FOUND;
+
+    if ((Length > 0) && ((Length + 2) <= MOCK_MAX_PATH_NAME_LENGTH)) {
+      //
+      // The trailing backslash makes the entry match as a directory only.
+      //
+      ResolvedPathName[Length]     = L'\\';
+      ResolvedPathName[Length + 1] = L'\0';
+
+      Volume->Files[Volume->NumberOfFiles] = AllocateCopyPool (
+                                               StrSize (ResolvedPathName),
+                                               ResolvedPathName
+                                               );
+
+      Status = EFI_OUT_OF_RESOURCES;
+
+      if (Volume->Files[Volume->NumberOfFiles] != NULL) {
+        ++Volume->NumberOfFiles;
+
+        Status = EFI_SUCCESS;
+      }
+    }
+  }
+
+  return Status;
+}
+
+// MockBlessFile
+VOID
+MockBlessFile (
+  IN OUT MOCK_VOLUME   *Volume,
+  IN     CONST CHAR16  *PathName
+  )
+{
+  if (Volume->BlessedFile != NULL) {
+    FreePool (Volume->BlessedFile);
+  }
+
+  Volume->BlessedFile = AllocateCopyPool (StrSize (PathName), PathName);
+}
+
+// MockInstallVolume
+EFI_STATUS
+MockInstallVolume (
+  IN OUT MOCK_VOLUME  *Volume
+  )
+{
+  Volume->Handle = NULL;
+
+  return gBS->InstallMultipleProtocolInterfaces (
+                &Volume->Handle,
+                &gEfiDevicePathProtocolGuid,
+                &Volume->DevicePath,
+                &gEfiBlockIoProtocolGuid,
+                &Volume->BlockIo,
+                &gEfiSimpleFileSystemProtocolGuid,
+                &Volume->FileSystem,
+                NULL
+                );
+}
+
+// MockReinstallVolume
+EFI_STATUS
+MockReinstallVolume (
+  IN OUT MOCK_VOLUME  *Volume
+  )
+{
+  ++Volume->Media.MediaId;
+
+  return gBS->ReinstallProtocolInterface (
+                Volume->Handle,
+                &gEfiSimpleFileSystemProtocolGuid,
+                &Volume->FileSystem,
+                &Volume->FileSystem
+                );
+}
+
+// MockGetFileSystemCounters
+VOID
+MockGetFileSystemCounters (
+  OUT MOCK_FILE_SYSTEM_COUNTERS  *Counters
+  )
+{
+  CopyMem (Counters, &mCounters, sizeof (*Counters));
+}
+
+// MockResetFileSystemCounters
+VOID
+MockResetFileSystemCounters (
+  VOID
+  )
+{
+  UINT64 OpenFiles;
+
+  OpenFiles = mCounters.OpenFiles;
+
+  ZeroMem (&mCounters, sizeof (mCounters));
+
+  mCounters.OpenFiles = OpenFiles;
+}
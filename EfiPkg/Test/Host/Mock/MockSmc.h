@@ -0,0 +1,72 @@
+#ifndef MOCK_SMC_H_
+#define MOCK_SMC_H_
+
+#include <IndustryStandard/AppleSmc.h>
+
+// MOCK_SMC_MMIO_COUNTERS
+/// The accesses of the mock SMC MMIO window issued since the last
+/// MockSmcResetCounters().  The data, key and command registers at
+/// SMC_MMIO_DATA_VARIABLE are counted by direction and width, the reads of
+/// the status and result registers separately.  Unmapped counts accesses
+/// outside of both.
+typedef struct {
+  UINT64 Read8;
+  UINT64 Read16;
+  UINT64 Read32;
+  UINT64 Write8;
+  UINT64 Write16;
+  UINT64 Write32;
+  UINT64 StatusRead;
+  UINT64 Unmapped;
+} MOCK_SMC_MMIO_COUNTERS;
+
+// MOCK_SMC_MAX_KEYS
+/// The number of keys the mock SMC holds.
+#define MOCK_SMC_MAX_KEYS  32
+
+// MockSmcInitialize
+/** Removes all keys and resets the registers and counters of the mock SMC.
+
+  @returns  The base address to pass to the SMC MMIO functions.
+**/
+SMC_ADDRESS
+MockSmcInitialize (
+  VOID
+  );
+
+// MockSmcAddKey
+/** Adds a key in index order.  Size bytes of Value are its initial value.
+**/
+EFI_STATUS
+MockSmcAddKey (
+  IN SMC_KEY             Key,
+  IN SMC_KEY_TYPE        Type,
+  IN SMC_KEY_ATTRIBUTES  Attributes,
+  IN SMC_DATA_SIZE       Size,
+  IN CONST SMC_DATA      *Value
+  );
+
+// MockSmcGetValue
+/** Returns the value the mock SMC holds for Key, as written by the last
+    WriteValue command.  Value must be able to hold SMC_MAX_DATA_SIZE bytes.
+**/
+EFI_STATUS
+MockSmcGetValue (
+  IN  SMC_KEY        Key,
+  OUT SMC_DATA_SIZE  *Size,
+  OUT SMC_DATA       *Value
+  );
+
+// MockSmcGetCounters
+VOID
+MockSmcGetCounters (
+  OUT MOCK_SMC_MMIO_COUNTERS  *Counters
+  );
+
+// MockSmcResetCounters
+VOID
+MockSmcResetCounters (
+  VOID
+  );
+
+#endif // MOCK_SMC_H_
@@ -0,0 +1,444 @@
+#include <AppleMacEfi.h>
+
+#include <IndustryStandard/AppleSmc.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/IoLib.h>
+
+#include "MockSmc.h"
+
+// MOCK_SMC_REGISTERS_SIZE
+/// The size of the data, key and command registers at the base address.
+#define MOCK_SMC_REGISTERS_SIZE  (SMC_MMIO_WRITE_COMMAND + 1)
+
+// MOCK_SMC_KEY
+typedef struct {
+  SMC_KEY            Key;
+  SMC_KEY_TYPE       Type;
+  SMC_KEY_ATTRIBUTES Attributes;
+  SMC_DATA_SIZE      Size;
+  SMC_DATA           Value[SMC_MAX_DATA_SIZE];
+} MOCK_SMC_KEY;
+
+// mKeys
+STATIC MOCK_SMC_KEY mKeys[MOCK_SMC_MAX_KEYS];
+
+// mNumberOfKeys
+STATIC UINTN mNumberOfKeys = 0;
+
+// mWritten
+/// The registers as written by the host.  The SMC answers in mRead, as the
+/// read and write registers at an offset are distinct.
+STATIC UINT8 mWritten[MOCK_SMC_REGISTERS_SIZE];
+
+// mRead
+STATIC UINT8 mRead[MOCK_SMC_REGISTERS_SIZE];
+
+// mStatus
+STATIC SMC_STATUS mStatus = 0;
+
+// mResult
+STATIC SMC_RESULT mResult = SmcSuccess;
+
+// mCounters
+STATIC MOCK_SMC_MMIO_COUNTERS mCounters;
+
+// InternalFindKey
+STATIC
+MOCK_SMC_KEY *
+InternalFindKey (
+  IN SMC_KEY  Key
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < mNumberOfKeys; ++Index) {
+    if (mKeys[Index].Key == Key) {
+      return &mKeys[Index];
+    }
+  }
+
+  return NULL;
+}
+
+// InternalReadBigEndian32
+/// Keys, key types and indices are transferred most significant byte first.
+STATIC
+UINT32
+InternalReadBigEndian32 (
+  IN CONST UINT8  *Registers,
+  IN UINTN        Offset
+  )
+{
+  return SwapBytes32 (ReadUnaligned32 ((CONST UINT32 *)&Registers[Offset]));
+}
+
+// InternalWriteBigEndian32
+STATIC
+VOID
+InternalWriteBigEndian32 (
+  IN UINT8   *Registers,
+  IN UINTN   Offset,
+  IN UINT32  Value
+  )
+{
+  WriteUnaligned32 ((UINT32 *)&Registers[Offset], SwapBytes32 (Value));
+}
+
+// InternalExecuteCommand
+/** Executes Command on the written registers and signals its completion.
+**/
+STATIC
+VOID
+InternalExecuteCommand (
+  IN SMC_COMMAND  Command
+  )
+{
+  MOCK_SMC_KEY  *Key;
+  SMC_KEY_INDEX Index;
+  SMC_DATA_SIZE Size;
+
+  mResult = SmcSuccess;
+
+  switch (Command) {
+    case SmcCmdReadValue:
+    case SmcCmdWriteValue:
+    case SmcCmdGetKeyInfo:
+    {
+      Key = InternalFindKey (
+              (SMC_KEY)InternalReadBigEndian32 (mWritten, SMC_MMIO_DATA_FIXED)
+              );
+
+      if (Key == NULL) {
+        mResult = SmcNotFound;
+      } else if (Command == SmcCmdReadValue) {
+        CopyMem (&mRead[SMC_MMIO_DATA_VARIABLE], Key->Value, Key->Size);
+
+        mRead[SMC_MMIO_READ_DATA_SIZE] = Key->Size;
+      } else if (Command == SmcCmdWriteValue) {
+        Size = mWritten[SMC_MMIO_WRITE_DATA_SIZE];
+
+        if (Size != Key->Size) {
+          mResult = SmcInvalidSize;
+        } else {
+          CopyMem (Key->Value, &mWritten[SMC_MMIO_DATA_VARIABLE], Size);
+        }
+      } else {
+        //
+        // The type register overlaps the size and attribute registers, which
+        // take precedence.
+        //
+        InternalWriteBigEndian32 (mRead, SMC_MMIO_READ_KEY_TYPE, Key->Type);
+
+        mRead[SMC_MMIO_READ_DATA_SIZE]      = Key->Size;
+        mRead[SMC_MMIO_READ_KEY_ATTRIBUTES] = Key->Attributes;
+      }
+
+      break;
+    }
+
+    case SmcCmdGetKeyFromIndex:
+    {
+      Index = (SMC_KEY_INDEX)InternalReadBigEndian32 (
+                               mWritten,
+                               SMC_MMIO_DATA_FIXED
+                               );
+
+      if (Index >= mNumberOfKeys) {
+        mResult = SmcNotFound;
+      } else {
+        InternalWriteBigEndian32 (mRead, SMC_MMIO_READ_KEY, mKeys[Index].Key);
+      }
+
+      break;
+    }
+
+    default:
+    {
+      break;
+    }
+  }
+
+  mStatus = SMC_STATUS_KEY_DONE;
+}
+
+// InternalRegisterOffset
+/** Returns the offset of Width bytes at Address into the data, key and
+    command registers, or MAX_UINTN if they are not within them.
+**/
+STATIC
+UINTN
+InternalRegisterOffset (
+  IN UINTN  Address,
+  IN UINTN  Width
+  )
+{
+  UINTN Offset;
+
+  if (Address >= SMC_MMIO_BASE_ADDRESS) {
+    Offset = (Address - SMC_MMIO_BASE_ADDRESS);
+
+    if ((Offset + Width) <= MOCK_SMC_REGISTERS_SIZE) {
+      return Offset;
+    }
+  }
+
+  return MAX_UINTN;
+}
+
+// MockSmcInitialize
+SMC_ADDRESS
+MockSmcInitialize (
+  VOID
+  )
+{
+  mNumberOfKeys = 0;
+  mStatus       = 0;
+  mResult       = SmcSuccess;
+
+  ZeroMem (mWritten, sizeof (mWritten));
+  ZeroMem (mRead, sizeof (mRead));
+  ZeroMem (&mCounters, sizeof (mCounters));
+
+  return SMC_MMIO_BASE_ADDRESS;
+}
+
+// MockSmcAddKey
+EFI_STATUS
+MockSmcAddKey (
+  IN SMC_KEY             Key,
+  IN SMC_KEY_TYPE        Type,
+  IN SMC_KEY_ATTRIBUTES  Attributes,
+  IN SMC_DATA_SIZE       Size,
+  IN CONST SMC_DATA      *Value
+  )
+{
+  MOCK_SMC_KEY *SmcKey;
+
+  if ((Size == 0) || (Size > SMC_MAX_DATA_SIZE)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (mNumberOfKeys == ARRAY_SIZE (mKeys)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  SmcKey = &mKeys[mNumberOfKeys];
+
+  SmcKey->Key        = Key;
+  SmcKey->Type       = Type;
+  SmcKey->Attributes = Attributes;
+  SmcKey->Size       = Size;
+
+  CopyMem (SmcKey->Value, Value, Size);
+
+  ++mNumberOfKeys;
+
+  return EFI_SUCCESS;
+}
+
+// MockSmcGetValue
+EFI_STATUS
+MockSmcGetValue (
+  IN  SMC_KEY        Key,
+  OUT SMC_DATA_SIZE  *Size,
+  OUT SMC_DATA       *Value
+  )
+{
+  MOCK_SMC_KEY *SmcKey;
+
+  SmcKey = InternalFindKey (Key);
+
+  if (SmcKey == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  *Size = SmcKey->Size;
+
+  CopyMem (Value, SmcKey->Value, SmcKey->Size);
+
+  return EFI_SUCCESS;
+}
+
+// MockSmcGetCounters
+VOID
+MockSmcGetCounters (
+  OUT MOCK_SMC_MMIO_COUNTERS  *Counters
+  )
+{
+  CopyMem (Counters, &mCounters, sizeof (*Counters));
+}
+
+// MockSmcResetCounters
+VOID
+MockSmcResetCounters (
+  VOID
+  )
+{
+  ZeroMem (&mCounters, sizeof (mCounters));
+}
+
+// MmioRead8
+/// Reading the result acknowledges the command, like on the SMC.
+UINT8
+EFIAPI
+MmioRead8 (
+  IN UINTN  Address
+  )
+{
+  UINTN Offset;
+
+  if (Address == (SMC_MMIO_BASE_ADDRESS + SMC_MMIO_READ_KEY_STATUS)) {
+    ++mCounters.StatusRead;
+
+    return mStatus;
+  }
+
+  if (Address == (SMC_MMIO_BASE_ADDRESS + SMC_MMIO_READ_RESULT)) {
+    ++mCounters.StatusRead;
+
+    mStatus = 0;
+
+    return mResult;
+  }
+
+  Offset = InternalRegisterOffset (Address, sizeof (UINT8));
+
+  if (Offset == MAX_UINTN) {
+    ++mCounters.Unmapped;
+
+    return MAX_UINT8;
+  }
+
+  ++mCounters.Read8;
+
+  return mRead[Offset];
+}
+
+// MmioRead16
+UINT16
+EFIAPI
+MmioRead16 (
+  IN UINTN  Address
+  )
+{
+  UINTN  Offset;
+  UINT16 Value;
+
+  Offset = InternalRegisterOffset (Address, sizeof (UINT16));
+
+  if (Offset == MAX_UINTN) {
+    ++mCounters.Unmapped;
+
+    return MAX_UINT16;
+  }
+
+  ++mCounters.Read16;
+
+  CopyMem (&Value, &mRead[Offset], sizeof (Value));
+
+  return Value;
+}
+
+// MmioRead32
+UINT32
+EFIAPI
+MmioRead32 (
+  IN UINTN  Address
+  )
+{
+  UINTN Offset;
+
+  Offset = InternalRegisterOffset (Address, sizeof (UINT32));
+
+  if (Offset == MAX_UINTN) {
+    ++mCounters.Unmapped;
+
+    return MAX_UINT32;
+  }
+
+  ++mCounters.Read32;
+
+  return ReadUnaligned32 ((CONST UINT32 *)&mRead[Offset]);
+}
+
+// MmioWrite8
+/// Writing the command register executes the command.
+UINT8
+EFIAPI
+MmioWrite8 (
+  IN UINTN  Address,
+  IN UINT8  Value
+  )
+{
+  UINTN Offset;
+
+  Offset = InternalRegisterOffset (Address, sizeof (UINT8));
+
+  if (Offset == MAX_UINTN) {
+    ++mCounters.Unmapped;
+
+    return Value;
+  }
+
+  ++mCounters.Write8;
+
+  mWritten[Offset] = Value;
+
+  if (Offset == SMC_MMIO_WRITE_COMMAND) {
+    InternalExecuteCommand ((SMC_COMMAND)Value);
+  }
+
+  return Value;
+}
+
+// MmioWrite16
+UINT16
+EFIAPI
+MmioWrite16 (
+  IN UINTN   Address,
+  IN UINT16  Value
+  )
+{
+  UINTN Offset;
+
+  Offset = InternalRegisterOffset (Address, sizeof (UINT16));
+
+  if (Offset == MAX_UINTN) {
+    ++mCounters.Unmapped;
+
+    return Value;
+  }
+
+  ++mCounters.Write16;
+
+  CopyMem (&mWritten[Offset], &Value, sizeof (Value));
+
+  return Value;
+}
+
+// MmioWrite32
+UINT32
+EFIAPI
+MmioWrite32 (
+  IN UINTN   Address,
+  IN UINT32  Value
+  )
+{
+  UINTN Offset;
+
+  Offset = InternalRegisterOffset (Address, sizeof (UINT32));
+
+  if (Offset == MAX_UINTN) {
+    ++mCounters.Unmapped;
+
+    return Value;
+  }
+
+  ++mCounters.Write32;
+
+  WriteUnaligned32 ((UINT32 *)&mWritten[Offset], Value);
+
+  return Value;
+}
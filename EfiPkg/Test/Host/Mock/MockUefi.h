@@ -0,0 +1,219 @@
+#ifndef MOCK_UEFI_H_
+#define MOCK_UEFI_H_
+
+#include <Guid/AppleApfsInfo.h>
+
+#include <Protocol/BlockIo.h>
+#include <Protocol/DevicePath.h>
+#include <Protocol/SimpleFileSystem.h>
+
+// MOCK_BOOT_SERVICES_COUNTERS
+/// The calls of the boot and runtime services issued since the last
+/// MockResetCounters().
+typedef struct {
+  UINT64 HandleProtocol;
+  UINT64 LocateHandleBuffer;
+  UINT64 LocateDevicePath;
+  UINT64 LocateProtocol;
+  UINT64 GetVariable;
+  UINT64 SetVariable;
+} MOCK_BOOT_SERVICES_COUNTERS;
+
+// MOCK_FILE_SYSTEM_COUNTERS
+/// The calls of the mock file systems issued since the last
+/// MockResetCounters().  OpenFiles is the number of files currently open,
+/// including roots, and is not reset.
+typedef struct {
+  UINT64 OpenVolume;
+  UINT64 Open;
+  UINT64 OpenFailed;
+  UINT64 GetInfo;
+  UINT64 Read;
+  UINT64 Close;
+  UINT64 OpenFiles;
+} MOCK_FILE_SYSTEM_COUNTERS;
+
+// MOCK_MAX_FILES
+/// The number of files a mock volume holds.
+#define MOCK_MAX_FILES  64
+
+// MOCK_MAX_PATH_NAME_LENGTH
+/// The number of characters of a mock path name, including the terminator.
+#define MOCK_MAX_PATH_NAME_LENGTH  128
+
+#pragma pack(1)
+
+// MOCK_VOLUME_DEVICE_PATH
+typedef struct {
+  HARDDRIVE_DEVICE_PATH    HardDrive;
+  EFI_DEVICE_PATH_PROTOCOL End;
+} MOCK_VOLUME_DEVICE_PATH;
+
+#pragma pack()
+
+// MOCK_VOLUME
+/// An in-memory file system.  Directories are implied by the path names of
+/// the files, which are stored without the leading backslash.  Path names
+/// are compared case-insensitively.
+typedef struct {
+  EFI_HANDLE                      Handle;
+  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL FileSystem;
+  EFI_BLOCK_IO_PROTOCOL           BlockIo;
+  EFI_BLOCK_IO_MEDIA              Media;
+  MOCK_VOLUME_DEVICE_PATH         DevicePath;
+  BOOLEAN                         Apfs;
+  EFI_GUID                        ContainerGuid;
+  EFI_GUID                        VolumeGuid;
+  APPLE_APFS_VOLUME_ROLE          Role;
+  CHAR16                          *BlessedFile;
+  UINTN                           NumberOfFiles;
+  CHAR16                          *Files[MOCK_MAX_FILES];
+} MOCK_VOLUME;
+
+// MockInitialize
+/** Installs the mock boot and runtime services as gBS and gRT and returns
+    the system table to pass to driver entry points.
+**/
+EFI_SYSTEM_TABLE *
+MockInitialize (
+  VOID
+  );
+
+// MockResetCounters
+VOID
+MockResetCounters (
+  VOID
+  );
+
+// MockGetCounters
+VOID
+MockGetCounters (
+  OUT MOCK_BOOT_SERVICES_COUNTERS  *BootServices OPTIONAL,
+  OUT MOCK_FILE_SYSTEM_COUNTERS    *FileSystem OPTIONAL
+  );
+
+// MockGetConfigurationTable
+/** Retrieves a table installed via InstallConfigurationTable().
+
+  @return  Returned is the table, or NULL if none is installed for Guid.
+**/
+VOID *
+MockGetConfigurationTable (
+  IN CONST EFI_GUID  *Guid
+  );
+
+// MockSignalExitBootServices
+/** Signals all events created with EVT_SIGNAL_EXIT_BOOT_SERVICES.
+**/
+VOID
+MockSignalExitBootServices (
+  VOID
+  );
+
+// MockSetLatency
+/** Sets the time every OpenVolume(), Open(), GetInfo() and Read() call of
+    the mock file systems spins for before returning.
+
+  @param[in] Nanoseconds  The latency to inject, or 0.
+**/
+VOID
+MockSetLatency (
+  IN UINT64  Nanoseconds
+  );
+
+// MockCreateVolume
+/** Creates an empty volume.  Its device path is a GPT hard drive node whose
+    signature is unique per volume.
+
+  @return  Returned is the volume, or NULL on allocation failure.
+**/
+MOCK_VOLUME *
+MockCreateVolume (
+  VOID
+  );
+
+// MockSetApfsInfo
+/** Makes Volume report APFS container and volume information.
+**/
+VOID
+MockSetApfsInfo (
+  IN OUT MOCK_VOLUME             *Volume,
+  IN     CONST EFI_GUID          *ContainerGuid,
+  IN     CONST EFI_GUID          *VolumeGuid,
+  IN     APPLE_APFS_VOLUME_ROLE  Role
+  );
+
+// MockAddFile
+/** Adds a file to Volume.  The directories leading to it are implied.
+
+  @param[in, out] Volume    The volume to add the file to.
+  @param[in]      PathName  The absolute path name of the file.
+
+  @retval EFI_SUCCESS           The file has been added.
+  @retval EFI_OUT_OF_RESOURCES  The volume is full.
+**/
+EFI_STATUS
+MockAddFile (
+  IN OUT MOCK_VOLUME   *Volume,
+  IN     CONST CHAR16  *PathName
+  );
+
+// MockAddDirectory
+/** Adds a directory to Volume, which is reported even if empty.
+
+  @param[in, out] Volume    The volume to add the directory to.
+  @param[in]      PathName  The absolute path name of the directory.
+
+  @retval EFI_SUCCESS           The directory has been added.
+  @retval EFI_NOT_FOUND         PathName names the root or is too long.
+  @retval EFI_OUT_OF_RESOURCES  The volume is full.
+**/
+EFI_STATUS
+MockAddDirectory (
+  IN OUT MOCK_VOLUME   *Volume,
+  IN     CONST CHAR16  *PathName
+  );
+
+// MockBlessFile
+/** Makes Volume report PathName as its blessed system file, and the
+    directory containing it as the blessed system folder.
+**/
+VOID
+MockBlessFile (
+  IN OUT MOCK_VOLUME   *Volume,
+  IN     CONST CHAR16  *PathName
+  );
+
+// MockInstallVolume
+/** Installs the device path, block I/O and simple file system protocols of
+    Volume on a new handle.
+**/
+EFI_STATUS
+MockInstallVolume (
+  IN OUT MOCK_VOLUME  *Volume
+  );
+
+// MockReinstallVolume
+/** Changes the media ID of Volume and reinstalls its simple file system
+    protocol, as done by a file system driver after a media change.
+**/
+EFI_STATUS
+MockReinstallVolume (
+  IN OUT MOCK_VOLUME  *Volume
+  );
+
+// MockGetFileSystemCounters
+/** Used by the boot services mock to report the file system counters.
+**/
+VOID
+MockGetFileSystemCounters (
+  OUT MOCK_FILE_SYSTEM_COUNTERS  *Counters
+  );
+
+// MockResetFileSystemCounters
+VOID
+MockResetFileSystemCounters (
+  VOID
+  );
+
+#endif // MOCK_UEFI_H_
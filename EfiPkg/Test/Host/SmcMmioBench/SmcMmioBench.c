@@ -0,0 +1,295 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <AppleMacEfi.h>
+
+#include <IndustryStandard/AppleSmc.h>
+
+#include <Protocol/AppleSmcIo.h>
+
+#include <Library/BaseMemoryLib.h>
+
+#include "../Mock/MockSmc.h"
+
+#include "SmcIoInternal.h"
+
+//
+// Counts the MMIO accesses the SMC MMIO functions of AppleSmcDxe issue
+// against a mock SMC, per command and value size.  Uncached MMIO accesses
+// are bus transactions of roughly constant cost, hence their number rather
+// than the host run time is what is compared.
+//
+// Every size writes a key of that size, checks the value the mock SMC has
+// received and reads it back.  Key information and index lookups are
+// checked against the keys added.  Any mismatch or access outside of the
+// registers of the SMC fails the run.
+//
+
+// BENCH_KEY_TYPE
+#define BENCH_KEY_TYPE  SMC_MAKE_KEY ('h', 'e', 'x', '_')
+
+// BENCH_KEY_ATTRIBUTES
+#define BENCH_KEY_ATTRIBUTES  0xD0
+
+// InternalMakeKey
+/// Names the key of a value size, e.g. 'BN06'.
+STATIC
+SMC_KEY
+InternalMakeKey (
+  IN UINTN  Size
+  )
+{
+  return SMC_MAKE_KEY ('B', 'N', ('0' + (Size / 10)), ('0' + (Size % 10)));
+}
+
+// InternalFillPattern
+STATIC
+VOID
+InternalFillPattern (
+  IN  UINTN     Size,
+  IN  UINT8     Seed,
+  OUT SMC_DATA  *Value
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < Size; ++Index) {
+    Value[Index] = (SMC_DATA)(Seed + (Index * 0x11));
+  }
+}
+
+// InternalPrintRow
+/** Prints the accesses since the last reset of the counters and fails the
+    row if any has been unmapped.
+**/
+STATIC
+BOOLEAN
+InternalPrintRow (
+  IN CONST CHAR8  *Operation,
+  IN UINTN        Size,
+  IN BOOLEAN      Valid
+  )
+{
+  MOCK_SMC_MMIO_COUNTERS Counters;
+  UINT64                 Registers;
+
+  MockSmcGetCounters (&Counters);
+
+  Registers = (Counters.Read8 + Counters.Read16 + Counters.Read32
+                 + Counters.Write8 + Counters.Write16 + Counters.Write32);
+
+  Valid = (Valid && (Counters.Unmapped == 0));
+
+  printf (
+    "%-16s %4u %5llu %5llu %5llu %5llu %5llu %5llu %6llu %5llu %5llu  %s\n",
+    Operation,
+    (unsigned)Size,
+    (unsigned long long)Counters.Read8,
+    (unsigned long long)Counters.Read16,
+    (unsigned long long)Counters.Read32,
+    (unsigned long long)Counters.Write8,
+    (unsigned long long)Counters.Write16,
+    (unsigned long long)Counters.Write32,
+    (unsigned long long)Counters.StatusRead,
+    (unsigned long long)Registers,
+    (unsigned long long)(Registers + Counters.StatusRead),
+    (Valid ? "ok" : "MISMATCH")
+    );
+
+  MockSmcResetCounters ();
+
+  return Valid;
+}
+
+// InternalParseList
+/** Parses a comma-separated list of value sizes.
+
+  @returns  The number of sizes parsed, or 0 if any is out of range.
+**/
+STATIC
+UINTN
+InternalParseList (
+  IN  CONST CHAR8  *List,
+  OUT UINTN        *Values,
+  IN  UINTN        MaxValues
+  )
+{
+  UINTN Count;
+  CHAR8 *End;
+
+  Count = 0;
+
+  while ((*List != '\0') && (Count < MaxValues)) {
+    Values[Count] = (UINTN)strtoul (List, &End, 0);
+
+    if ((End == List)
+     || (Values[Count] == 0)
+     || (Values[Count] > SMC_MAX_DATA_SIZE)) {
+      return 0;
+    }
+
+    ++Count;
+
+    List = ((*End == ',') ? (End + 1) : End);
+  }
+
+  return Count;
+}
+
+// InternalUsage
+STATIC
+int
+InternalUsage (
+  IN CONST CHAR8  *Name
+  )
+{
+  fprintf (
+    stderr,
+    "Usage: %s [-s sizes]\n"
+    "\n"
+    "  -s  value sizes in bytes, up to %u   (default 1,2,3,4,6,8,16,32)\n",
+    Name,
+    SMC_MAX_DATA_SIZE
+    );
+
+  return 1;
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  UINTN              Sizes[SMC_MAX_DATA_SIZE] = { 1, 2, 3, 4, 6, 8, 16, 32 };
+  UINTN              NumberOfSizes;
+  SMC_ADDRESS        BaseAddress;
+  SMC_DATA           Expected[SMC_MAX_DATA_SIZE];
+  SMC_DATA           Value[SMC_MAX_DATA_SIZE];
+  SMC_DATA_SIZE      Size;
+  SMC_KEY            Key;
+  SMC_KEY_TYPE       Type;
+  SMC_KEY_ATTRIBUTES Attributes;
+  EFI_STATUS         Status;
+  BOOLEAN            Valid;
+  int                Option;
+  UINTN              Index;
+  int                Result;
+
+  NumberOfSizes = 8;
+
+  while ((Option = getopt (argc, argv, "s:")) != -1) {
+    switch (Option) {
+      case 's':
+        NumberOfSizes = InternalParseList (optarg, Sizes, ARRAY_SIZE (Sizes));
+
+        if (NumberOfSizes == 0) {
+          return InternalUsage (argv[0]);
+        }
+
+        break;
+
+      default:
+        return InternalUsage (argv[0]);
+    }
+  }
+
+  BaseAddress = MockSmcInitialize ();
+
+  for (Index = 0; Index < NumberOfSizes; ++Index) {
+    ZeroMem (Value, sizeof (Value));
+
+    Status = MockSmcAddKey (
+               InternalMakeKey (Sizes[Index]),
+               BENCH_KEY_TYPE,
+               BENCH_KEY_ATTRIBUTES,
+               (SMC_DATA_SIZE)Sizes[Index],
+               Value
+               );
+
+    if (EFI_ERROR (Status)) {
+      fprintf (
+        stderr,
+        "Cannot add a key of %u bytes\n",
+        (unsigned)Sizes[Index]
+        );
+
+      return 1;
+    }
+  }
+
+  printf (
+    "operation        size   rd8  rd16  rd32   wr8  wr16  wr32 status  regs total  check\n"
+    );
+
+  Result = 0;
+
+  MockSmcResetCounters ();
+
+  for (Index = 0; Index < NumberOfSizes; ++Index) {
+    Key = InternalMakeKey (Sizes[Index]);
+
+    InternalFillPattern (Sizes[Index], (UINT8)(0xA0 + Index), Expected);
+
+    Status = SmcWriteValueMmio (
+               BaseAddress,
+               Key,
+               (UINT32)Sizes[Index],
+               Expected
+               );
+
+    Valid = (!EFI_ERROR (Status)
+          && !EFI_ERROR (MockSmcGetValue (Key, &Size, Value))
+          && (Size == Sizes[Index])
+          && (CompareMem (Value, Expected, Size) == 0));
+
+    if (!InternalPrintRow ("WriteValue", Sizes[Index], Valid)) {
+      Result = 1;
+    }
+
+    ZeroMem (Value, sizeof (Value));
+
+    Size   = (SMC_DATA_SIZE)Sizes[Index];
+    Status = SmcReadValueMmio (BaseAddress, Key, &Size, Value);
+
+    Valid = (!EFI_ERROR (Status)
+          && (Size == Sizes[Index])
+          && (CompareMem (Value, Expected, Size) == 0));
+
+    if (!InternalPrintRow ("ReadValue", Sizes[Index], Valid)) {
+      Result = 1;
+    }
+  }
+
+  Status = SmcGetKeyInfoMmio (
+             BaseAddress,
+             InternalMakeKey (Sizes[0]),
+             &Size,
+             &Type,
+             &Attributes
+             );
+
+  Valid = (!EFI_ERROR (Status)
+        && (Size == Sizes[0])
+        && (Attributes == BENCH_KEY_ATTRIBUTES));
+
+  if (!InternalPrintRow ("GetKeyInfo", Sizes[0], Valid)) {
+    Result = 1;
+  }
+
+  //
+  // SmcGetKeyFromIndexMmio() rejects index 0.
+  //
+  if (NumberOfSizes > 1) {
+    Status = SmcGetKeyFromIndexMmio (BaseAddress, 1, &Key);
+
+    Valid = (!EFI_ERROR (Status) && (Key == InternalMakeKey (Sizes[1])));
+
+    if (!InternalPrintRow ("GetKeyFromIndex", 0, Valid)) {
+      Result = 1;
+    }
+  }
+
+  return Result;
+}